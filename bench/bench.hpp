@@ -0,0 +1,55 @@
+// Dirty Little Helper (DLH) - system support library for C/C++
+// Copyright 2021-2023 by Bernhard Heinloth <heinloth@cs.fau.de>
+// SPDX-License-Identifier: AGPL-3.0-or-later
+
+#pragma once
+
+#include <dlh/stream/output.hpp>
+#include <dlh/syscall.hpp>
+#include <dlh/types.hpp>
+
+/*! \brief Measure elapsed (monotonic) time
+ */
+class Stopwatch {
+	uint64_t start;
+
+	static uint64_t now() {
+		struct timespec ts;
+		Syscall::clock_gettime(CLOCK_MONOTONIC, &ts);
+		return static_cast<uint64_t>(ts.tv_sec) * 1000000000UL + static_cast<uint64_t>(ts.tv_nsec);
+	}
+
+ public:
+	Stopwatch() : start(now()) {}
+
+	/*! \brief Restart measurement
+	 */
+	void reset() {
+		start = now();
+	}
+
+	/*! \brief Elapsed time since construction (or reset)
+	 * \return time in nanoseconds
+	 */
+	uint64_t elapsed() const {
+		return now() - start;
+	}
+};
+
+/*! \brief Prevent the compiler from optimizing away a value
+ * \param value value to keep
+ */
+template<typename T>
+static inline void keep(const T & value) {
+	asm volatile("" : : "g"(value) : "memory");
+}
+
+/*! \brief Print time per operation (with two decimal places)
+ * \param ns total time in nanoseconds
+ * \param ops number of operations
+ * \note expects right aligned output (`cout << right`)
+ */
+static void report(uint64_t ns, uint64_t ops) {
+	uint64_t centi = ns * 100 / ops;
+	cout << ": " << setw(8) << (centi / 100) << '.' << setw(2) << setfill('0') << (centi % 100) << setfill(' ') << " ns/op" << endl;
+}
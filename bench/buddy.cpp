@@ -0,0 +1,70 @@
+// Dirty Little Helper (DLH) - system support library for C/C++
+// Copyright 2021-2023 by Bernhard Heinloth <heinloth@cs.fau.de>
+// SPDX-License-Identifier: AGPL-3.0-or-later
+
+#include <dlh/stream/output.hpp>
+#include <dlh/mem.hpp>
+
+#include "../src/alloc_buddy.hpp"
+#include "bench.hpp"
+
+const size_t HEAP_LOG2 = 28;
+const size_t BLOCKS = 256;
+const size_t ROUNDS = 1000;
+
+static uintptr_t reserve(size_t size, uintptr_t & max_ptr) {
+	static uintptr_t base = 0;
+	if (base == 0) {
+		if (auto mmap = Syscall::mmap(0, static_cast<size_t>(2) << HEAP_LOG2, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0))
+			max_ptr = base = mmap.value();
+		else
+			return 0;
+	}
+	uintptr_t ptr = max_ptr;
+	max_ptr += Math::align_up(size, 4096);
+	return ptr;
+}
+
+static Allocator::Buddy<4, HEAP_LOG2, reserve, 14> buddy;
+
+int main(int argc, const char *argv[]) {
+	(void) argc;
+	(void) argv;
+
+	cout << right;
+	const size_t sizes[] = { 16, 100, 1000, 4000, 16000, 100000, 1000000 };
+	static uintptr_t blocks[BLOCKS];
+
+	for (auto size : sizes) {
+		// Free blocks with allocated buddies, hence malloc finds an exact fit and
+		// free does not merge (measuring bucket selection)
+		for (size_t i = 0; i < BLOCKS; i++)
+			blocks[i] = buddy.malloc(size);
+		for (size_t i = 0; i < BLOCKS; i += 2)
+			buddy.free(blocks[i]);
+		Stopwatch watch;
+		for (size_t r = 0; r < ROUNDS * BLOCKS; r++) {
+			uintptr_t ptr = buddy.malloc(size);
+			keep(ptr);
+			buddy.free(ptr);
+		}
+		cout << "malloc/free " << setw(7) << size << " bytes";
+		report(watch.elapsed(), ROUNDS * BLOCKS);
+		for (size_t i = 1; i < BLOCKS; i += 2)
+			buddy.free(blocks[i]);
+
+		// Batch allocations (splitting larger blocks) and frees (merging buddies)
+		size_t rounds = size > 10000 ? ROUNDS / 10 : ROUNDS;
+		watch.reset();
+		for (size_t r = 0; r < rounds; r++) {
+			for (auto & ptr : blocks)
+				ptr = buddy.malloc(size);
+			for (auto ptr : blocks)
+				buddy.free(ptr);
+		}
+		cout << "batch       " << setw(7) << size << " bytes";
+		report(watch.elapsed(), rounds * BLOCKS * 2);
+	}
+
+	return 0;
+}
@@ -0,0 +1,89 @@
+// Dirty Little Helper (DLH) - system support library for C/C++
+// Copyright 2021-2023 by Bernhard Heinloth <heinloth@cs.fau.de>
+// SPDX-License-Identifier: AGPL-3.0-or-later
+
+#include <dlh/stream/output.hpp>
+#include <dlh/container/concurrent_hash.hpp>
+#include <dlh/container/hash.hpp>
+#include <dlh/thread.hpp>
+#include <dlh/mutex.hpp>
+#include <dlh/hash.hpp>
+
+#include "bench.hpp"
+
+const size_t KEYS = 100000;
+const size_t OPS = 1UL << 21;
+const unsigned MAX_THREADS = 64;
+
+// Read-mostly workload: every 32nd operation is an update
+const size_t UPDATE = 32;
+
+static Mutex mutex;
+static HashMap<uint64_t, uint64_t> locked_map;
+static ConcurrentHashMap<uint64_t, uint64_t> concurrent_map;
+
+static void * locked(void * arg) {
+	uint64_t x = reinterpret_cast<uint64_t>(arg);
+	for (size_t i = 0; i < OPS; i++) {
+		x = x * 6364136223846793005ULL + 1442695040888963407ULL;
+		uint64_t key = (x >> 33) % KEYS;
+		Guarded<Mutex> guard(mutex);
+		if (i % UPDATE == 0)
+			locked_map[key] = i;
+		else
+			keep(locked_map.find(key));
+	}
+	return nullptr;
+}
+
+static void * concurrent(void * arg) {
+	uint64_t x = reinterpret_cast<uint64_t>(arg);
+	for (size_t i = 0; i < OPS; i++) {
+		x = x * 6364136223846793005ULL + 1442695040888963407ULL;
+		uint64_t key = (x >> 33) % KEYS;
+		if (i % UPDATE == 0)
+			concurrent_map.insert_or_assign(key, i);
+		else
+			keep(concurrent_map.contains(key));
+	}
+	return nullptr;
+}
+
+/*! \brief Run workload in threads
+ * \param func workload
+ * \param threads number of threads
+ * \return elapsed time in nanoseconds
+ */
+static uint64_t run(void * (*func)(void *), unsigned threads) {
+	Thread * thread[MAX_THREADS];
+	Stopwatch watch;
+	for (unsigned t = 1; t < threads; t++)
+		thread[t] = Thread::create(func, reinterpret_cast<void*>(t));
+	func(reinterpret_cast<void*>(0));
+	for (unsigned t = 1; t < threads; t++)
+		if (thread[t] != nullptr)
+			thread[t]->join();
+	return watch.elapsed();
+}
+
+int main(int argc, const char *argv[]) {
+	(void) argc;
+	(void) argv;
+
+	cout << right;
+
+	for (uint64_t i = 0; i < KEYS; i++) {
+		locked_map.insert(i, i);
+		concurrent_map.insert(i, i);
+	}
+
+	// Total throughput (time per operation of all threads)
+	unsigned processors = Hash::processors();
+	for (unsigned threads = 1; threads <= processors && threads <= MAX_THREADS; threads *= 2) {
+		cout << "Mutex + HashMap      " << setw(2) << threads << " threads";
+		report(run(locked, threads), threads * OPS);
+		cout << "ConcurrentHashMap    " << setw(2) << threads << " threads";
+		report(run(concurrent, threads), threads * OPS);
+	}
+	return 0;
+}
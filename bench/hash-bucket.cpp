@@ -0,0 +1,79 @@
+// Dirty Little Helper (DLH) - system support library for C/C++
+// Copyright 2021-2023 by Bernhard Heinloth <heinloth@cs.fau.de>
+// SPDX-License-Identifier: AGPL-3.0-or-later
+
+#include <dlh/stream/output.hpp>
+#include <dlh/container/hash.hpp>
+#include <dlh/parser/string.hpp>
+#include <dlh/random.hpp>
+#include <dlh/mem.hpp>
+
+#include "bench.hpp"
+
+const size_t OPS = 1UL << 22;
+
+/*! \brief Distinct (pseudo random) key
+ * \param i index
+ * \return key
+ */
+static inline uint64_t key(uint64_t i) {
+	return (i * 0x9E3779B97F4A7C15ULL) ^ 0x5555;
+}
+
+/*! \brief Measure insert, hit and miss lookups using a bucket reduction policy
+ * \param name name of the policy
+ * \param entries number of keys in map
+ * \param lookup keys for lookup (first half hits, second half misses)
+ */
+template<typename R>
+static void measure(const char * name, size_t entries, const uint64_t * lookup) {
+	HashMap<uint64_t, uint64_t, Comparison, 150, R> map;
+	Stopwatch watch;
+	for (size_t i = 0; i < entries; i++)
+		map.insert(key(i), i);
+	cout << name << " insert";
+	report(watch.elapsed(), entries);
+
+	watch.reset();
+	for (size_t i = 0; i < OPS; i++)
+		keep(map.contains(lookup[i]));
+	cout << name << " hit   ";
+	report(watch.elapsed(), OPS);
+
+	watch.reset();
+	for (size_t i = OPS; i < 2 * OPS; i++)
+		keep(map.contains(lookup[i]));
+	cout << name << " miss  ";
+	report(watch.elapsed(), OPS);
+}
+
+int main(int argc, const char *argv[]) {
+	// Maximum number of entries
+	size_t max = 10000000;
+	if (argc > 1)
+		if (auto arg = Parser::string_as<size_t>(argv[1]))
+			max = arg.value();
+
+	cout << right;
+
+	uint64_t * lookup = Memory::alloc<uint64_t>(2 * OPS * sizeof(uint64_t));
+	if (lookup == nullptr)
+		return 1;
+
+	Random random(42);
+	for (size_t entries = 1000; entries <= max && entries <= 100000000; entries *= 10) {
+		for (size_t i = 0; i < OPS; i++) {
+			lookup[i] = key(random.number() % entries);
+			lookup[OPS + i] = key(entries + random.number() % entries);
+		}
+		cout << setw(9) << entries << " entries" << endl;
+
+		measure<HashBucket::Modulo>("  Modulo   ", entries, lookup);
+		measure<HashBucket::Mask>("  Mask     ", entries, lookup);
+		measure<HashBucket::Fibonacci>("  Fibonacci", entries, lookup);
+		measure<HashBucket::FastRange>("  FastRange", entries, lookup);
+	}
+
+	Memory::free(lookup);
+	return 0;
+}
@@ -0,0 +1,57 @@
+// Dirty Little Helper (DLH) - system support library for C/C++
+// Copyright 2021-2023 by Bernhard Heinloth <heinloth@cs.fau.de>
+// SPDX-License-Identifier: AGPL-3.0-or-later
+
+#include <dlh/stream/output.hpp>
+#include <dlh/container/hash.hpp>
+#include <dlh/parser/string.hpp>
+
+#include "bench.hpp"
+
+/*! \brief Distinct (pseudo random) key
+ * \param i index
+ * \return key
+ */
+static inline uint64_t key(uint64_t i) {
+	return (i * 0x9E3779B97F4A7C15ULL) ^ 0x5555;
+}
+
+/*! \brief Insert keys and measure the latency of each insert
+ * \param name name of the mode
+ * \param incremental use incremental mode
+ * \param entries number of keys to insert
+ */
+static void measure(const char * name, bool incremental, size_t entries) {
+	HashMap<uint64_t, uint64_t> map;
+	map.incremental(incremental);
+
+	uint64_t max = 0;
+	uint64_t total = 0;
+	size_t slow = 0;
+	for (size_t i = 0; i < entries; i++) {
+		Stopwatch watch;
+		map.insert(key(i), i);
+		uint64_t ns = watch.elapsed();
+		total += ns;
+		if (ns > max)
+			max = ns;
+		if (ns >= 1000000)
+			slow++;
+	}
+	cout << name << " insert";
+	report(total, entries);
+	cout << name << " max   : " << setw(8) << (max / 1000) << " us (" << slow << " inserts >= 1 ms)" << endl;
+}
+
+int main(int argc, const char *argv[]) {
+	// Number of entries (100M require several GiB of memory)
+	size_t entries = 10000000;
+	if (argc > 1)
+		if (auto arg = Parser::string_as<size_t>(argv[1]))
+			entries = arg.value();
+
+	cout << right << setw(9) << entries << " entries" << endl;
+	measure("  default    ", false, entries);
+	measure("  incremental", true, entries);
+	return 0;
+}
@@ -0,0 +1,55 @@
+// Dirty Little Helper (DLH) - system support library for C/C++
+// Copyright 2021-2023 by Bernhard Heinloth <heinloth@cs.fau.de>
+// SPDX-License-Identifier: AGPL-3.0-or-later
+
+#include <dlh/stream/output.hpp>
+#include <dlh/xxhash.hpp>
+#include <dlh/hash.hpp>
+#include <dlh/mem.hpp>
+
+#include "bench.hpp"
+
+const size_t SIZE = 1UL << 30;
+const size_t REPEAT = 4;
+
+int main(int argc, const char *argv[]) {
+	(void) argc;
+	(void) argv;
+
+	cout << right;
+
+	char * data = Memory::alloc<char>(SIZE);
+	if (data == nullptr)
+		return 1;
+	for (size_t i = 0; i < SIZE; i++)
+		data[i] = static_cast<char>(i * 7 + i / 4096);
+
+	Stopwatch watch;
+	for (size_t i = 0; i < REPEAT; i++) {
+		XXHash64 h(0);
+		h.add(data, SIZE);
+		keep(h.hash());
+	}
+	uint64_t ns = watch.elapsed();
+	cout << "XXHash64                  " << setw(6) << (SIZE * REPEAT * 1000 / ns) << " MB/s";
+	report(ns, REPEAT);
+
+	watch.reset();
+	for (size_t i = 0; i < REPEAT; i++)
+		keep(XXHash3::hash128(data, SIZE));
+	ns = watch.elapsed();
+	cout << "XXHash3                   " << setw(6) << (SIZE * REPEAT * 1000 / ns) << " MB/s";
+	report(ns, REPEAT);
+
+	for (unsigned threads = 1; threads <= Hash::processors(); threads *= 2) {
+		watch.reset();
+		for (size_t i = 0; i < REPEAT; i++)
+			keep(Hash::parallel(data, SIZE, threads));
+		ns = watch.elapsed();
+		cout << "Hash::parallel " << setw(2) << threads << " threads " << setw(6) << (SIZE * REPEAT * 1000 / ns) << " MB/s";
+		report(ns, REPEAT);
+	}
+
+	Memory::free(data);
+	return 0;
+}
@@ -0,0 +1,104 @@
+// Dirty Little Helper (DLH) - system support library for C/C++
+// Copyright 2021-2023 by Bernhard Heinloth <heinloth@cs.fau.de>
+// SPDX-License-Identifier: AGPL-3.0-or-later
+
+#include <dlh/stream/output.hpp>
+#include <dlh/stream/buffer.hpp>
+#include <dlh/container/hash.hpp>
+#include <dlh/parser/string.hpp>
+#include <dlh/random.hpp>
+#include <dlh/string.hpp>
+#include <dlh/mem.hpp>
+
+#include "bench.hpp"
+
+const size_t OPS = 1UL << 22;
+
+/*! \brief Batch lookup with precomputed hash values and prefetching
+ * \param map map to look up
+ * \param lookup keys
+ * \param hash hash values of keys
+ * \param ahead distance of prefetched bucket (or `0` to disable)
+ */
+template<typename M, typename K>
+static void batch(const M & map, const K * lookup, const uint32_t * hash, size_t ahead) {
+	Stopwatch watch;
+	for (size_t i = 0; i < OPS; i++) {
+		if (ahead > 0 && i + ahead < OPS)
+			map.prefetch(hash[i + ahead]);
+		keep(map.contains_hashed(lookup[i], hash[i]));
+	}
+	cout << "  precomputed hash, prefetch " << setw(2) << ahead;
+	report(watch.elapsed(), OPS);
+}
+
+int main(int argc, const char *argv[]) {
+	// Number of entries
+	size_t entries = 10000000;
+	if (argc > 1)
+		if (auto arg = Parser::string_as<size_t>(argv[1]))
+			entries = arg.value();
+
+	cout << right;
+
+	uint64_t * lookup = Memory::alloc<uint64_t>(OPS * sizeof(uint64_t));
+	uint32_t * hash = Memory::alloc<uint32_t>(OPS * sizeof(uint32_t));
+	char * strings = Memory::alloc<char>(OPS * 24);
+	const char ** string_lookup = Memory::alloc<const char *>(OPS * sizeof(const char *));
+	if (lookup == nullptr || hash == nullptr || strings == nullptr || string_lookup == nullptr)
+		return 1;
+
+	Random random(42);
+	{
+		cout << setw(9) << entries << " integer keys" << endl;
+		HashMap<uint64_t, uint64_t> map;
+		for (size_t i = 0; i < entries; i++)
+			map.insert(i * 0x9E3779B97F4A7C15ULL, i);
+		for (size_t i = 0; i < OPS; i++) {
+			lookup[i] = (random.number() % (2 * entries)) * 0x9E3779B97F4A7C15ULL;
+			hash[i] = Comparison::hash(lookup[i]);
+		}
+
+		Stopwatch watch;
+		for (size_t i = 0; i < OPS; i++)
+			keep(map.contains(lookup[i]));
+		cout << "  contains                      ";
+		report(watch.elapsed(), OPS);
+		for (size_t ahead : { 0, 4, 8, 16 })
+			batch(map, lookup, hash, ahead);
+	}
+
+	{
+		cout << setw(9) << entries << " string keys" << endl;
+		HashMap<const char *, uint64_t> map;
+		char * keys = Memory::alloc<char>(entries * 24);
+		if (keys == nullptr)
+			return 1;
+		for (size_t i = 0; i < entries; i++) {
+			char * key = keys + i * 24;
+			(BufferStream(key, 24) << "key-" << i).str();
+			map.insert(key, i);
+		}
+		for (size_t i = 0; i < OPS; i++) {
+			char * key = strings + i * 24;
+			(BufferStream(key, 24) << "key-" << (random.number() % (2 * entries))).str();
+			string_lookup[i] = key;
+			hash[i] = Comparison::hash(key);
+		}
+
+		Stopwatch watch;
+		for (size_t i = 0; i < OPS; i++)
+			keep(map.contains(string_lookup[i]));
+		cout << "  contains                      ";
+		report(watch.elapsed(), OPS);
+		for (size_t ahead : { 0, 4, 8, 16 })
+			batch(map, string_lookup, hash, ahead);
+		Memory::free(keys);
+	}
+
+	Memory::free(lookup);
+	Memory::free(hash);
+	Memory::free(strings);
+	Memory::free(string_lookup);
+	return 0;
+}
@@ -0,0 +1,62 @@
+// Dirty Little Helper (DLH) - system support library for C/C++
+// Copyright 2021-2023 by Bernhard Heinloth <heinloth@cs.fau.de>
+// SPDX-License-Identifier: AGPL-3.0-or-later
+
+#include <dlh/stream/output.hpp>
+#include <dlh/string.hpp>
+#include <dlh/mem.hpp>
+
+#include "bench.hpp"
+
+// Previous (djb2) implementation for comparison
+__attribute__((noinline))
+static uint32_t djb2(const char * s) {
+	uint_fast32_t h = 5381;
+	for (unsigned char c = *s; c != '\0'; c = *++s)
+		h = h * 33 + c;
+	return h & 0xffffffff;
+}
+
+const size_t VOLUME = 1UL << 28;
+
+int main(int argc, const char *argv[]) {
+	(void) argc;
+	(void) argv;
+
+	cout << right;
+
+	const size_t sizes[] = { 3, 8, 16, 32, 64, 256, 4096 };
+	char * s = Memory::alloc<char>(4096 + 1);
+	if (s == nullptr)
+		return 1;
+	for (size_t i = 0; i < 4096; i++)
+		s[i] = static_cast<char>('a' + i % 26);
+
+	for (auto size : sizes) {
+		s[size] = '\0';
+		size_t ops = VOLUME / (size + 16);
+
+		Stopwatch watch;
+		for (size_t i = 0; i < ops; i++)
+			keep(djb2(s));
+		cout << "djb2          " << setw(6) << size << " bytes";
+		report(watch.elapsed(), ops);
+
+		watch.reset();
+		for (size_t i = 0; i < ops; i++)
+			keep(String::hash(s));
+		cout << "hash          " << setw(6) << size << " bytes";
+		report(watch.elapsed(), ops);
+
+		watch.reset();
+		for (size_t i = 0; i < ops; i++)
+			keep(String::hash(s, size));
+		cout << "hash (length) " << setw(6) << size << " bytes";
+		report(watch.elapsed(), ops);
+
+		s[size] = static_cast<char>('a' + size % 26);
+	}
+
+	Memory::free(s);
+	return 0;
+}
@@ -0,0 +1,139 @@
+// Dirty Little Helper (DLH) - system support library for C/C++
+// Copyright 2021-2023 by Bernhard Heinloth <heinloth@cs.fau.de>
+// SPDX-License-Identifier: AGPL-3.0-or-later
+
+#include <dlh/stream/output.hpp>
+#include <dlh/mem.hpp>
+
+#include "bench.hpp"
+
+// Previous (inline) implementation for comparison
+// (without replacing the loops by calls to the library functions)
+__attribute__((noinline, optimize("no-tree-loop-distribute-patterns")))
+static void byte_copy(uintptr_t dest, uintptr_t src, size_t size) {
+	unsigned char * __restrict__ destination = reinterpret_cast<unsigned char*>(dest);
+	unsigned char const * __restrict__ source = reinterpret_cast<unsigned char const*>(src);
+	for (size_t i = 0; i != size; ++i)
+		destination[i] = source[i];
+}
+
+__attribute__((noinline, optimize("no-tree-loop-distribute-patterns")))
+static void byte_set(uintptr_t dest, int pattern, size_t size) {
+	unsigned char * destination = reinterpret_cast<unsigned char*>(dest);
+	for (size_t i = 0; i != size; ++i)
+		destination[i] = static_cast<unsigned char>(pattern);
+}
+
+__attribute__((noinline, optimize("no-tree-loop-distribute-patterns")))
+static int byte_compare(uintptr_t s1, uintptr_t s2, size_t n) {
+	const unsigned char * c1 = reinterpret_cast<const unsigned char*>(s1);
+	const unsigned char * c2 = reinterpret_cast<const unsigned char*>(s2);
+	for (size_t i = 0; i != n; ++i)
+		if (c1[i] != c2[i])
+			return static_cast<int>(c1[i]) - static_cast<int>(c2[i]);
+	return 0;
+}
+
+const size_t VOLUME = 1UL << 30;
+const size_t MAX_SIZE = 64UL << 20;
+
+int main(int argc, const char *argv[]) {
+	(void) argc;
+	(void) argv;
+
+	cout << right;
+	cout << "stream threshold: " << Memory::stream_threshold() << " bytes" << endl;
+	uintptr_t src = Memory::alloc(MAX_SIZE + 64);
+	uintptr_t dest = Memory::alloc(MAX_SIZE + 64);
+	if (src == 0 || dest == 0)
+		return 1;
+	Memory::set(src, 'x', MAX_SIZE + 64);
+	Memory::set(dest, 'x', MAX_SIZE + 64);
+
+	const size_t sizes[] = { 8, 31, 64, 100, 256, 1000, 4096, 65536, 1UL << 20, MAX_SIZE };
+	for (auto size : sizes) {
+		// Same amount of bytes for each size (but at least a few calls)
+		size_t ops = VOLUME / size > 16 ? VOLUME / size : 16;
+		if (ops > 10000000)
+			ops = 10000000;
+		size_t byte_ops = size > 4096 ? ops / 8 : ops;
+
+		Stopwatch watch;
+		for (size_t i = 0; i < byte_ops; i++) {
+			byte_copy(dest + 1, src, size);
+			keep(dest);
+		}
+		cout << "byte copy  " << setw(9) << size << " bytes";
+		report(watch.elapsed(), byte_ops);
+
+		watch.reset();
+		for (size_t i = 0; i < ops; i++) {
+			Memory::copy(dest + 1, src, size);
+			keep(dest);
+		}
+		cout << "copy       " << setw(9) << size << " bytes";
+		report(watch.elapsed(), ops);
+
+		if (size >= 65536) {
+			watch.reset();
+			for (size_t i = 0; i < ops; i++) {
+				Memory::stream_copy(dest + 1, src, size);
+				keep(dest);
+			}
+			cout << "stream copy" << setw(9) << size << " bytes";
+			report(watch.elapsed(), ops);
+		}
+
+		watch.reset();
+		for (size_t i = 0; i < ops; i++) {
+			Memory::move(src + 3, src, size);
+			keep(src);
+		}
+		cout << "move       " << setw(9) << size << " bytes";
+		report(watch.elapsed(), ops);
+
+		watch.reset();
+		for (size_t i = 0; i < byte_ops; i++) {
+			byte_set(dest, 'x', size);
+			keep(dest);
+		}
+		cout << "byte set   " << setw(9) << size << " bytes";
+		report(watch.elapsed(), byte_ops);
+
+		watch.reset();
+		for (size_t i = 0; i < ops; i++) {
+			Memory::set(dest, 'x', size);
+			keep(dest);
+		}
+		cout << "set        " << setw(9) << size << " bytes";
+		report(watch.elapsed(), ops);
+
+		if (size >= 65536) {
+			watch.reset();
+			for (size_t i = 0; i < ops; i++) {
+				Memory::stream_set(dest, 'x', size);
+				keep(dest);
+			}
+			cout << "stream set " << setw(9) << size << " bytes";
+			report(watch.elapsed(), ops);
+		}
+
+		// Source and destination contain identical bytes now
+		Memory::set(src, 'x', size + 8);
+		watch.reset();
+		for (size_t i = 0; i < byte_ops; i++)
+			keep(byte_compare(dest, src, size));
+		cout << "byte cmp   " << setw(9) << size << " bytes";
+		report(watch.elapsed(), byte_ops);
+
+		watch.reset();
+		for (size_t i = 0; i < ops; i++)
+			keep(Memory::compare(dest, src, size));
+		cout << "compare    " << setw(9) << size << " bytes";
+		report(watch.elapsed(), ops);
+	}
+
+	Memory::free(src);
+	Memory::free(dest);
+	return 0;
+}
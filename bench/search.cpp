@@ -0,0 +1,98 @@
+// Dirty Little Helper (DLH) - system support library for C/C++
+// Copyright 2021-2023 by Bernhard Heinloth <heinloth@cs.fau.de>
+// SPDX-License-Identifier: AGPL-3.0-or-later
+
+#include <dlh/stream/output.hpp>
+#include <dlh/string.hpp>
+#include <dlh/mem.hpp>
+
+#include "bench.hpp"
+
+// Previous (Knuth-Morris-Pratt) implementation for comparison
+__attribute__((noinline))
+static const char * kmp_find(const char *haystack, const char* needle) {
+	size_t needle_len = String::len(needle);
+	size_t haystack_len = String::len(haystack);
+	if (haystack_len < needle_len)
+		return nullptr;
+
+	size_t n[needle_len + 1];
+	for (size_t i = 0; i <= needle_len; i++)
+		n[i] = 0;
+	for (size_t j = 0, i = 1; i < needle_len; i++)  {
+		for (j = n[i + 1]; j > 0 && needle[j] != needle[i]; j = n[j]) {}
+		if (j > 0 || needle[j] == needle[i])
+			n[i + 1] = j + 1;
+	}
+
+	for (size_t i = 0, j = 0; i < haystack_len; i++) {
+		if (haystack[i] == needle[j]) {
+			if (++j == needle_len)
+				return haystack + i - j + 1;
+		} else if (j > 0) {
+			j = n[j];
+			i--;
+		}
+	}
+	return nullptr;
+}
+
+const size_t VOLUME = 1UL << 28;
+
+int main(int argc, const char *argv[]) {
+	(void) argc;
+	(void) argv;
+
+	cout << right;
+
+	const size_t sizes[] = { 64, 1000, 65536 };
+	const size_t needles[] = { 4, 16, 64, 256 };
+	char * haystack = Memory::alloc<char>(65536 + 1);
+	char * needle = Memory::alloc<char>(256 + 1);
+	if (haystack == nullptr || needle == nullptr)
+		return 1;
+
+	// Text with frequent partial matches of the needle
+	for (size_t i = 0; i < 65536; i++)
+		haystack[i] = "abcdefgh"[(i * 7 + i / 13) % 8];
+
+	for (auto size : sizes)
+		for (auto needle_len : needles) {
+			if (needle_len > size)
+				continue;
+			// Needle only at the very end
+			char * h = haystack + 65536 - size;
+			Memory::copy(needle, h + size - needle_len, needle_len);
+			needle[needle_len] = '\0';
+			haystack[65536] = '\0';
+			char last = h[size - 1];
+			h[size - 1] = 'x';
+			needle[needle_len - 1] = 'x';
+			size_t ops = VOLUME / (size + 64);
+
+			Stopwatch watch;
+			for (size_t i = 0; i < ops; i++)
+				keep(kmp_find(h, needle));
+			cout << "kmp find      " << setw(6) << size << " bytes, needle " << setw(3) << needle_len;
+			report(watch.elapsed(), ops);
+
+			watch.reset();
+			for (size_t i = 0; i < ops; i++)
+				keep(String::find(h, needle));
+			cout << "find          " << setw(6) << size << " bytes, needle " << setw(3) << needle_len;
+			report(watch.elapsed(), ops);
+
+			String::Searcher searcher(needle);
+			watch.reset();
+			for (size_t i = 0; i < ops; i++)
+				keep(searcher.find(h, size));
+			cout << "searcher find " << setw(6) << size << " bytes, needle " << setw(3) << needle_len;
+			report(watch.elapsed(), ops);
+
+			h[size - 1] = last;
+		}
+
+	Memory::free(haystack);
+	Memory::free(needle);
+	return 0;
+}
@@ -0,0 +1,125 @@
+// Dirty Little Helper (DLH) - system support library for C/C++
+// Copyright 2021-2023 by Bernhard Heinloth <heinloth@cs.fau.de>
+// SPDX-License-Identifier: AGPL-3.0-or-later
+
+#include <dlh/stream/output.hpp>
+#include <dlh/string.hpp>
+#include <dlh/mem.hpp>
+
+#include "bench.hpp"
+
+// Previous (bytewise) implementation for comparison
+__attribute__((noinline))
+static size_t byte_len(const char *s) {
+	size_t len = 0;
+	while (*s++ != '\0')
+		len++;
+	return len;
+}
+
+__attribute__((noinline))
+static const char * byte_find(const char *s, int c) {
+	while (*s != '\0') {
+		if (*s == c)
+			return s;
+		s++;
+	}
+	return nullptr;
+}
+
+__attribute__((noinline))
+static const char * byte_find_last(const char *s, int c) {
+	const char * last = nullptr;
+	while (*s != '\0') {
+		if (*s == c)
+			last = s;
+		s++;
+	}
+	return last;
+}
+
+__attribute__((noinline))
+static int byte_compare(const char *s1, const char *s2) {
+	while (*s1 == *s2++)
+		if (*s1++ == '\0')
+			return 0;
+	return static_cast<int>(*s1) - static_cast<int>(*(s2 - 1));
+}
+
+const size_t VOLUME = 1UL << 28;
+
+int main(int argc, const char *argv[]) {
+	(void) argc;
+	(void) argv;
+
+	cout << right;
+
+	const size_t sizes[] = { 7, 16, 31, 64, 100, 256, 1000, 4096, 65536 };
+	const size_t max = 65536;
+	char * a = Memory::alloc<char>(max + 64);
+	char * b = Memory::alloc<char>(max + 64);
+	if (a == nullptr || b == nullptr)
+		return 1;
+
+	for (auto size : sizes) {
+		// Misaligned strings without the searched character
+		char * s = a + 3;
+		char * t = b + 9;
+		Memory::set(s, 'a', size);
+		Memory::set(t, 'a', size);
+		s[size] = t[size] = '\0';
+		size_t ops = VOLUME / (size + 16);
+
+		Stopwatch watch;
+		for (size_t i = 0; i < ops; i++)
+			keep(byte_len(s));
+		cout << "byte len       " << setw(6) << size << " bytes";
+		report(watch.elapsed(), ops);
+
+		watch.reset();
+		for (size_t i = 0; i < ops; i++)
+			keep(String::len(s));
+		cout << "len            " << setw(6) << size << " bytes";
+		report(watch.elapsed(), ops);
+
+		watch.reset();
+		for (size_t i = 0; i < ops; i++)
+			keep(byte_find(s, 'x'));
+		cout << "byte find      " << setw(6) << size << " bytes";
+		report(watch.elapsed(), ops);
+
+		watch.reset();
+		for (size_t i = 0; i < ops; i++)
+			keep(String::find(s, 'x'));
+		cout << "find           " << setw(6) << size << " bytes";
+		report(watch.elapsed(), ops);
+
+		watch.reset();
+		for (size_t i = 0; i < ops; i++)
+			keep(byte_find_last(s, 'x'));
+		cout << "byte find_last " << setw(6) << size << " bytes";
+		report(watch.elapsed(), ops);
+
+		watch.reset();
+		for (size_t i = 0; i < ops; i++)
+			keep(String::find_last(s, 'x'));
+		cout << "find_last      " << setw(6) << size << " bytes";
+		report(watch.elapsed(), ops);
+
+		watch.reset();
+		for (size_t i = 0; i < ops; i++)
+			keep(byte_compare(s, t));
+		cout << "byte compare   " << setw(6) << size << " bytes";
+		report(watch.elapsed(), ops);
+
+		watch.reset();
+		for (size_t i = 0; i < ops; i++)
+			keep(String::compare(s, t));
+		cout << "compare        " << setw(6) << size << " bytes";
+		report(watch.elapsed(), ops);
+	}
+
+	Memory::free(a);
+	Memory::free(b);
+	return 0;
+}
@@ -0,0 +1,80 @@
+// Dirty Little Helper (DLH) - system support library for C/C++
+// Copyright 2021-2023 by Bernhard Heinloth <heinloth@cs.fau.de>
+// SPDX-License-Identifier: AGPL-3.0-or-later
+
+#include <dlh/stream/output.hpp>
+#include <dlh/container/hash.hpp>
+#include <dlh/strpool.hpp>
+#include <dlh/strptr.hpp>
+#include <dlh/string.hpp>
+
+#include "bench.hpp"
+
+const size_t KEYS = 10000;
+const size_t OPS = 10000000;
+
+int main(int argc, const char *argv[]) {
+	(void) argc;
+	(void) argv;
+
+	cout << right;
+
+	// Keys with a long common prefix
+	StringPool pool;
+	StrPtr * strptrs = Memory::alloc<StrPtr>(KEYS * sizeof(StrPtr));
+	Atom * atoms = Memory::alloc<Atom>(KEYS * sizeof(Atom));
+	HashMap<StrPtr, size_t> strptr_map;
+	HashMap<Atom, size_t> atom_map;
+	char buffer[128];
+	for (size_t i = 0; i < KEYS; i++) {
+		(BufferStream(buffer, sizeof(buffer)) << "application.module.section.subsection.option_" << i).str();
+		strptrs[i] = StrPtr(String::duplicate(buffer));
+		atoms[i] = pool.intern(buffer);
+		strptr_map.insert(strptrs[i], i);
+		atom_map.insert(atoms[i], i);
+	}
+
+	// Copies of the keys (equal, but at different addresses)
+	StrPtr * lookup = Memory::alloc<StrPtr>(KEYS * sizeof(StrPtr));
+	for (size_t i = 0; i < KEYS; i++)
+		lookup[i] = StrPtr(String::duplicate(strptrs[i].str));
+
+	Stopwatch watch;
+	for (size_t i = 0; i < OPS; i++)
+		keep(lookup[i % KEYS] == strptrs[(i * 7) % KEYS] || lookup[i % KEYS] == strptrs[i % KEYS]);
+	cout << "StrPtr equality      ";
+	report(watch.elapsed(), OPS);
+
+	watch.reset();
+	for (size_t i = 0; i < OPS; i++)
+		keep(atoms[i % KEYS] == atoms[(i * 7) % KEYS] || atoms[i % KEYS] == atoms[i % KEYS]);
+	cout << "Atom equality        ";
+	report(watch.elapsed(), OPS);
+
+	watch.reset();
+	for (size_t i = 0; i < OPS; i++)
+		keep(strptr_map.find(lookup[(i * 7) % KEYS]));
+	cout << "HashMap<StrPtr> find ";
+	report(watch.elapsed(), OPS);
+
+	watch.reset();
+	for (size_t i = 0; i < OPS; i++)
+		keep(atom_map.find(atoms[(i * 7) % KEYS]));
+	cout << "HashMap<Atom> find   ";
+	report(watch.elapsed(), OPS);
+
+	watch.reset();
+	for (size_t i = 0; i < OPS; i++)
+		keep(pool.intern(lookup[(i * 7) % KEYS]));
+	cout << "StringPool intern    ";
+	report(watch.elapsed(), OPS);
+
+	for (size_t i = 0; i < KEYS; i++) {
+		Memory::free(const_cast<char *>(strptrs[i].str));
+		Memory::free(const_cast<char *>(lookup[i].str));
+	}
+	Memory::free(strptrs);
+	Memory::free(lookup);
+	Memory::free(atoms);
+	return 0;
+}
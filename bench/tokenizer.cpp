@@ -0,0 +1,69 @@
+// Dirty Little Helper (DLH) - system support library for C/C++
+// Copyright 2021-2023 by Bernhard Heinloth <heinloth@cs.fau.de>
+// SPDX-License-Identifier: AGPL-3.0-or-later
+
+#include <dlh/stream/output.hpp>
+#include <dlh/container/initializer_list.hpp>
+#include <dlh/string.hpp>
+#include <dlh/random.hpp>
+#include <dlh/mem.hpp>
+
+#include "bench.hpp"
+
+const size_t SIZE = 100UL << 20;
+
+int main(int argc, const char *argv[]) {
+	(void) argc;
+	(void) argv;
+
+	cout << right;
+
+	// Text with lines of 1 to 120 bytes, words separated by spaces and commas
+	char * text = Memory::alloc<char>(SIZE + 1);
+	char * copy = Memory::alloc<char>(SIZE + 1);
+	if (text == nullptr || copy == nullptr)
+		return 1;
+	Random random(42);
+	for (size_t i = 0; i < SIZE; ) {
+		size_t line = 1 + random.number() % 120;
+		for (size_t j = 0; j < line && i < SIZE; j++)
+			text[i++] = j + 1 == line ? '\n' : "abcdefghijklmnopqrstuvwxyz ,"[random.number() % 28];
+	}
+	text[SIZE] = '\0';
+
+	for (const char * delimiters : { "\n", " ,\n" }) {
+		bool single = delimiters[1] == '\0';
+		size_t tokens = 0;
+		Stopwatch watch;
+		for (const auto & t : String::Tokenizer(text, SIZE, delimiters)) {
+			keep(t.str);
+			tokens++;
+		}
+		uint64_t tokenizer = watch.elapsed();
+
+		Memory::copy(copy, text, SIZE + 1);
+		watch.reset();
+		auto parts = single ? String::split_inplace(copy, '\n') : String::split_any_inplace(copy, delimiters);
+		keep(parts.size());
+		uint64_t inplace = watch.elapsed();
+
+		watch.reset();
+		auto dups = single ? String::split(text, '\n') : String::split_any(text, delimiters);
+		keep(dups.size());
+		uint64_t dup = watch.elapsed();
+		for (auto p : dups)
+			Memory::free(const_cast<char *>(p));
+
+		cout << (single ? "lines, " : "words, ") << tokens << " tokens (" << (SIZE >> 20) << " MiB)" << endl;
+		cout << "  split          ";
+		report(dup, tokens);
+		cout << "  split_inplace  ";
+		report(inplace, tokens);
+		cout << "  tokenizer      ";
+		report(tokenizer, tokens);
+	}
+
+	Memory::free(text);
+	Memory::free(copy);
+	return 0;
+}
@@ -0,0 +1,64 @@
+// Dirty Little Helper (DLH) - system support library for C/C++
+// Copyright 2021-2023 by Bernhard Heinloth <heinloth@cs.fau.de>
+// SPDX-License-Identifier: AGPL-3.0-or-later
+
+#include <dlh/stream/output.hpp>
+#include <dlh/xxhash.hpp>
+#include <dlh/random.hpp>
+#include <dlh/mem.hpp>
+
+#include "bench.hpp"
+
+const size_t VOLUME = 1UL << 30;
+
+int main(int argc, const char *argv[]) {
+	(void) argc;
+	(void) argv;
+
+	cout << right;
+
+	const size_t sizes[] = { 8, 16, 64, 240, 1024, 65536, 4UL << 20 };
+	char * data = Memory::alloc<char>(4UL << 20);
+	if (data == nullptr)
+		return 1;
+	Random random(42);
+	for (size_t i = 0; i < (4UL << 20); i++)
+		data[i] = static_cast<char>(random.number());
+
+	for (auto size : sizes) {
+		size_t ops = VOLUME / (size + 64);
+
+		Stopwatch watch;
+		for (size_t i = 0; i < ops; i++) {
+			XXHash64 h(i);
+			h.add(data, size);
+			keep(h.hash());
+		}
+		cout << "XXHash64         " << setw(8) << size << " bytes";
+		report(watch.elapsed(), ops);
+
+		watch.reset();
+		for (size_t i = 0; i < ops; i++)
+			keep(XXHash3::hash(data, size, i));
+		cout << "XXHash3          " << setw(8) << size << " bytes";
+		report(watch.elapsed(), ops);
+
+		watch.reset();
+		for (size_t i = 0; i < ops; i++)
+			keep(XXHash3::hash128(data, size, i));
+		cout << "XXHash3 128 bit  " << setw(8) << size << " bytes";
+		report(watch.elapsed(), ops);
+
+		watch.reset();
+		for (size_t i = 0; i < ops; i++) {
+			XXHash3 h(i);
+			h.add(data, size);
+			keep(h.hash());
+		}
+		cout << "XXHash3 stream   " << setw(8) << size << " bytes";
+		report(watch.elapsed(), ops);
+	}
+
+	Memory::free(data);
+	return 0;
+}
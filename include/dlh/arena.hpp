@@ -0,0 +1,208 @@
+// Dirty Little Helper (DLH) - system support library for C/C++
+// Copyright 2021-2023 by Bernhard Heinloth <heinloth@cs.fau.de>
+// SPDX-License-Identifier: AGPL-3.0-or-later
+
+/*! \file
+ *  \brief \ref Memory::Arena "Arena" (bump pointer) allocator
+ */
+
+#pragma once
+
+#include <dlh/mem.hpp>
+#include <dlh/math.hpp>
+#include <dlh/types.hpp>
+
+namespace Memory {
+
+/*! \brief Arena allocator for short-lived objects
+ *
+ * Memory is handed out by bumping a pointer in large chunks (allocated on the
+ * heap), individual allocations are not freed but released all at once using
+ * \ref reset or by rolling back to a \ref Marker (e.g., using a \ref Scope).
+ * Chunks are kept for reuse until the arena is destroyed.
+ *
+ * Containers (`Vector`, `HashSet`, `HashMap`, `TreeSet`, `TreeMap`) and the
+ * allocating `String` helpers can use an arena instead of the heap.
+ *
+ * \note Destructors of objects in the arena are not called on reset.
+ * \note Not thread safe
+ */
+class Arena {
+	/*! \brief Chunk header (data follows right after it) */
+	struct Chunk {
+		/*! \brief Next chunk */
+		Chunk * next;
+
+		/*! \brief Size of the chunk (including header) */
+		size_t size;
+
+		/*! \brief Start of usable memory */
+		uintptr_t begin() const {
+			return reinterpret_cast<uintptr_t>(this + 1);
+		}
+
+		/*! \brief End of usable memory */
+		uintptr_t end() const {
+			return reinterpret_cast<uintptr_t>(this) + size;
+		}
+	};
+	static_assert(sizeof(Chunk) % 16 == 0, "Chunk header breaks alignment");
+
+	/*! \brief First chunk */
+	Chunk * _first = nullptr;
+
+	/*! \brief Chunk used for allocations */
+	Chunk * _current = nullptr;
+
+	/*! \brief Next free address in current chunk */
+	uintptr_t _top = 0;
+
+	/*! \brief Address of the most recent allocation (can be resized or freed) */
+	uintptr_t _last = 0;
+
+	/*! \brief Default size of new chunks */
+	size_t _chunk_size;
+
+	/*! \brief Continue allocation in the next (or a new) chunk
+	 * \param size requested size
+	 * \param alignment requested alignment
+	 * \return address of the allocated memory or `0` on failure
+	 */
+	uintptr_t grow(size_t size, size_t alignment);
+
+ public:
+	/*! \brief Default chunk size
+	 * (fits in a 64 KiB heap block including allocator meta data)
+	 */
+	static const size_t CHUNK_SIZE = 64 * 1024 - 64;
+
+	/*! \brief Position in arena */
+	struct Marker {
+		Chunk * chunk;
+		uintptr_t top;
+	};
+
+	/*! \brief Roll back arena to its state at construction when leaving scope
+	 */
+	class Scope {
+		Arena & arena;
+		Marker marker;
+
+	 public:
+		/*! \brief Mark the current position in arena
+		 * \param arena arena to roll back at end of scope
+		 */
+		explicit Scope(Arena & arena) : arena(arena), marker(arena.mark()) {}
+
+		Scope(const Scope &) = delete;
+		Scope & operator=(const Scope &) = delete;
+
+		/*! \brief Roll back to the marked position
+		 */
+		~Scope() {
+			arena.rollback(marker);
+		}
+	};
+
+	/*! \brief Create arena
+	 * \param chunk_size size of chunks allocated on the heap
+	 */
+	explicit Arena(size_t chunk_size = CHUNK_SIZE) : _chunk_size(chunk_size) {}
+
+	Arena(const Arena &) = delete;
+	Arena & operator=(const Arena &) = delete;
+
+	/*! \brief Destroy arena (releasing all chunks)
+	 */
+	~Arena();
+
+	/*! \brief Allocate memory
+	 * \param size requested size (in bytes)
+	 * \param alignment alignment of the memory (power of two)
+	 * \return address of the allocated memory or `0` if size was zero or on failure
+	 */
+	uintptr_t alloc(size_t size, size_t alignment = 16) {
+		if (size == 0)
+			return 0;
+		uintptr_t ptr = Math::align_up(_top, alignment);
+		if (_current != nullptr && ptr >= _top && ptr <= _current->end() && size <= _current->end() - ptr) {
+			_top = ptr + size;
+			return _last = ptr;
+		}
+		return grow(size, alignment);
+	}
+
+	template<typename T>
+	inline T* alloc(size_t size, size_t alignment = 16) {
+		return reinterpret_cast<T*>(alloc(size, alignment));
+	}
+
+	/*! \brief Change the size of allocated memory
+	 * The most recent allocation is resized in place (if possible), otherwise
+	 * new memory is allocated and the contents are copied.
+	 *
+	 * \param addr address of allocated memory (or `0` for a new allocation)
+	 * \param old_size size of the allocated memory
+	 * \param size new size
+	 * \return address of the resized memory or `0` on failure
+	 */
+	uintptr_t realloc(uintptr_t addr, size_t old_size, size_t size);
+
+	template<typename T>
+	inline T* realloc(T* addr, size_t old_size, size_t size) {
+		return reinterpret_cast<T*>(realloc(reinterpret_cast<uintptr_t>(addr), old_size, size));
+	}
+
+	/*! \brief Free allocated memory
+	 * Only the most recent allocation is actually released, others will
+	 * remain until reset (or roll back).
+	 *
+	 * \param addr address of allocated memory
+	 */
+	void free(uintptr_t addr) {
+		if (addr != 0 && addr == _last) {
+			_top = addr;
+			_last = 0;
+		}
+	}
+
+	template<typename T>
+	inline void free(T* addr) {
+		free(reinterpret_cast<uintptr_t>(addr));
+	}
+
+	/*! \brief Get current position
+	 * \return marker for \ref rollback
+	 */
+	Marker mark() const {
+		return { _current, _top };
+	}
+
+	/*! \brief Release all allocations after the marked position
+	 * \param marker position returned by \ref mark
+	 */
+	void rollback(const Marker & marker) {
+		if (marker.chunk == nullptr) {
+			reset();
+		} else {
+			_current = marker.chunk;
+			_top = marker.top;
+			_last = 0;
+		}
+	}
+
+	/*! \brief Release all allocations (keeping the chunks for reuse)
+	 */
+	void reset() {
+		_current = _first;
+		_top = _first == nullptr ? 0 : _first->begin();
+		_last = 0;
+	}
+
+	/*! \brief Memory reserved by this arena
+	 * \return total size of all chunks in bytes
+	 */
+	size_t reserved() const;
+};
+
+}  // namespace Memory
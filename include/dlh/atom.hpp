@@ -0,0 +1,108 @@
+// Dirty Little Helper (DLH) - system support library for C/C++
+// Copyright 2021-2023 by Bernhard Heinloth <heinloth@cs.fau.de>
+// SPDX-License-Identifier: AGPL-3.0-or-later
+
+/*! \file
+ *  \brief \ref Atom "Handle" of an interned string
+ */
+
+#pragma once
+
+#include <dlh/types.hpp>
+#include <dlh/strptr.hpp>
+#include <dlh/stream/buffer.hpp>
+
+class StringPool;
+
+/*! \brief Handle of a string interned in a \ref StringPool
+ *
+ * Each string is stored only once per pool (with a stable address), hence
+ * handles of the same pool are equal if and only if their pointers are equal.
+ * Length and hash of the string are stored right in front of it.
+ *
+ * \note Handles of different pools are never equal
+ */
+class Atom {
+	friend class StringPool;
+
+ public:
+	/*! \brief Meta data in front of each interned string */
+	struct Header {
+		/*! \brief String hash (see \ref String::hash) */
+		uint32_t hash;
+
+		/*! \brief Length of the string */
+		uint32_t len;
+	};
+
+ private:
+	/*! \brief Interned string (or `nullptr`) */
+	const char * _str = nullptr;
+
+	explicit Atom(const char * str) : _str(str) {}
+
+	const Header * header() const {
+		return reinterpret_cast<const Header *>(_str) - 1;
+	}
+
+ public:
+	/*! \brief Empty handle (not referring to any string) */
+	constexpr Atom() = default;
+
+	/*! \brief Interned string
+	 * \return pointer to null-terminated string (or `nullptr`)
+	 */
+	inline const char * c_str() const {
+		return _str;
+	}
+
+	/*! \brief Length of the interned string
+	 * \return number of characters (without terminating null byte)
+	 */
+	inline size_t len() const {
+		return _str == nullptr ? 0 : header()->len;
+	}
+
+	/*! \brief Hash of the interned string (same as \ref String::hash)
+	 * \return cached hash value
+	 */
+	inline uint32_t hash() const {
+		return _str == nullptr ? 0 : header()->hash;
+	}
+
+	/*! \brief Check if string is empty (or handle does not refer to a string)
+	 */
+	inline bool empty() const {
+		return len() == 0;
+	}
+
+	/*! \brief String pointer with cached hash and length
+	 */
+	inline StrPtr strptr() const {
+		StrPtr s;
+		s.str = _str;
+		s.hash = hash();
+		s.len = len();
+		return s;
+	}
+
+	inline explicit operator bool() const {
+		return _str != nullptr;
+	}
+
+	inline bool operator==(const Atom & other) const {
+		return _str == other._str;
+	}
+
+	inline bool operator!=(const Atom & other) const {
+		return _str != other._str;
+	}
+};
+
+static inline BufferStream& operator<<(BufferStream& bs, const Atom & a) {
+	if (a.c_str() == nullptr)
+		bs << "(nullptr)";
+	else
+		bs << a.c_str();
+	return bs;
+}
@@ -5,6 +5,7 @@
 #pragma once
 
 #include <dlh/mem.hpp>
+#include <dlh/atom.hpp>
 #include <dlh/string.hpp>
 #include <dlh/strptr.hpp>
 #include <dlh/utility.hpp>
@@ -58,6 +59,10 @@ struct Comparison {
 		return String::compare(a.str, b.str);
 	}
 
+	static inline int compare(const Atom & a, const Atom & b) {
+		return a == b ? 0 : String::compare(a.c_str(), b.c_str());
+	}
+
 	template<class OF, class OS>
 	static constexpr inline int compare(const Pair<OF, OS>& a, const Pair<OF, OS>& b) {
 		int f = compare(a.first, b.first);
@@ -147,6 +152,11 @@ struct Comparison {
 		return v.hash;
 	}
 
+	/*! \brief Hash of the address of an interned string (Fibonacci hashing) */
+	static inline uint32_t hash(const Atom & v) {
+		return hash(reinterpret_cast<uint64_t>(v.c_str()) * 0x9E3779B97F4A7C15ULL);
+	}
+
 	template<typename T>
 	static constexpr inline uint32_t hash(const T * v) {
 		uint_fast32_t h = 0;
@@ -0,0 +1,231 @@
+// Dirty Little Helper (DLH) - system support library for C/C++
+// Copyright 2021-2023 by Bernhard Heinloth <heinloth@cs.fau.de>
+// SPDX-License-Identifier: AGPL-3.0-or-later
+
+#pragma once
+
+#include <dlh/rwlock.hpp>
+#include <dlh/utility.hpp>
+#include <dlh/comparison.hpp>
+#include <dlh/container/hash.hpp>
+#include <dlh/container/optional.hpp>
+
+/*! \brief Concurrent hash map
+ *
+ * The key space is split into shards, each a \ref HashMap guarded by its own
+ * reader/writer lock (and placed in separate cache lines).
+ * Hence threads only contend if they access the same shard, and lookups in
+ * a shard do not block each other.
+ * Since entries might be modified by other threads after a lock has been
+ * released, values are returned as copies instead of references or iterators.
+ * \tparam K type for key
+ * \tparam V type for value
+ * \tparam C structure with comparison (`bool equal(const K&, const K&)`)
+ *           and hash (`uint32_t hash(const K&)`) functions
+ * \tparam N number of shards (power of two)
+ */
+template<typename K, typename V, typename C = Comparison, size_t N = 64>
+class ConcurrentHashMap {
+	static_assert(N > 0 && (N & (N - 1)) == 0, "Number of shards has to be a power of two");
+
+	/*! \brief Shard (padded to a multiple of the cache line size) */
+	struct Shard {
+		/*! \brief Lock for the map of this shard */
+		mutable RWLock<> lock;
+
+		/*! \brief Map with all keys of this shard */
+		HashMap<K, V, C> map;
+	} __attribute__((aligned(64)));
+
+	/*! \brief Shards */
+	Shard _shard[N];
+
+	/*! \brief Get shard of a key
+	 * \note Bits 32 to 37 (for 64 shards) of the spread hash are used, which are
+	 *       independent of the bucket selection within a shard (using either the
+	 *       hash value or the topmost bits of the spread hash)
+	 * \param hash hash value of the key (passed on to the map of the shard)
+	 * \return shard responsible for the key
+	 */
+	inline Shard & shard(uint32_t hash) {
+		return _shard[static_cast<uint32_t>((static_cast<uint64_t>(hash) * 0x9E3779B97F4A7C15ULL) >> 32) & (N - 1)];
+	}
+
+	inline const Shard & shard(uint32_t hash) const {
+		return const_cast<ConcurrentHashMap<K, V, C, N> *>(this)->shard(hash);
+	}
+
+ public:
+	/*! \brief Create new concurrent hash map
+	 * \param capacity initial capacity (distributed over all shards)
+	 */
+	explicit ConcurrentHashMap(size_t capacity = 0) {
+		if (capacity > 0)
+			for (auto & s : _shard)
+				s.map.resize(capacity / N + 1);
+	}
+
+	ConcurrentHashMap(const ConcurrentHashMap<K, V, C, N> &) = delete;
+	ConcurrentHashMap<K, V, C, N> & operator=(const ConcurrentHashMap<K, V, C, N> &) = delete;
+
+	/*! \brief Get value of a key
+	 * \param key key
+	 * \return copy of the value (if found)
+	 */
+	template<typename O>
+	Optional<V> at(const O & key) const {
+		const uint32_t h = C::hash(key);
+		const Shard & s = shard(h);
+		GuardedReader<Mutex> guard(s.lock);
+		auto i = s.map.find_hashed(key, h);
+		return i ? Optional<V>{i->value} : Optional<V>{};
+	}
+
+	/*! \brief check if map contains key
+	 * \param key key
+	 * \return `true` if key is in map
+	 */
+	template<typename O>
+	bool contains(const O & key) const {
+		const uint32_t h = C::hash(key);
+		const Shard & s = shard(h);
+		GuardedReader<Mutex> guard(s.lock);
+		return s.map.contains_hashed(key, h);
+	}
+
+	/*! \brief Insert element (if key is not in map yet)
+	 * \param key key
+	 * \param value value
+	 * \return `true` if inserted, `false` if key has already been in map
+	 */
+	bool insert(const K & key, const V & value) {
+		const uint32_t h = C::hash(key);
+		Shard & s = shard(h);
+		GuardedWriter<Mutex> guard(s.lock);
+		return s.map.insert_hashed(key, value, h).second;
+	}
+
+	/*! \brief Insert element or assign value of existing key
+	 * \param key key
+	 * \param value value
+	 * \return `true` if inserted, `false` if value of an existing key was assigned
+	 */
+	bool insert_or_assign(const K & key, const V & value) {
+		const uint32_t h = C::hash(key);
+		Shard & s = shard(h);
+		GuardedWriter<Mutex> guard(s.lock);
+		auto r = s.map.insert_hashed(key, value, h);
+		if (!r.second)
+			r.first->value = value;
+		return r.second;
+	}
+
+	/*! \brief Get value of a key or insert a computed value if key is absent
+	 * \note The function is called at most once and only if the key is absent,
+	 *       while holding the lock of the shard (hence it must not access this map)
+	 * \param key key
+	 * \param func function returning the value for the key (`V func(const K & key)`)
+	 * \return copy of the (existing or inserted) value
+	 */
+	template<typename F>
+	V compute_if_absent(const K & key, F func) {
+		const uint32_t h = C::hash(key);
+		Shard & s = shard(h);
+		{
+			// Fast path: key is already present
+			// (const lookup, which does not migrate elements in incremental mode)
+			GuardedReader<Mutex> guard(s.lock);
+			const auto & map = s.map;
+			auto i = map.find_hashed(key, h);
+			if (i)
+				return i->value;
+		}
+		GuardedWriter<Mutex> guard(s.lock);
+		// Key might have been inserted in the meantime
+		auto i = s.map.find_hashed(key, h);
+		if (i)
+			return i->value;
+		return s.map.insert_hashed(key, func(key), h).first->value;
+	}
+
+	/*! \brief Remove element
+	 * \param key key
+	 * \return removed value (if found)
+	 */
+	template<typename O>
+	Optional<V> erase(const O & key) {
+		Shard & s = shard(C::hash(key));
+		GuardedWriter<Mutex> guard(s.lock);
+		return s.map.erase(key);
+	}
+
+	/*! \brief Visit all elements, one shard at a time
+	 * \note Each shard is locked for reading while its elements are visited,
+	 *       hence the function must not modify this map.
+	 *       Concurrent modifications of other shards are possible.
+	 * \param func function called for each element (`void func(const K & key, const V & value)`)
+	 */
+	template<typename F>
+	void for_each(F func) const {
+		for (const auto & s : _shard) {
+			GuardedReader<Mutex> guard(s.lock);
+			for (const auto & e : s.map)
+				func(e.key, e.value);
+		}
+	}
+
+	/*! \brief Visit and modify all elements, one shard at a time
+	 * \note Each shard is locked for writing while its elements are visited,
+	 *       hence the function must not access this map.
+	 * \param func function called for each element (`void func(const K & key, V & value)`)
+	 */
+	template<typename F>
+	void for_each_mutable(F func) {
+		for (auto & s : _shard) {
+			GuardedWriter<Mutex> guard(s.lock);
+			for (auto & e : s.map)
+				func(const_cast<const K &>(e.key), e.value);
+		}
+	}
+
+	/*! \brief Test whether container is empty
+	 * \return true if map is empty (at the time each shard was checked)
+	 */
+	bool empty() const {
+		for (const auto & s : _shard) {
+			GuardedReader<Mutex> guard(s.lock);
+			if (!s.map.empty())
+				return false;
+		}
+		return true;
+	}
+
+	/*! \brief Element count
+	 * \note Shards are counted one after another, hence concurrent modifications
+	 *       might not be reflected correctly
+	 * \return Number of elements in map
+	 */
+	size_t size() const {
+		size_t r = 0;
+		for (const auto & s : _shard) {
+			GuardedReader<Mutex> guard(s.lock);
+			r += s.map.size();
+		}
+		return r;
+	}
+
+	/*! \brief Number of shards
+	 * \return shards
+	 */
+	static constexpr size_t shards() {
+		return N;
+	}
+
+	/*! \brief Clear all elements in map (one shard at a time) */
+	void clear() {
+		for (auto & s : _shard) {
+			GuardedWriter<Mutex> guard(s.lock);
+			s.map.clear();
+		}
+	}
+};
@@ -0,0 +1,722 @@
+// Dirty Little Helper (DLH) - system support library for C/C++
+// Copyright 2021-2023 by Bernhard Heinloth <heinloth@cs.fau.de>
+// SPDX-License-Identifier: AGPL-3.0-or-later
+
+#pragma once
+
+#include <dlh/mem.hpp>
+#include <dlh/arena.hpp>
+#include <dlh/assert.hpp>
+#include <dlh/utility.hpp>
+#include <dlh/comparison.hpp>
+#include <dlh/container/pair.hpp>
+#include <dlh/container/optional.hpp>
+#include <dlh/container/initializer_list.hpp>
+#include <dlh/container/internal/keyvalue.hpp>
+
+/*! \brief Flat hash set (open addressing)
+ *
+ * Elements are stored in place in a slot array (without links or cached
+ * hash values).
+ * Each slot has a control byte, either marking it as empty, erased or
+ * containing 7 bits of the element hash (fingerprint).
+ * The control bytes are probed in groups of 16 using SSE2, comparing all
+ * fingerprints of a group at once.
+ * Hence a lookup usually touches one cache line of control bytes and the
+ * matching slot.
+ * Groups are probed quadratically, a lookup ends at the first group with an
+ * empty slot.
+ * An erased slot is marked empty (instead of leaving a tombstone) if its
+ * group still contains an empty slot, since no lookup can have continued
+ * beyond such a group.
+ * \tparam T type for container
+ * \tparam C structure with comparison (`bool equal(const T&, const T&)`)
+ *           and hash (`uint32_t hash(const T&)`) functions
+ */
+template<typename T, typename C = Comparison>
+class FlatHashSet {
+ protected:
+	/*! \brief Control bytes of a group (for SSE2) */
+	typedef char Group __attribute__((vector_size(16), may_alias));
+
+	/*! \brief Number of slots in a group */
+	static const uint32_t GROUP = sizeof(Group);
+
+	/*! \brief Control byte of an empty slot */
+	static const char EMPTY = static_cast<char>(0x80);
+
+	/*! \brief Control byte of an erased slot (tombstone) */
+	static const char DELETED = static_cast<char>(0xfe);
+
+	/*! \brief Number of slots (power of two, at least one group or zero) */
+	uint32_t _capacity = 0;
+
+	/*! \brief Number of elements */
+	uint32_t _count = 0;
+
+	/*! \brief Remaining insertions into empty slots (maximum load factor 7/8) */
+	uint32_t _growth = 0;
+
+	/*! \brief Control bytes (followed by the slots in the same allocation) */
+	char * _ctrl = nullptr;
+
+	/*! \brief Slots */
+	T * _slot = nullptr;
+
+	/*! \brief Arena to allocate from (or `nullptr` to use the heap) */
+	Memory::Arena * _arena = nullptr;
+
+	/*! \brief base flat hash set iterator
+	 */
+	struct BaseIterator {
+		friend class FlatHashSet<T, C>;
+		const FlatHashSet<T, C> &ref;
+		mutable uint32_t i;
+
+		BaseIterator(const FlatHashSet<T, C> &ref, uint32_t p) : ref(ref), i(p) {}
+
+		inline void next() const {
+			do {
+				i++;
+			} while (i < ref._capacity && ref._ctrl[i] < 0);
+		}
+
+		inline const T& operator*() const {
+			assert(i < ref._capacity && ref._ctrl[i] >= 0);
+			return ref._slot[i];
+		}
+
+		inline const T* operator->() const {
+			assert(i < ref._capacity && ref._ctrl[i] >= 0);
+			return ref._slot + i;
+		}
+
+		inline bool operator==(const BaseIterator& other) const {
+			return &ref == &other.ref && i == other.i;
+		}
+
+		inline bool operator!=(const BaseIterator& other) const {
+			return &ref != &other.ref || i != other.i;
+		}
+
+		inline operator bool() const {
+			return i < ref._capacity;
+		}
+	};
+
+ public:
+	/*! \brief Create new flat hash set
+	 * \param capacity initial capacity
+	 */
+	explicit FlatHashSet(size_t capacity = 0) {
+		if (capacity > 0)
+			resize(capacity);
+	}
+
+	/*! \brief Create new flat hash set in an arena
+	 * \param arena arena to allocate slots from
+	 * \param capacity initial capacity
+	 */
+	explicit FlatHashSet(Memory::Arena & arena, size_t capacity = 0) : _arena(&arena) {
+		if (capacity > 0)
+			resize(capacity);
+	}
+
+	/*! \brief Copy constructor (using the heap)
+	 * \param set flat hash set to copy
+	 */
+	FlatHashSet(const FlatHashSet<T, C>& set) {
+		if (set._capacity > 0 && allocate(set._capacity)) {
+			Memory::copy(_ctrl, set._ctrl, _capacity);
+			for (uint32_t i = 0; i < _capacity; i++)
+				if (_ctrl[i] >= 0)
+					new (_slot + i) T(set._slot[i]);
+			_count = set._count;
+			_growth = set._growth;
+		}
+	}
+
+	/*! \brief Move constructor
+	 * \param set flat hash set to move
+	 */
+	FlatHashSet(FlatHashSet<T, C>&& set) : _capacity(set._capacity), _count(set._count), _growth(set._growth), _ctrl(set._ctrl), _slot(set._slot), _arena(set._arena) {
+		set._capacity = 0;
+		set._count = 0;
+		set._growth = 0;
+		set._ctrl = nullptr;
+		set._slot = nullptr;
+	}
+
+	FlatHashSet<T, C> & operator=(const FlatHashSet<T, C> &) = delete;
+	FlatHashSet<T, C> & operator=(FlatHashSet<T, C> && other) = delete;
+
+	/*! \brief Initializer list constructor
+	 * \param flist initializer list
+	 */
+	template<typename I>
+	FlatHashSet(const std::initializer_list<I> & list) {
+		if (list.size() > 0) {
+			resize(list.size());
+			for (const auto & arg : list)
+				emplace(arg);
+		}
+	}
+
+	/*! \brief Destructor
+	 */
+	~FlatHashSet() {
+		clear();
+		release(_ctrl);
+	}
+
+	/*! \brief flat hash set iterator
+	 */
+	class Iterator : public BaseIterator {
+		friend class FlatHashSet<T, C>;
+		Iterator(FlatHashSet<T, C> &ref, uint32_t p) : BaseIterator(ref, p) {}
+
+	 public:
+		using BaseIterator::operator*;
+		using BaseIterator::operator->;
+		using BaseIterator::operator==;
+		using BaseIterator::operator!=;
+		using BaseIterator::operator bool;
+
+		Iterator& operator++() {
+			BaseIterator::next();
+			return *this;
+		}
+
+		inline T& operator*() {
+			return const_cast<T&>(BaseIterator::operator*());
+		}
+
+		inline T* operator->() {
+			return const_cast<T*>(BaseIterator::operator->());
+		}
+	};
+
+	/*! \brief constant flat hash set iterator
+	 */
+	class ConstIterator : public BaseIterator {
+		friend class FlatHashSet<T, C>;
+		ConstIterator(const FlatHashSet<T, C> &ref, uint32_t p) : BaseIterator(ref, p) {}
+
+	 public:
+		using BaseIterator::operator*;
+		using BaseIterator::operator->;
+		using BaseIterator::operator==;
+		using BaseIterator::operator!=;
+		using BaseIterator::operator bool;
+
+		const ConstIterator& operator++() const {
+			BaseIterator::next();
+			return *this;
+		}
+	};
+
+	/*! \brief Get iterator to first element
+	 * \return iterator to first valid element (if available) or `end()`
+	 */
+	inline Iterator begin() {
+		return Iterator{*this, first()};
+	}
+
+	/*! \brief Get iterator to end (post-last-element)
+	 * \return iterator to end (first invalid element)
+	 */
+	inline Iterator end() {
+		return Iterator{*this, _capacity};
+	}
+
+	/*! \brief Get iterator to first element
+	 * \return iterator to first valid element (if available) or `end()`
+	 */
+	inline ConstIterator begin() const {
+		return ConstIterator{*this, first()};
+	}
+
+	/*! \brief Get iterator to end (post-last-element)
+	 * \return iterator to end (first invalid element)
+	 */
+	inline ConstIterator end() const {
+		return ConstIterator{*this, _capacity};
+	}
+
+	/*! \brief Create new element into set
+	 * \param args Arguments to construct element
+	 * \return iterator to the new element (`first`) and
+	 *         indicator if element was created (`true`) or has already been in the set (`false`)
+	 */
+	template<typename... ARGS>
+	inline Pair<Iterator, bool> emplace(ARGS&&... args) {
+		return insert(T(forward<ARGS>(args)...));
+	}
+
+	/*! \brief Insert element into set
+	 * \param value new element to be inserted
+	 * \return iterator to the inserted element (`first`) and
+	 *         indicator (`second`) if element was created (`true`) or has already been in the set (`false`)
+	 */
+	inline Pair<Iterator, bool> insert(const T &value) {
+		return insert_value(value);
+	}
+
+	/*! \brief Insert element into set
+	 * \param value new element to be inserted
+	 * \return iterator to the inserted element (`first`) and
+	 *         indicator (`second`) if element was created (`true`) or has already been in the set (`false`)
+	 */
+	inline Pair<Iterator, bool> insert(T &&value) {
+		return insert_value(move(value));
+	}
+
+	/*! \brief Get iterator to specific element
+	 * \param value element
+	 * \return iterator to element (if found) or `end()` (if not found)
+	 */
+	template<typename U>
+	inline Iterator find(const U& value) {
+		return Iterator(*this, find_index(value));
+	}
+
+	/*! \brief Get iterator to specific element
+	 * \param value element
+	 * \return iterator to element (if found) or `end()` (if not found)
+	 */
+	template<typename U>
+	inline ConstIterator find(const U& value) const {
+		return ConstIterator(*this, find_index(value));
+	}
+
+	/*! \brief check if set contains element
+	 * \param value element
+	 * \return `true` if element is in set
+	 */
+	template<typename U>
+	inline bool contains(const U& value) const {
+		return find_index(value) != _capacity;
+	}
+
+	/*! \brief Remove value from set
+	 * \param position iterator to element
+	 * \return removed value (if valid iterator)
+	 */
+	Optional<T> erase(const BaseIterator & position) {
+		if (&position.ref == this && position.i < _capacity && _ctrl[position.i] >= 0)
+			return erase_index(position.i);
+		else
+			return Optional<T>{};
+	}
+
+	/*! \brief Remove value from set
+	 * \param position iterator to element
+	 * \return removed value (if valid iterator)
+	 */
+	Optional<T> erase(const Iterator & position) {
+		return erase(reinterpret_cast<const BaseIterator &>(position));
+	}
+
+	/*! \brief Remove value from set
+	 * \param position iterator to element
+	 * \return removed value (if valid iterator)
+	 */
+	Optional<T> erase(const ConstIterator & position) {
+		return erase(reinterpret_cast<const BaseIterator &>(position));
+	}
+
+	/*! \brief Remove value from set
+	 * \param value element to be removed
+	 * \return removed value (if found)
+	 */
+	template<typename U>
+	inline Optional<T> erase(const U& value) {
+		uint32_t i = find_index(value);
+		return i == _capacity ? Optional<T>{} : erase_index(i);
+	}
+
+	/*! \brief Recalculate hash values
+	 * (and remove tombstones of erased elements)
+	 */
+	inline void rehash() {
+		if (_capacity > 0)
+			reallocate(_capacity);
+	}
+
+	/*! \brief Resize set capacity
+	 * \param capacity number of elements to store without further resizing
+	 *                 (has to be equal or greater than `size()`)
+	 * \return `true` if resize was successfully, `false` otherwise
+	 */
+	bool resize(size_t capacity) {
+		if (capacity < _count)
+			return false;
+		// Slots for a maximum load factor of 7/8
+		size_t slots = GROUP;
+		while (slots - slots / 8 < capacity)
+			slots *= 2;
+		if (slots > (1UL << 31))
+			return false;
+		return slots == _capacity || reallocate(static_cast<uint32_t>(slots));
+	}
+
+	/*! \brief Test whether container is empty
+	 * \return true if set is empty
+	 */
+	inline bool empty() const {
+		return _count == 0;
+	}
+
+	/*! \brief Element count
+	 * \return Number of (unique) elements in set
+	 */
+	inline size_t size() const {
+		return _count;
+	}
+
+	/*! \brief Available slots
+	 * \return Number of slots (including unusable ones due to the maximum load factor)
+	 */
+	inline size_t capacity() const {
+		return _capacity;
+	}
+
+	/*! \brief Clear all elements in set */
+	void clear() {
+		if (_count > 0)
+			for (uint32_t i = 0; i < _capacity; i++)
+				if (_ctrl[i] >= 0)
+					_slot[i].~T();
+		if (_capacity > 0)
+			Memory::set(_ctrl, EMPTY, _capacity);
+		_count = 0;
+		_growth = _capacity - _capacity / 8;
+	}
+
+ private:
+	/*! \brief Spread the hash value
+	 * \param value element
+	 * \return 64 bit hash (group index in the upper, fingerprint in the highest bits)
+	 */
+	template<typename U>
+	static inline uint64_t hash(const U& value) {
+		return static_cast<uint64_t>(C::hash(value)) * 0x9E3779B97F4A7C15ULL;
+	}
+
+	/*! \brief Fingerprint of a hash
+	 * \param h 64 bit hash
+	 * \return control byte (7 bit)
+	 */
+	static inline char fingerprint(uint64_t h) {
+		return static_cast<char>(h >> 57);
+	}
+
+	/*! \brief Start of probing sequence
+	 * \param h 64 bit hash
+	 * \return index of first slot of the group
+	 */
+	inline uint32_t start(uint64_t h) const {
+		return (static_cast<uint32_t>(h >> 32) * GROUP) & (_capacity - 1);
+	}
+
+	/*! \brief Match control bytes of a group
+	 * \param ctrl first control byte of the group
+	 * \param c control byte to match
+	 * \return mask with bit `n` set if slot `n` of the group matches
+	 */
+	static inline unsigned match(const char * ctrl, char c) {
+		return __builtin_ia32_pmovmskb128(*reinterpret_cast<const Group *>(ctrl) == (Group{} + c));
+	}
+
+	/*! \brief Match empty or erased slots of a group
+	 * \param ctrl first control byte of the group
+	 * \return mask with bit `n` set if slot `n` of the group is free
+	 */
+	static inline unsigned match_free(const char * ctrl) {
+		return __builtin_ia32_pmovmskb128(*reinterpret_cast<const Group *>(ctrl));
+	}
+
+	/*! \brief Index of first element
+	 * \return slot index (or `_capacity` if empty)
+	 */
+	inline uint32_t first() const {
+		uint32_t i = 0;
+		if (_count > 0)
+			while (_ctrl[i] < 0)
+				i++;
+		else
+			i = _capacity;
+		return i;
+	}
+
+	/*! \brief Find value
+	 * \param value the value we are looking for
+	 * \return slot index of target value or `_capacity` if not found
+	 */
+	template<typename U>
+	inline uint32_t find_index(const U& value) const {
+		if (_count == 0)
+			return _capacity;
+		const uint64_t h = hash(value);
+		const char f = fingerprint(h);
+		uint32_t g = start(h);
+		for (uint32_t step = GROUP; step <= _capacity; step += GROUP) {
+			const char * ctrl = _ctrl + g;
+			for (unsigned m = match(ctrl, f); m != 0; m &= m - 1) {
+				const uint32_t i = g + __builtin_ctz(m);
+				if (C::equal(_slot[i], value))
+					return i;
+			}
+			if (match(ctrl, EMPTY) != 0)
+				break;
+			// Quadratic (triangular) probing visits every group
+			g = (g + step) & (_capacity - 1);
+		}
+		return _capacity;
+	}
+
+	/*! \brief Find slot for a new element
+	 * \param h 64 bit hash of the element
+	 * \return index of the first empty or erased slot in the probing sequence
+	 */
+	inline uint32_t find_free(uint64_t h) const {
+		uint32_t g = start(h);
+		for (uint32_t step = GROUP; ; step += GROUP) {
+			unsigned m = match_free(_ctrl + g);
+			if (m != 0)
+				return g + __builtin_ctz(m);
+			g = (g + step) & (_capacity - 1);
+		}
+	}
+
+	/*! \brief Insert helper
+	 * \param value element to insert (copied or moved)
+	 * \return iterator to the element and indicator if it was inserted
+	 */
+	template<typename U>
+	Pair<Iterator, bool> insert_value(U&& value) {
+		uint32_t i = find_index(value);
+		if (i != _capacity)
+			return Pair<Iterator, bool>{Iterator(*this, i), false};
+
+		if (_capacity == 0 && !resize(GROUP - GROUP / 8))
+			return Pair<Iterator, bool>{end(), false};
+		const uint64_t h = hash(value);
+		i = find_free(h);
+		if (_growth == 0 && _ctrl[i] == EMPTY) {
+			// Double capacity, unless tombstones occupy more than half of the load
+			if (!reallocate(_count * 2 < _capacity - _capacity / 8 ? _capacity : _capacity * 2))
+				return Pair<Iterator, bool>{end(), false};
+			i = find_free(h);
+		}
+
+		if (_ctrl[i] == EMPTY)
+			_growth--;
+		_ctrl[i] = fingerprint(h);
+		new (_slot + i) T(forward<U>(value));
+		_count++;
+		return Pair<Iterator, bool>{Iterator(*this, i), true};
+	}
+
+	/*! \brief Erase helper
+	 * \param i slot index of the element
+	 * \return removed value
+	 */
+	Optional<T> erase_index(uint32_t i) {
+		assert(i < _capacity && _ctrl[i] >= 0);
+		// Moving into the optional destroys the element in the slot
+		Optional<T> r{move(_slot[i])};
+		// Probing continues after a group only if it has no empty slot
+		if (match(_ctrl + (i & ~(GROUP - 1)), EMPTY) != 0) {
+			_ctrl[i] = EMPTY;
+			_growth++;
+		} else {
+			_ctrl[i] = DELETED;
+		}
+		_count--;
+		return r;
+	}
+
+	/*! \brief Allocate control bytes and slots (without releasing the current ones)
+	 * \param capacity number of slots
+	 * \return `true` on success
+	 */
+	bool allocate(uint32_t capacity) {
+		const size_t size = capacity + static_cast<size_t>(capacity) * sizeof(T);
+		char * ctrl = _arena == nullptr ? Memory::alloc<char>(size) : _arena->alloc<char>(size);
+		if (ctrl == nullptr)
+			return false;
+		Memory::set(ctrl, EMPTY, capacity);
+		_ctrl = ctrl;
+		_slot = reinterpret_cast<T *>(ctrl + capacity);
+		_capacity = capacity;
+		_growth = capacity - capacity / 8;
+		return true;
+	}
+
+	/*! \brief Release memory of control bytes and slots
+	 * \param ctrl pointer to control bytes
+	 */
+	void release(char * ctrl) {
+		if (ctrl == nullptr)
+			return;
+		else if (_arena == nullptr)
+			Memory::free(ctrl);
+		else
+			_arena->free(ctrl);
+	}
+
+	/*! \brief Move all elements into new slots
+	 * \param capacity new number of slots
+	 * \return `true` on success
+	 */
+	bool reallocate(uint32_t capacity) {
+		char * old_ctrl = _ctrl;
+		T * old_slot = _slot;
+		const uint32_t old_capacity = _capacity;
+		if (!allocate(capacity))
+			return false;
+
+		for (uint32_t i = 0; i < old_capacity; i++)
+			if (old_ctrl[i] >= 0) {
+				const uint64_t h = hash(old_slot[i]);
+				const uint32_t j = find_free(h);
+				_ctrl[j] = fingerprint(h);
+				new (_slot + j) T(move(old_slot[i]));
+				old_slot[i].~T();
+			}
+		_growth -= _count;
+		release(old_ctrl);
+		return true;
+	}
+};
+
+
+/*! \brief Flat hash map (open addressing)
+ * \see FlatHashSet
+ * \tparam K type for key
+ * \tparam V type for value
+ * \tparam C structure with comparison (`bool equal(const K&, const K&)`)
+ *           and hash (`uint32_t hash(const K&)`) functions
+ */
+template<typename K, typename V, typename C = Comparison>
+class FlatHashMap : protected FlatHashSet<KeyValue<K, V>, C> {
+	using Base = FlatHashSet<KeyValue<K, V>, C>;
+	using typename Base::BaseIterator;
+
+ public:
+	using typename Base::Iterator;
+	using typename Base::ConstIterator;
+	using Base::begin;
+	using Base::end;
+	using Base::find;
+	using Base::contains;
+	using Base::resize;
+	using Base::rehash;
+	using Base::empty;
+	using Base::size;
+	using Base::capacity;
+	using Base::clear;
+
+	/*! \brief Create new flat hash map
+	 * \param capacity initial capacity
+	 */
+	explicit FlatHashMap(size_t capacity = 0) : Base(capacity) {}
+
+	/*! \brief Create new flat hash map in an arena
+	 * \param arena arena to allocate slots from
+	 * \param capacity initial capacity
+	 */
+	explicit FlatHashMap(Memory::Arena & arena, size_t capacity = 0) : Base(arena, capacity) {}
+
+	/*! \brief Insert element */
+	inline Pair<Iterator, bool> insert(const K& key, const V& value) {
+		return Base::emplace(key, value);
+	}
+
+	inline Pair<Iterator, bool> insert(K&& key, V&& value) {
+		return Base::emplace(move(key), move(value));
+	}
+
+	inline Optional<V> erase(const BaseIterator & position) {
+		auto i = Base::erase(position);
+		if (i)
+			return Optional<V>{move(i->value)};
+		else
+			return Optional<V>{};
+	}
+
+	inline Optional<V> erase(const Iterator & position) {
+		return erase(reinterpret_cast<const BaseIterator &>(position));
+	}
+
+	inline Optional<V> erase(const ConstIterator & position) {
+		return erase(reinterpret_cast<const BaseIterator &>(position));
+	}
+
+	template<typename O>
+	inline Optional<V> erase(const O& key) {
+		auto i = Base::erase(key);
+		if (i)
+			return Optional<V>{move(i->value)};
+		else
+			return Optional<V>{};
+	}
+
+	template<typename O>
+	inline Optional<V> at(const O& key) const {
+		auto i = Base::find(key);
+		if (i)
+			return Optional<V>{i->value};
+		else
+			return Optional<V>{};
+	}
+
+	template<typename O>
+	inline V & operator[](const O& key) {
+		auto i = Base::find(key);
+		return i ? i->value : (*(Base::emplace(key).first)).value;
+	}
+};
+
+
+/*! \brief Print contents of a FlatHashSet
+ *
+ *  \param s Target Stream
+ *  \param set FlatHashSet to be printed
+ *  \return Reference to Stream; allows operator chaining.
+ */
+template<typename S, typename T, typename C>
+static inline S & operator<<(S & s, const FlatHashSet<T, C> & set) {
+	s << '{';
+	bool p = false;
+	for (const auto & entry : set) {
+		if (p)
+			s << ',';
+		else
+			p = true;
+		s << ' ' << entry;
+	}
+	return s << ' ' << '}';
+}
+
+
+/*! \brief Print contents of a FlatHashMap
+ *
+ *  \param s Target Stream
+ *  \param set FlatHashMap to be printed
+ *  \return Reference to Stream; allows operator chaining.
+ */
+template<typename S, typename K, typename V, typename C>
+static inline S & operator<<(S & s, const FlatHashMap<K, V, C> & map) {
+	s << '{';
+	bool p = false;
+	for (const auto & entry : map) {
+		if (p)
+			s << ',';
+		else
+			p = true;
+		s << ' ' << entry;
+	}
+	return s << ' ' << '}';
+}
@@ -14,15 +14,96 @@
 #include <dlh/container/internal/elements.hpp>
 #include <dlh/container/internal/keyvalue.hpp>
 
+/*! \brief Policies to reduce a hash value to a bucket index
+ * Each policy provides the actual number of buckets for a requested minimum
+ * (`uint32_t size(uint32_t buckets)`) and the reduction of a hash value
+ * (`uint32_t index(uint32_t hash, uint32_t size)`).
+ */
+namespace HashBucket {
+
+/*! \brief Round up to the next power of two
+ * \param buckets requested number of buckets
+ * \return power of two (at most 2^31)
+ */
+static inline uint32_t power_of_two(uint32_t buckets) {
+	return buckets <= 2 ? 2 : (buckets > (1U << 31) ? (1U << 31) : (1U << (32 - __builtin_clz(buckets - 1))));
+}
+
+/*! \brief Modulo of the hash value
+ * Uses all bits of the hash value (robust for poor hash functions),
+ * but requires a (slow) integer division.
+ */
+struct Modulo {
+	static inline uint32_t size(uint32_t buckets) {
+		return buckets;
+	}
+
+	static inline uint32_t index(uint32_t hash, uint32_t size) {
+		return hash % size;
+	}
+};
+
+/*! \brief Lower bits of the hash value (power of two buckets)
+ * Fastest reduction, but only suitable for hash functions with
+ * well distributed lower bits.
+ */
+struct Mask {
+	static inline uint32_t size(uint32_t buckets) {
+		return power_of_two(buckets);
+	}
+
+	static inline uint32_t index(uint32_t hash, uint32_t size) {
+		return hash & (size - 1);
+	}
+};
+
+/*! \brief Upper bits of the hash value multiplied with the golden ratio (power of two buckets)
+ * Fibonacci hashing spreads all bits of the hash value, hence it is suitable
+ * for identity hashes of integers and (aligned) pointers.
+ */
+struct Fibonacci {
+	static inline uint32_t size(uint32_t buckets) {
+		return power_of_two(buckets);
+	}
+
+	static inline uint32_t index(uint32_t hash, uint32_t size) {
+		return static_cast<uint32_t>((hash * 0x9E3779B97F4A7C15ULL) >> (64 - __builtin_ctz(size)));
+	}
+};
+
+/*! \brief Multiply-shift range reduction (Lemire)
+ * Maps the hash value to an arbitrary number of buckets without division,
+ * but only considers the upper bits of the hash value
+ * (unsuitable for identity hashes of small integers).
+ */
+struct FastRange {
+	static inline uint32_t size(uint32_t buckets) {
+		return buckets;
+	}
+
+	static inline uint32_t index(uint32_t hash, uint32_t size) {
+		return static_cast<uint32_t>((static_cast<uint64_t>(hash) * size) >> 32);
+	}
+};
+
+}  // namespace HashBucket
+
 /*! \brief Hash set
  * influenced by standard [template/cxx] librarys `unordered_set`
  * \tparam T type for container
  * \tparam C structure with comparison (`bool equal(const T&, const T&)`)
  *           and hash (`uint32_t hash(const T&)`) functions
  * \tparam L percentage of hash buckets (compared to element capacity)
+ * \tparam R policy to reduce hash values to bucket indices (see \ref HashBucket)
  */
-template<typename T, typename C = Comparison, size_t L = 150>
+template<typename T, typename C = Comparison, size_t L = 150, typename R = HashBucket::Fibonacci>
 class HashSet : public Elements<T> {
+	/*! \brief Previous hash buckets migrated per operation (in incremental mode) */
+	static const uint32_t MIGRATE_BUCKETS = 8;
+
+	/*! \brief New hash buckets cleared per operation (in incremental mode) */
+	static const uint32_t CLEAR_BUCKETS = 1024;
+
  protected:
 	using Elements<T>::_capacity;
 	using Elements<T>::_next;
@@ -35,14 +116,34 @@ class HashSet : public Elements<T> {
 	/*! \brief Pointer to start of hash bucket array */
 	uint32_t * _bucket = nullptr;
 
+	/*! \brief Incremental mode (hash buckets are allocated separately) */
+	bool _incremental = false;
+
+	/*! \brief Number of cleared buckets in the new hash bucket array (during migration) */
+	uint32_t _cleared = 0;
+
+	/*! \brief Number of migrated buckets of the previous hash bucket array */
+	uint32_t _migrated = 0;
+
+	/*! \brief Previous hash bucket capacity (during migration) */
+	uint32_t _old_bucket_capacity = 0;
+
+	/*! \brief Pointer to previous hash bucket array (or `nullptr` if not migrating) */
+	uint32_t * _old_bucket = nullptr;
+
+	/*! \brief First free (erased) node slot for reuse in incremental mode
+	 * further free slots are linked using `hash.next`
+	 */
+	uint32_t _free = 0;
+
 	/*! \brief base hash set iterator
 	 */
 	struct BaseIterator {
-		friend class HashSet<T, C>;
-		const HashSet<T, C> &ref;
+		friend class HashSet<T, C, L, R>;
+		const HashSet<T, C, L, R> &ref;
 		mutable uint32_t i;
 
-		BaseIterator(const HashSet<T, C> &ref, uint32_t p) : ref(ref), i(p) {}
+		BaseIterator(const HashSet<T, C, L, R> &ref, uint32_t p) : ref(ref), i(p) {}
 
 		inline void next() const {
 			do {
@@ -103,17 +204,31 @@ class HashSet : public Elements<T> {
 		assert(empty() || !Elements<T>::_node[0].hash.active);
 	}
 
+	/*! \brief Create new hash set in an arena
+	 * \param arena arena to allocate elements from
+	 * \param capacity initial capacity
+	 */
+	explicit HashSet(Memory::Arena & arena, size_t capacity = 0) : Elements<T>(&arena) {
+		if (capacity > 0)
+			resize(capacity + 1);
+		assert(empty() || !Elements<T>::_node[0].hash.active);
+	}
+
 	/*! \brief Convert to hash set
 	 * \param set Elements container
 	 */
-	HashSet(const HashSet<T, C>& set)
+	HashSet(const HashSet<T, C, L, R>& set)
 	 : Elements<T>(set, set._bucket_capacity * sizeof(uint32_t)),
 	   _bucket_capacity(set._bucket_capacity),
 	   _bucket(reinterpret_cast<uint32_t *>(Elements<T>::reserved())) {
 		const size_t size = _bucket_capacity * sizeof(uint32_t);
 		if (size > 0) {
 			assert(_bucket != nullptr);
-			Memory::copy(_bucket, set._bucket, size);
+			// Buckets are split over two arrays during an incremental migration
+			if (set._old_bucket != nullptr)
+				bucketize();
+			else
+				Memory::copy(_bucket, set._bucket, size);
 			assert(!Elements<T>::_node[0].hash.active);
 		}
 	}
@@ -134,10 +249,22 @@ class HashSet : public Elements<T> {
 	/*! \brief Convert to hash set
 	 * \param elements Elements container
 	 */
-	HashSet(HashSet<T, C> && set)
+	HashSet(HashSet<T, C, L, R> && set)
 	  : Elements<T>(move(set)),
 	    _bucket_capacity(set._bucket_capacity),
-		_bucket(reinterpret_cast<uint32_t *>(Elements<T>::reserved())) {}
+		_bucket(set._incremental ? set._bucket : reinterpret_cast<uint32_t *>(Elements<T>::reserved())),
+		_incremental(set._incremental),
+		_cleared(set._cleared),
+		_migrated(set._migrated),
+		_old_bucket_capacity(set._old_bucket_capacity),
+		_old_bucket(set._old_bucket),
+		_free(set._free) {
+		if (_incremental) {
+			set._bucket = set._old_bucket = nullptr;
+			set._bucket_capacity = 0;
+		}
+		set._free = 0;
+	}
 
 	/*! \brief Convert to hash set
 	 * \param elements Elements container
@@ -153,8 +280,8 @@ class HashSet : public Elements<T> {
 		}
 	}
 
-	HashSet<T, C> & operator=(const HashSet<T, C> &) = delete;
-	HashSet<T, C> & operator=(HashSet<T, C> && other) = delete;
+	HashSet<T, C, L, R> & operator=(const HashSet<T, C, L, R> &) = delete;
+	HashSet<T, C, L, R> & operator=(HashSet<T, C, L, R> && other) = delete;
 
 	/*! \brief Range constructor
 	 * \param begin First element in range
@@ -192,13 +319,18 @@ class HashSet : public Elements<T> {
 
 	/*! \brief Destructor
 	 */
-	virtual ~HashSet() {}
+	virtual ~HashSet() {
+		if (_incremental) {
+			release(_bucket);
+			release(_old_bucket);
+		}
+	}
 
 	/*! \brief binary search tree iterator
 	 */
 	class Iterator : public BaseIterator {
-		friend class HashSet<T, C>;
-		Iterator(HashSet<T, C> &ref, uint32_t p) : BaseIterator(ref, p) {}
+		friend class HashSet<T, C, L, R>;
+		Iterator(HashSet<T, C, L, R> &ref, uint32_t p) : BaseIterator(ref, p) {}
 
 	 public:
 		using BaseIterator::operator*;
@@ -224,8 +356,8 @@ class HashSet : public Elements<T> {
 	/*! \brief constant binary search tree iterator
 	 */
 	class ConstIterator : public BaseIterator {
-		friend class HashSet<T, C>;
-		ConstIterator(const HashSet<T, C> &ref, uint32_t p) : BaseIterator(ref, p) {}
+		friend class HashSet<T, C, L, R>;
+		ConstIterator(const HashSet<T, C, L, R> &ref, uint32_t p) : BaseIterator(ref, p) {}
 
 	 public:
 		using BaseIterator::operator*;
@@ -243,8 +375,8 @@ class HashSet : public Elements<T> {
 	/*! \brief Reverse binary search tree iterator
 	 */
 	class ReverseIterator : public BaseIterator {
-		friend class HashSet<T, C>;
-		ReverseIterator(HashSet<T, C> &ref, uint32_t p) : BaseIterator(ref, p) {}
+		friend class HashSet<T, C, L, R>;
+		ReverseIterator(HashSet<T, C, L, R> &ref, uint32_t p) : BaseIterator(ref, p) {}
 
 	 public:
 		using BaseIterator::operator*;
@@ -270,8 +402,8 @@ class HashSet : public Elements<T> {
 	/*! \brief constant binary search tree iterator
 	 */
 	class ConstReverseIterator : public BaseIterator {
-		friend class HashSet<T, C>;
-		ConstReverseIterator(const HashSet<T, C> &ref, uint32_t p) : BaseIterator(ref, p) {}
+		friend class HashSet<T, C, L, R>;
+		ConstReverseIterator(const HashSet<T, C, L, R> &ref, uint32_t p) : BaseIterator(ref, p) {}
 
 	 public:
 		using BaseIterator::operator*;
@@ -380,17 +512,26 @@ class HashSet : public Elements<T> {
 		increase();
 
 		// Create local element (not active yet!)
-		auto & next = Elements<T>::_node[Elements<T>::_next];
+		auto & next = Elements<T>::_node[slot()];
 		new (&next.data) T(forward<ARGS>(args)...);
-		uint32_t * b = bucket(next.hash.temp = C::hash(next.data));
+		return emplace_staged(C::hash(next.data));
+	}
 
-		// Check if already in set
-		uint32_t i = find_in(b, next.data);
-		if (i != Elements<T>::_next)
-			return Pair<Iterator, bool>{Iterator(*this, i), false};
+	/*! \brief Create new element with precomputed hash value into set
+	 * \param hash hash value of the element (has to be equal to `C::hash` of the element)
+	 * \param args Arguments to construct element
+	 * \return iterator to the new element (`first`) and
+	 *         indicator if element was created (`true`) or has already been in the set (`false`)
+	 */
+	template<typename... ARGS>
+	Pair<Iterator, bool> emplace_hashed(uint32_t hash, ARGS&&... args) {
+		increase();
 
-		// Insert
-		return insert(Elements<T>::_next++, b);
+		// Create local element (not active yet!)
+		auto & next = Elements<T>::_node[slot()];
+		new (&next.data) T(forward<ARGS>(args)...);
+		assert(C::hash(next.data) == hash);
+		return emplace_staged(hash);
 	}
 
 	/*! \brief Insert element into set
@@ -398,11 +539,21 @@ class HashSet : public Elements<T> {
 	 * \return iterator to the inserted element (`first`) and
 	 *         indicator (`second`) if element was created (`true`) or has already been in the set (`false`)
 	 */
-	Pair<Iterator, bool> insert(const T &value) {
+	inline Pair<Iterator, bool> insert(const T &value) {
+		return insert_hashed(value, C::hash(value));
+	}
+
+	/*! \brief Insert element with precomputed hash value into set
+	 * \param value new element to be inserted
+	 * \param h hash value of the element (has to be equal to `C::hash(value)`)
+	 * \return iterator to the inserted element (`first`) and
+	 *         indicator (`second`) if element was created (`true`) or has already been in the set (`false`)
+	 */
+	Pair<Iterator, bool> insert_hashed(const T &value, uint32_t h) {
+		assert(C::hash(value) == h);
 		increase();
 
 		// Get Bucket
-		uint32_t h = C::hash(value);
 		uint32_t * b = bucket(h);
 
 		// Check if already in set
@@ -411,10 +562,11 @@ class HashSet : public Elements<T> {
 			return Pair<Iterator, bool>{Iterator(*this, i), false};
 
 		// Insert at position
-		auto & next = Elements<T>::_node[Elements<T>::_next];
+		uint32_t n = take();
+		auto & next = Elements<T>::_node[n];
 		next.hash.temp = h;
 		new (&next.data) T(value);
-		return insert(Elements<T>::_next++, b);
+		return insert(n, b);
 	}
 
 	/*! \brief Insert element node into set
@@ -432,7 +584,7 @@ class HashSet : public Elements<T> {
 		} else {
 			size_t n = 0;
 			if (!Elements<T>::is_node(value, n) || n == 0)
-				new (&Elements<T>::_node[n = Elements<T>::_next++].data) T(move(value.data));
+				new (&Elements<T>::_node[n = take()].data) T(move(value.data));
 			Elements<T>::_node[n].hash.temp = h;
 			return insert(n, b);
 		}
@@ -445,7 +597,7 @@ class HashSet : public Elements<T> {
 	 */
 	template<typename U>
 	inline Iterator find(const U& value) {
-		return empty() ? end() : Iterator(*this, find_in(bucket(C::hash(value)), value));
+		return find_hashed(value, C::hash(value));
 	}
 
 	/*! \brief Get iterator to specific element
@@ -454,7 +606,30 @@ class HashSet : public Elements<T> {
 	 */
 	template<typename U>
 	inline ConstIterator find(const U& value) const {
-		return empty() ? end() : ConstIterator(*this, find_in(bucket(C::hash(value)), value));
+		return find_hashed(value, C::hash(value));
+	}
+
+	/*! \brief Get iterator to specific element using a precomputed hash value
+	 * \param value element (or any type comparable by `C::equal`)
+	 * \param hash hash value of the element (has to be equal to `C::hash(value)`)
+	 * \return iterator to element (if found) or `end()` (if not found)
+	 */
+	template<typename U>
+	inline Iterator find_hashed(const U& value, uint32_t hash) {
+		assert(C::hash(value) == hash);
+		migrate();
+		return empty() ? end() : Iterator(*this, find_in(bucket(hash), value));
+	}
+
+	/*! \brief Get iterator to specific element using a precomputed hash value
+	 * \param value element (or any type comparable by `C::equal`)
+	 * \param hash hash value of the element (has to be equal to `C::hash(value)`)
+	 * \return iterator to element (if found) or `end()` (if not found)
+	 */
+	template<typename U>
+	inline ConstIterator find_hashed(const U& value, uint32_t hash) const {
+		assert(C::hash(value) == hash);
+		return empty() ? end() : ConstIterator(*this, find_in(bucket(hash), value));
 	}
 
 	/*! \brief check if set contains element
@@ -463,7 +638,28 @@ class HashSet : public Elements<T> {
 	 */
 	template<typename U>
 	inline bool contains(const U& value) const {
-		return empty() ? false : (find_in(bucket(C::hash(value)), value) != Elements<T>::_next);
+		return contains_hashed(value, C::hash(value));
+	}
+
+	/*! \brief check if set contains element using a precomputed hash value
+	 * \param value element (or any type comparable by `C::equal`)
+	 * \param hash hash value of the element (has to be equal to `C::hash(value)`)
+	 * \return `true` if element is in set
+	 */
+	template<typename U>
+	inline bool contains_hashed(const U& value, uint32_t hash) const {
+		assert(C::hash(value) == hash);
+		return empty() ? false : (find_in(bucket(hash), value) != Elements<T>::_next);
+	}
+
+	/*! \brief Prefetch the hash bucket for a hash value
+	 * Allows batch lookups to hide the memory latency, e.g., by prefetching
+	 * the bucket for the element `i + k` while looking up element `i`.
+	 * \param hash hash value of an element
+	 */
+	inline void prefetch(uint32_t hash) const {
+		if (_bucket != nullptr)
+			__builtin_prefetch(bucket(hash));
 	}
 
 
@@ -526,7 +722,7 @@ class HashSet : public Elements<T> {
 	 */
 	Optional<T> erase(const BaseIterator & position) {
 		if (position.i >= 1 && position.i < Elements<T>::_next && Elements<T>::_node[position.i].hash.active)
-			return Optional<T>{move(extract(position).data)};
+			return remove(position);
 		else
 			return Optional<T>{};
 	}
@@ -555,7 +751,7 @@ class HashSet : public Elements<T> {
 	inline Optional<T> erase(const U& value) {
 		auto position = find(value);
 		if (position.i >= 1 && position.i < Elements<T>::_next && Elements<T>::_node[position.i].hash.active)
-			return Optional<T>{move(extract(position).data)};
+			return remove(position);
 		else
 			return Optional<T>{};
 	}
@@ -593,18 +789,32 @@ class HashSet : public Elements<T> {
 
 		size_t old_capacity = Elements<T>::_capacity;
 		bool s = capacity == old_capacity;
-		// Resize element container
-		if (!s && Elements<T>::resize(capacity, buckets(capacity) * sizeof(uint32_t))) {
-			// Clean memory used for new elements (so .active is false)
-			if (capacity > old_capacity)
-				Memory::set(Elements<T>::_node + old_capacity, 0, (capacity - old_capacity) * sizeof(Node));
+		if (!s) {
+			// Separate hash bucket array in incremental mode
+			uint32_t * b = nullptr;
+			if (_incremental && (b = allocate(buckets(capacity))) == nullptr)
+				return false;
 
-			// NULL Element (let's waste it)
-			Elements<T>::_node[0].hash.active = false;
+			// Resize element container
+			if (Elements<T>::resize(capacity, _incremental ? 0 : buckets(capacity) * sizeof(uint32_t))) {
+				// Clean memory used for new elements (so .active is false)
+				if (capacity > old_capacity)
+					Memory::set(Elements<T>::_node + old_capacity, 0, (capacity - old_capacity) * sizeof(Node));
 
-			_bucket = reinterpret_cast<uint32_t *>(Elements<T>::reserved());
-			_bucket_capacity = buckets(capacity);
-			s = need_bucketize = true;
+				// NULL Element (let's waste it)
+				Elements<T>::_node[0].hash.active = false;
+
+				if (_incremental) {
+					release(_bucket);
+					_bucket = b;
+				} else {
+					_bucket = reinterpret_cast<uint32_t *>(Elements<T>::reserved());
+				}
+				_bucket_capacity = buckets(capacity);
+				s = need_bucketize = true;
+			} else {
+				release(b);
+			}
 		}
 
 		// Bucketize (if either reordering or resizing of hash buckets was successful)
@@ -614,6 +824,62 @@ class HashSet : public Elements<T> {
 		return s;
 	}
 
+	/*! \brief Enable or disable incremental mode
+	 * In incremental mode, growing the set does not rebuild all hash buckets at once:
+	 * The previous and the new hash bucket array coexist, and each subsequent
+	 * insert or (non-constant) find migrates a bounded number of buckets.
+	 * Erased node slots are reused instead of reorganizing the elements.
+	 * This avoids long stalls for single inserts into large sets,
+	 * at the cost of a separate allocation for the hash buckets.
+	 * \note Enabling reorganizes the elements, disabling completes a pending migration.
+	 * \param enable `true` to enable, `false` to disable incremental mode
+	 * \return `true` on success, `false` on error
+	 */
+	bool incremental(bool enable) {
+		if (enable == _incremental)
+			return true;
+
+		if (enable) {
+			reorganize();
+			if (_bucket != nullptr) {
+				uint32_t * b = allocate(_bucket_capacity);
+				if (b == nullptr)
+					return false;
+				Memory::copy(b, _bucket, _bucket_capacity * sizeof(uint32_t));
+				_bucket = b;
+			}
+		} else {
+			if (_old_bucket != nullptr)
+				migrate(true);
+			if (_bucket != nullptr) {
+				// Move hash buckets back into the reserved space of the elements
+				uint32_t * b = _bucket;
+				if (!Elements<T>::resize(Elements<T>::_capacity, _bucket_capacity * sizeof(uint32_t)))
+					return false;
+				_bucket = reinterpret_cast<uint32_t *>(Elements<T>::reserved());
+				Memory::copy(_bucket, b, _bucket_capacity * sizeof(uint32_t));
+				release(b);
+			}
+			_free = 0;
+		}
+		_incremental = enable;
+		return true;
+	}
+
+	/*! \brief Check if incremental mode is enabled
+	 * \return `true` if in incremental mode
+	 */
+	inline bool incremental() const {
+		return _incremental;
+	}
+
+	/*! \brief Check if an incremental migration of hash buckets is in progress
+	 * \return `true` if previous and new hash bucket array coexist
+	 */
+	inline bool migrating() const {
+		return _old_bucket != nullptr;
+	}
+
 	/*! \brief Test whether container is empty
 	 * \return true if set is empty
 	 */
@@ -633,9 +899,15 @@ class HashSet : public Elements<T> {
 	 */
 	size_t bucket_count() const {
 		size_t i = 0;
-		for (size_t c = 0; c < _bucket_capacity; c++)
-			if (_bucket[c] != 0)
-				i++;
+		// New hash bucket array might not be cleared yet during migration
+		if (_old_bucket == nullptr || _cleared == _bucket_capacity)
+			for (size_t c = 0; c < _bucket_capacity; c++)
+				if (_bucket[c] != 0)
+					i++;
+		if (_old_bucket != nullptr)
+			for (size_t c = _migrated; c < _old_bucket_capacity; c++)
+				if (_old_bucket[c] != 0)
+					i++;
 		return i;
 	}
 
@@ -649,6 +921,12 @@ class HashSet : public Elements<T> {
 	/*! \brief Clear all elements in set */
 	void clear() {
 		Elements<T>::clear();
+		Elements<T>::_next = 1;
+		_free = 0;
+		if (_old_bucket != nullptr) {
+			release(_old_bucket);
+			_old_bucket = nullptr;
+		}
 		if (_bucket != nullptr)
 			Memory::set(_bucket, 0, sizeof(uint32_t) * _bucket_capacity);
 	}
@@ -659,18 +937,21 @@ class HashSet : public Elements<T> {
 	 */
 	static uint32_t buckets(uint32_t capacity) {
 		auto b = capacity * L / 100ULL;
-		return b >= UINT32_MAX ? UINT32_MAX - 1 : static_cast<uint32_t>(b);
+		return R::size(b >= UINT32_MAX ? UINT32_MAX - 1 : static_cast<uint32_t>(b));
 	}
 
 	/*! \brief Increase capacity (by reordering or resizing) if required
 	 * \return `false` on error
 	 */
 	inline bool increase() {
+		migrate();
 		if (Elements<T>::_capacity == 0) {
 			if (!resize(16))
 				return false;
-		} else if (Elements<T>::_next >= Elements<T>::_capacity) {
-			if (Elements<T>::_count * 2 <= Elements<T>::_capacity)
+		} else if (_free == 0 && Elements<T>::_next >= Elements<T>::_capacity) {
+			if (_incremental)
+				return grow();
+			else if (Elements<T>::_count * 2 <= Elements<T>::_capacity)
 				reorganize();
 			else if (!resize(Elements<T>::_capacity * 2))
 				return false;
@@ -683,7 +964,137 @@ class HashSet : public Elements<T> {
 	 * \return pointer to bucket
 	 */
 	inline uint32_t * bucket(uint32_t h) const {
-		return _bucket + (h % _bucket_capacity);
+		// Buckets of the previous array are used until they have been migrated
+		if (_old_bucket != nullptr) {
+			uint32_t o = R::index(h, _old_bucket_capacity);
+			if (o >= _migrated)
+				return _old_bucket + o;
+		}
+		return _bucket + R::index(h, _bucket_capacity);
+	}
+
+	/*! \brief Allocate a separate hash bucket array (for incremental mode)
+	 * \param n number of buckets
+	 * \return pointer to (uninitialized) bucket array or `nullptr` on error
+	 */
+	uint32_t * allocate(uint32_t n) const {
+		const size_t size = n * sizeof(uint32_t);
+		return Elements<T>::_arena == nullptr ? Memory::alloc<uint32_t>(size) : Elements<T>::_arena->template alloc<uint32_t>(size);
+	}
+
+	/*! \brief Release a separate hash bucket array
+	 * \param b pointer to bucket array (or `nullptr`)
+	 */
+	void release(uint32_t * b) const {
+		if (b == nullptr)
+			return;
+		else if (Elements<T>::_arena == nullptr)
+			Memory::free(b);
+		else
+			Elements<T>::_arena->free(b);
+	}
+
+	/*! \brief Double capacity without rebuilding the hash buckets (incremental mode)
+	 * The new hash bucket array is cleared and filled by subsequent operations.
+	 * \return `false` on error
+	 */
+	bool grow() {
+		const size_t capacity = Elements<T>::_capacity * 2;
+		if (capacity > UINT32_MAX)
+			return false;
+
+		// Previous migration should have been finished by now
+		if (_old_bucket != nullptr)
+			migrate(true);
+
+		const uint32_t bucket_capacity = buckets(capacity);
+		uint32_t * b = allocate(bucket_capacity);
+		if (b == nullptr)
+			return false;
+
+		// New node slots are initialized on use (no need to clean them)
+		if (!Elements<T>::resize(capacity)) {
+			release(b);
+			return false;
+		}
+
+		_old_bucket = _bucket;
+		_old_bucket_capacity = _bucket_capacity;
+		_bucket = b;
+		_bucket_capacity = bucket_capacity;
+		_cleared = 0;
+		_migrated = 0;
+		return true;
+	}
+
+	/*! \brief Continue pending migration of hash buckets (if any)
+	 */
+	inline void migrate() {
+		if (_old_bucket != nullptr)
+			migrate(false);
+	}
+
+	/*! \brief Migrate hash buckets
+	 * First the new hash bucket array is cleared, then the nodes of the
+	 * previous buckets are moved into the new buckets.
+	 * \param complete finish migration (instead of a bounded number of buckets)
+	 */
+	void migrate(bool complete) {
+		assert(_old_bucket != nullptr);
+		if (_cleared < _bucket_capacity) {
+			uint32_t n = _bucket_capacity - _cleared;
+			if (!complete && n > CLEAR_BUCKETS)
+				n = CLEAR_BUCKETS;
+			Memory::set(_bucket + _cleared, 0, n * sizeof(uint32_t));
+			_cleared += n;
+			if (!complete)
+				return;
+		}
+
+		for (uint32_t m = 0; _migrated < _old_bucket_capacity && (complete || m < MIGRATE_BUCKETS); m++)
+			for (uint32_t i = _old_bucket[_migrated++]; i != 0; ) {
+				assert(Elements<T>::_node[i].hash.active);
+				uint32_t next = Elements<T>::_node[i].hash.next;
+				link(i, bucket(Elements<T>::_node[i].hash.temp));
+				i = next;
+			}
+
+		if (_migrated >= _old_bucket_capacity) {
+			release(_old_bucket);
+			_old_bucket = nullptr;
+		}
+	}
+
+	/*! \brief Get slot for the next new element
+	 * \return index of a free (erased) slot or `Elements<T>::_next`
+	 */
+	inline uint32_t slot() const {
+		return _free != 0 ? _free : Elements<T>::_next;
+	}
+
+	/*! \brief Take slot for the next new element (as returned by `slot()`)
+	 * \return index of the slot
+	 */
+	inline uint32_t take() {
+		if (_free == 0)
+			return Elements<T>::_next++;
+		uint32_t n = _free;
+		_free = Elements<T>::_node[n].hash.next;
+		return n;
+	}
+
+	/*! \brief Remove element
+	 * \param position iterator to element (must be valid)
+	 * \return removed value
+	 */
+	Optional<T> remove(const BaseIterator & position) {
+		Optional<T> r{move(extract(position).data)};
+		// Keep node slot for reuse (instead of reorganizing)
+		if (_incremental) {
+			Elements<T>::_node[position.i].hash.next = _free;
+			_free = position.i;
+		}
+		return r;
 	}
 
 	/*! \brief Reorder elements
@@ -703,6 +1114,7 @@ class HashSet : public Elements<T> {
 				}
 			}
 			Elements<T>::_next = Elements<T>::_count + 1;
+			_free = 0;
 
 			return true;
 		} else {
@@ -715,6 +1127,12 @@ class HashSet : public Elements<T> {
 	 * \param rehash calculate hash value (replacing cached value)
 	 */
 	void bucketize(bool rehash = false) {
+		// Abort pending migration
+		if (_old_bucket != nullptr) {
+			release(_old_bucket);
+			_old_bucket = nullptr;
+		}
+
 		Memory::set(_bucket, 0, _bucket_capacity * sizeof(uint32_t));
 
 		if (Elements<T>::_count > 0) {
@@ -724,14 +1142,7 @@ class HashSet : public Elements<T> {
 					if (rehash)
 						Elements<T>::_node[i].hash.temp = C::hash(Elements<T>::_node[i].data);
 
-					uint32_t * b = bucket(Elements<T>::_node[i].hash.temp);
-					Elements<T>::_node[i].hash.prev = 0;
-					if ((Elements<T>::_node[i].hash.next = *b) != 0) {
-						assert(Elements<T>::_node[*b].hash.active);
-						assert(Elements<T>::_node[*b].hash.prev == 0);
-						Elements<T>::_node[*b].hash.prev = i;
-					}
-					*b = i;
+					link(i, bucket(Elements<T>::_node[i].hash.temp));
 					if (++c >= Elements<T>::_count)
 						break;
 				}
@@ -739,6 +1150,26 @@ class HashSet : public Elements<T> {
 		}
 	}
 
+	/*! \brief Insert element constructed in the next slot (helper)
+	 * \param h hash value of the element
+	 * \return iterator to the inserted element (`first`) and
+	 *         indicator (`second`) if element was created (`true`) or has already been in the set (`false`)
+	 */
+	inline Pair<Iterator, bool> emplace_staged(uint32_t h) {
+		auto & next = Elements<T>::_node[slot()];
+		uint32_t * b = bucket(next.hash.temp = h);
+
+		// Check if already in set
+		uint32_t i = find_in(b, next.data);
+		if (i != Elements<T>::_next) {
+			next.data.~T();
+			return Pair<Iterator, bool>{Iterator(*this, i), false};
+		}
+
+		// Insert
+		return insert(take(), b);
+	}
+
 	/*! \brief Find value in bucket (helper)
 	 * \param bucket bucket determined by value hash
 	 * \param value the value we are looking for
@@ -765,9 +1196,19 @@ class HashSet : public Elements<T> {
 	 */
 	inline Pair<Iterator, bool> insert(uint32_t element, uint32_t * b) {
 		Elements<T>::_node[element].hash.active = true;
-		Elements<T>::_node[element].hash.prev = 0;
-
 		Elements<T>::_count++;
+		link(element, b);
+
+		// return Iterator
+		return Pair<Iterator, bool>{Iterator(*this, element), true};
+	}
+
+	/*! \brief Link element as head of bucket (helper)
+	 * \param element index of (active) element
+	 * \param b pointer to target bucket
+	 */
+	inline void link(uint32_t element, uint32_t * b) {
+		Elements<T>::_node[element].hash.prev = 0;
 
 		// Bucket not empty?
 		if ((Elements<T>::_node[element].hash.next = *b) != 0) {
@@ -778,9 +1219,6 @@ class HashSet : public Elements<T> {
 
 		// Assign bucket
 		*b = element;
-
-		// return Iterator
-		return Pair<Iterator, bool>{Iterator(*this, element), true};
 	}
 };
 
@@ -791,10 +1229,11 @@ class HashSet : public Elements<T> {
  * \tparam C structure with comparison (`bool equal(const K&, const K&)`)
  *           and hash (`uint32_t hash(const K&)`) functions
  * \tparam L percentage of hash buckets (compared to element capacity)
+ * \tparam R policy to reduce hash values to bucket indices (see \ref HashBucket)
  */
-template<typename K, typename V, typename C = Comparison, size_t L = 150>
-class HashMap : protected HashSet<KeyValue<K, V>, C, L> {
-	using Base = HashSet<KeyValue<K, V>, C, L>;
+template<typename K, typename V, typename C = Comparison, size_t L = 150, typename R = HashBucket::Fibonacci>
+class HashMap : protected HashSet<KeyValue<K, V>, C, L, R> {
+	using Base = HashSet<KeyValue<K, V>, C, L, R>;
 	using typename Base::BaseIterator;
 
  public:
@@ -807,15 +1246,31 @@ class HashMap : protected HashSet<KeyValue<K, V>, C, L> {
 	using Base::rbegin;
 	using Base::rend;
 	using Base::find;
+	using Base::find_hashed;
 	using Base::contains;
+	using Base::contains_hashed;
+	using Base::prefetch;
 	using Base::resize;
 	using Base::rehash;
+	using Base::incremental;
+	using Base::migrating;
 	using Base::empty;
 	using Base::size;
 	using Base::bucket_size;
 	using Base::bucket_count;
 	using Base::clear;
 
+	/*! \brief Create new hash map
+	 * \param capacity initial capacity
+	 */
+	explicit HashMap(size_t capacity = 0) : Base(capacity) {}
+
+	/*! \brief Create new hash map in an arena
+	 * \param arena arena to allocate elements from
+	 * \param capacity initial capacity
+	 */
+	explicit HashMap(Memory::Arena & arena, size_t capacity = 0) : Base(arena, capacity) {}
+
 	/*! \brief Insert element */
 	inline Pair<Iterator, bool> insert(const K& key, const V& value) {
 		return Base::emplace(key, value);
@@ -825,6 +1280,19 @@ class HashMap : protected HashSet<KeyValue<K, V>, C, L> {
 		return Base::emplace(move(key), move(value));
 	}
 
+	/*! \brief Insert element with precomputed hash value of the key
+	 * \param key key
+	 * \param value value
+	 * \param hash hash value of the key (has to be equal to `C::hash(key)`)
+	 */
+	inline Pair<Iterator, bool> insert_hashed(const K& key, const V& value, uint32_t hash) {
+		return Base::emplace_hashed(hash, key, value);
+	}
+
+	inline Pair<Iterator, bool> insert_hashed(K&& key, V&& value, uint32_t hash) {
+		return Base::emplace_hashed(hash, move(key), move(value));
+	}
+
 	inline Optional<V> erase(const BaseIterator & position) {
 		auto i = Base::erase(position);
 		if (i)
@@ -894,8 +1362,8 @@ class HashMap : protected HashSet<KeyValue<K, V>, C, L> {
  *  \param set HashSet to be printed
  *  \return Reference to Stream; allows operator chaining.
  */
-template<typename S, typename T, typename C, size_t L>
-static inline S & operator<<(S & s, const HashSet<T, C, L> & set) {
+template<typename S, typename T, typename C, size_t L, typename R>
+static inline S & operator<<(S & s, const HashSet<T, C, L, R> & set) {
 	s << '{';
 	bool p = false;
 	for (const auto & entry : set) {
@@ -915,8 +1383,8 @@ static inline S & operator<<(S & s, const HashSet<T, C, L> & set) {
  *  \param set HashMap to be printed
  *  \return Reference to Stream; allows operator chaining.
  */
-template<typename S, typename K, typename V, typename C, size_t L>
-static inline S & operator<<(S & s, const HashMap<K, V, C, L> & map) {
+template<typename S, typename K, typename V, typename C, size_t L, typename R>
+static inline S & operator<<(S & s, const HashMap<K, V, C, L, R> & map) {
 	s << '{';
 	bool p = false;
 	for (const auto & entry : map) {
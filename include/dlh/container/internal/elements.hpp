@@ -5,6 +5,7 @@
 #pragma once
 
 #include <dlh/mem.hpp>
+#include <dlh/arena.hpp>
 #include <dlh/types.hpp>
 #include <dlh/assert.hpp>
 #include <dlh/utility.hpp>
@@ -54,16 +55,20 @@ struct Elements {
 	} * _node;
 	static_assert(sizeof(Node) == 16 + sizeof(T), "Wrong Node size");
 
+	/*! \brief Arena for the nodes (or `nullptr` to use the heap)
+	 */
+	Memory::Arena * _arena;
+
 	/*! \brief Constructor (empty) element container
-	 * \param e Element container to copy
+	 * \param arena Arena to allocate nodes from (or `nullptr` to use the heap)
 	 */
-	constexpr Elements() : _capacity(0), _next(1), _count(0), _node(nullptr) {}
+	constexpr explicit Elements(Memory::Arena * arena = nullptr) : _capacity(0), _next(1), _count(0), _node(nullptr), _arena(arena) {}
 
 	/*! \brief Copy constructor
 	 * \param reserve additional space to reserve
 	 * \param e Element container to copy
 	 */
-	Elements(const Elements<T>& e, size_t reserve = 0) : _capacity(e._capacity), _next(e._next), _count(e._count), _node(nullptr) {
+	Elements(const Elements<T>& e, size_t reserve = 0) : _capacity(e._capacity), _next(e._next), _count(e._count), _node(nullptr), _arena(nullptr) {
 		if (e._capacity > 0) {
 			auto s = e._capacity * sizeof(Node);
 			_node = Memory::alloc<Node>(s + reserve);
@@ -79,7 +84,7 @@ struct Elements {
 
 	/*! \brief Default move constructor
 	 */
-	Elements(Elements<T> && e) : _capacity(e._capacity), _next(e._next), _count(e._count), _node(e._node) {
+	Elements(Elements<T> && e) : _capacity(e._capacity), _next(e._next), _count(e._count), _node(e._node), _arena(e._arena) {
 		e._capacity = 0;
 		e._next = 1;
 		e._count = 0;
@@ -90,17 +95,23 @@ struct Elements {
 	 */
 	virtual ~Elements() {
 		clear();
-		if (_node != nullptr)
+		if (_node == nullptr)
+			return;
+		else if (_arena == nullptr)
 			Memory::free(_node);
+		else
+			_arena->free(_node);
 	}
 
 	/*! \brief Resize element slots to capacity
 	 * \param capacity the new capacity
 	 * \param reserve additional space to reserve
 	 * \return `true` on success, `false` on error
+	 * \note The contents of the reserved space are not preserved when using an arena
 	 */
 	bool resize(uint32_t capacity, size_t reserve = 0) {
-		auto ptr = Memory::realloc(_node, capacity * sizeof(Node) + reserve);
+		auto ptr = _arena == nullptr ? Memory::realloc(_node, capacity * sizeof(Node) + reserve)
+		                             : _arena->realloc(_node, _capacity * sizeof(Node), capacity * sizeof(Node) + reserve);
 		if (ptr == nullptr) {
 			return false;
 		} else {
@@ -4,15 +4,20 @@
 
 #pragma once
 
+#include <dlh/pool.hpp>
 #include <dlh/assert.hpp>
 #include <dlh/utility.hpp>
 
 /*! \brief Generic linked list node
  * influenced by standard [template/cxx] librarys `list`
+ * Nodes are allocated from a pool.
  * \tparam T type for payload
  */
 template<typename T>
-struct ListNode : public T {
+struct ListNode : public T, public Pooled<ListNode<T>> {
+	using Pooled<ListNode<T>>::operator new;
+	using Pooled<ListNode<T>>::operator delete;
+
 	ListNode * _prev;
 	ListNode * _next;
 
@@ -26,7 +31,7 @@ struct ListNode : public T {
 	template <class... ARGS>
 	explicit ListNode(ARGS&&... args) : T(forward<ARGS>(args)...), _prev(nullptr), _next(nullptr) {}
 
-	virtual ~ListNode() {}
+	~ListNode() {}
 };
 
 /*! \brief Linked list
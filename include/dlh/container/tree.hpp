@@ -109,6 +109,16 @@ class TreeSet : public Elements<T> {
 		assert(empty() || !Elements<T>::_node[0].tree.active);
 	}
 
+	/*! \brief Create new balanced binary search tree in an arena
+	 * \param arena arena to allocate elements from
+	 * \param capacity initial capacity
+	 */
+	explicit TreeSet(Memory::Arena & arena, size_t capacity = 0) : Elements<T>(&arena) {
+		if (capacity > 0)
+			resize(capacity + 1);
+		assert(empty() || !Elements<T>::_node[0].tree.active);
+	}
+
 	/*! \brief Copy constructor for a binary search tree from a tree set
 	 * \param other Tree Set
 	 */
@@ -1198,6 +1208,17 @@ class TreeMap : protected TreeSet<KeyValue<K, V>, C> {
 	using Base::check;
 #endif
 
+	/*! \brief Create new tree map
+	 * \param capacity initial capacity
+	 */
+	explicit TreeMap(size_t capacity = 0) : Base(capacity) {}
+
+	/*! \brief Create new tree map in an arena
+	 * \param arena arena to allocate elements from
+	 * \param capacity initial capacity
+	 */
+	explicit TreeMap(Memory::Arena & arena, size_t capacity = 0) : Base(arena, capacity) {}
+
 	inline Pair<Iterator, bool> insert(const K& key, const V& value) {
 		return Base::emplace(key, value);
 	}
@@ -7,6 +7,7 @@
 #pragma once
 
 #include <dlh/mem.hpp>
+#include <dlh/arena.hpp>
 #include <dlh/assert.hpp>
 #include <dlh/types.hpp>
 #include <dlh/utility.hpp>
@@ -29,6 +30,19 @@ template<class T> class Vector {
 	 */
 	int32_t _capacity = 0;
 
+	/*! \brief Arena for the entries (or `nullptr` to use the heap)
+	 */
+	Memory::Arena * _arena = nullptr;
+
+	/*! \brief Release entry array
+	 */
+	inline void deallocate() {
+		if (_arena == nullptr)
+			Memory::free(_element);
+		else
+			_arena->free(_element);
+	}
+
 	/*! \brief Expand capacity
 	 */
 	inline void expand() {
@@ -119,6 +133,14 @@ template<class T> class Vector {
 		}
 	}
 
+	/*! \brief Constructor for vector in an arena
+	 * \param arena arena to allocate entries from
+	 * \param capacity number of initial values
+	 */
+	explicit Vector(Memory::Arena & arena, size_t capacity = 0) : _arena(&arena) {
+		reserve(capacity);
+	}
+
 	/*! \brief Range constructor
 	 * \param first First element in range
 	 * \param last Last element in range
@@ -166,6 +188,7 @@ template<class T> class Vector {
 		other._size = 0;
 		_capacity = other._capacity;
 		other._capacity = 0;
+		_arena = other._arena;
 	}
 
 
@@ -173,7 +196,7 @@ template<class T> class Vector {
 	 */
 	~Vector() {
 		resize(0);
-		Memory::free(_element);
+		deallocate();
 	}
 
 	/*! \brief Vector iterator
@@ -398,7 +421,10 @@ template<class T> class Vector {
 	inline void reserve(size_t capacity) {
 		int32_t c = capacity < INT32_MAX ? static_cast<int32_t>(capacity) : (INT32_MAX - 1);
 		if (c > _capacity) {
-			_element = Memory::realloc(_element, c * sizeof(T));
+			if (_arena == nullptr)
+				_element = Memory::realloc(_element, c * sizeof(T));
+			else
+				_element = _arena->realloc(_element, _capacity * sizeof(T), c * sizeof(T));
 			_capacity = c;
 		}
 	}
@@ -758,13 +784,14 @@ template<class T> class Vector {
 	 */
 	Vector<T>& operator=(Vector<T>&& other) {
 		resize(0);
-		Memory::free(_element);
+		deallocate();
 		_element = other._element;
 		other._element = nullptr;
 		_size = other._size;
 		other._size = 0;
 		_capacity = other._capacity;
 		other._capacity = 0;
+		_arena = other._arena;
 		return *this;
 	}
 
@@ -0,0 +1,172 @@
+// Dirty Little Helper (DLH) - system support library for C/C++
+// Copyright 2021-2023 by Bernhard Heinloth <heinloth@cs.fau.de>
+// SPDX-License-Identifier: AGPL-3.0-or-later
+
+/*! \file
+ *  \brief \ref Cpu "Processor" feature detection and runtime dispatch of kernels
+ */
+
+#pragma once
+
+#include <dlh/types.hpp>
+
+/*! \brief Processor features (x86_64)
+ *
+ * Features are detected once during startup (using `cpuid`, the extended
+ * control register `XCR0` and the auxiliary vector), allowing kernels to
+ * select the best implementation for the machine at runtime via \ref Dispatch.
+ * Features can be disabled using the environment variable `DLH_CPU_DISABLE`
+ * with a comma separated list of \ref name "names" (e.g. `avx2,erms`).
+ */
+namespace Cpu {
+
+/*! \brief Instruction set extensions */
+enum Feature : uint32_t {
+	SSE2     = 1U << 0,   ///< SSE2 (always available on x86_64)
+	SSE3     = 1U << 1,   ///< SSE3
+	SSSE3    = 1U << 2,   ///< Supplemental SSE3
+	SSE4_1   = 1U << 3,   ///< SSE 4.1
+	SSE4_2   = 1U << 4,   ///< SSE 4.2
+	POPCNT   = 1U << 5,   ///< Population count instruction
+	AES      = 1U << 6,   ///< AES instructions
+	AVX      = 1U << 7,   ///< AVX (supported by CPU and enabled by OS)
+	AVX2     = 1U << 8,   ///< AVX2 (supported by CPU and enabled by OS)
+	BMI1     = 1U << 9,   ///< Bit manipulation instructions
+	BMI2     = 1U << 10,  ///< Bit manipulation instructions 2
+	ERMS     = 1U << 11,  ///< Enhanced `rep movsb` / `rep stosb`
+	FSRM     = 1U << 12,  ///< Fast short `rep movsb`
+	AVX512F  = 1U << 13,  ///< AVX-512 foundation (supported by CPU and enabled by OS)
+	AVX512BW = 1U << 14,  ///< AVX-512 byte and word instructions
+};
+
+/*! \brief Detect processor features and caches
+ * \note Called during startup, hence there is usually no need to call it manually
+ */
+void init();
+
+/*! \brief Check if the features have been detected
+ * \return `false` if \ref init was not able to run yet (before startup),
+ *         \ref features then only reports the baseline (SSE2)
+ */
+bool initialized();
+
+/*! \brief Supported (and not \ref disable "disabled") features
+ * \return bit mask of \ref Feature
+ */
+uint32_t features();
+
+/*! \brief Check if features are available
+ * \param mask bit mask of \ref Feature
+ * \return `true` if all features in the mask are available
+ */
+inline bool has(uint32_t mask) {
+	return (features() & mask) == mask;
+}
+
+/*! \brief Disable features
+ * Kernels resolved afterwards will not use them (e.g. to test fallbacks).
+ * \param mask bit mask of \ref Feature
+ */
+void disable(uint32_t mask);
+
+/*! \brief Name of a feature
+ * \param feature single feature
+ * \return name (lower case, as in `/proc/cpuinfo`) or `nullptr` if invalid
+ */
+const char * name(Feature feature);
+
+/*! \brief Processor vendor
+ * \return identification string (e.g. `GenuineIntel` or `AuthenticAMD`)
+ */
+const char * vendor();
+
+/*! \brief Hardware capabilities provided by kernel
+ * \return value of `AT_HWCAP` from auxiliary vector (`cpuid` leaf 1 `edx` on x86_64)
+ */
+unsigned long hwcap();
+
+/*! \brief Additional hardware capabilities provided by kernel
+ * \return value of `AT_HWCAP2` from auxiliary vector
+ */
+unsigned long hwcap2();
+
+/*! \brief Size of a cache line
+ * \return line size of first level data cache in bytes
+ */
+size_t cache_line();
+
+/*! \brief Size of a data (or unified) cache
+ * \param level cache level (1 - 3)
+ * \return size in bytes or `0` if not available
+ */
+size_t cache_size(unsigned level);
+
+/*! \brief Function pointer resolved at first call
+ *
+ * Similar to `IFUNC` symbols: The resolver selects the implementation
+ * (usually depending on \ref has) on the first call, all further calls are
+ * redirected to the selected function.
+ * Implementations resolved before the features are detected (e.g. prior to
+ * the startup code) are not kept but resolved again on the next call.
+ * Since the constructor is `constexpr`, objects with static storage duration
+ * are initialized at compile time and can be used before any constructor runs.
+ *
+ * \tparam F function type
+ */
+template<typename F>
+class Dispatch;
+
+template<typename R, typename... ARGS>
+class Dispatch<R(ARGS...)> {
+ public:
+	/*! \brief Implementation */
+	typedef R (*Function)(ARGS...);
+
+	/*! \brief Resolver selecting the implementation */
+	typedef Function (*Resolver)();
+
+ private:
+	/*! \brief Selected function (or `nullptr` if not resolved yet) */
+	Function _function = nullptr;
+
+	/*! \brief Resolver */
+	const Resolver _resolver;
+
+ public:
+	/*! \brief Create dispatcher
+	 * \param resolver function returning the implementation to use
+	 */
+	constexpr explicit Dispatch(Resolver resolver) : _resolver(resolver) {}
+
+	Dispatch(const Dispatch &) = delete;
+	Dispatch & operator=(const Dispatch &) = delete;
+
+	/*! \brief Selected implementation (resolve if required)
+	 * \return function pointer
+	 */
+	inline Function get() {
+		Function function = __atomic_load_n(&_function, __ATOMIC_RELAXED);
+		if (__builtin_expect(function == nullptr, 0)) {
+			function = _resolver();
+			if (initialized())
+				__atomic_store_n(&_function, function, __ATOMIC_RELAXED);
+		}
+		return function;
+	}
+
+	/*! \brief Call selected implementation
+	 * \param args arguments
+	 * \return return value of implementation
+	 */
+	inline R operator()(ARGS... args) {
+		return get()(args...);
+	}
+
+	/*! \brief Resolve again on next call (e.g. after \ref disable)
+	 */
+	void reset() {
+		__atomic_store_n(&_function, nullptr, __ATOMIC_RELAXED);
+	}
+};
+
+}  // namespace Cpu
@@ -4,8 +4,10 @@
 
 #pragma once
 
+#include <dlh/container/optional.hpp>
 #include <dlh/container/pair.hpp>
 #include <dlh/container/vector.hpp>
+#include <dlh/xxhash.hpp>
 
 namespace File {
 
@@ -73,6 +75,13 @@ size_t set(const char * path, const char * data, bool append = false);
 
 Vector<const char *> lines(const char * path);
 
+/*! \brief Tree hash of the file contents (see \ref Hash::parallel)
+ * \param path path to file
+ * \param threads number of threads to use (`0` for all available processors)
+ * \return 128 bit tree hash (or empty if the file could not be read)
+ */
+Optional<XXHash3::Hash128> hash(const char * path, unsigned threads = 0);
+
 bool absolute(int fd, char * __restrict__ buffer, size_t bufferlen, size_t & pathlen);
 inline bool absolute(int fd, char * __restrict__ buffer, size_t bufferlen) {
 	size_t pathlen;
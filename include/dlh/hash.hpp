@@ -0,0 +1,38 @@
+// Dirty Little Helper (DLH) - system support library for C/C++
+// Copyright 2021-2023 by Bernhard Heinloth <heinloth@cs.fau.de>
+// SPDX-License-Identifier: AGPL-3.0-or-later
+
+#pragma once
+
+#include <dlh/types.hpp>
+#include <dlh/xxhash.hpp>
+
+/*! \brief Hashing of large inputs on several threads
+ *
+ * The result is a two level tree hash (independent of the number of threads):
+ *  1. The input is split into chunks of \ref ChunkSize bytes (the last
+ *     chunk may be shorter, an empty input has no chunks).
+ *  2. The `i`-th chunk is hashed using 128 bit XXH3 with seed `i`.
+ *  3. The digests of all chunks are concatenated (16 bytes each, lower
+ *     64 bit first, both in little endian) and hashed using 128 bit XXH3
+ *     with the length of the input (in bytes) as seed.
+ */
+namespace Hash {
+
+/*! \brief Size of the chunks (part of the hash format) */
+const size_t ChunkSize = 1UL << 20;
+
+/*! \brief Number of processors available for this process
+ * \return number of processors in the affinity mask (at least 1)
+ */
+unsigned processors();
+
+/*! \brief Tree hash of a continuous block of data
+ * \param buffer input data
+ * \param length number of bytes
+ * \param threads number of threads to use (`0` for all available processors)
+ * \return 128 bit tree hash
+ */
+XXHash3::Hash128 parallel(const void * buffer, size_t length, unsigned threads = 0);
+
+}  // namespace Hash
@@ -22,6 +22,34 @@ inline T* alloc(size_t size) {
 	return reinterpret_cast<T*>(alloc(size));
 }
 
+/*! \brief Allocate an aligned memory block
+ * The memory is not initialized and can be released using \ref free().
+ *
+ * \param size Requested size of memory in bytes.
+ * \param alignment Alignment of the memory, has to be a power of two.
+ * \return Address of memory or `0` on error (no memory available, invalid
+ *         alignment) or if size was zero.
+ * \note In legacy mode, the alignment is limited to 16 KiB
+ */
+uintptr_t alloc_aligned(size_t size, size_t alignment);
+
+template<typename T>
+inline T* alloc_aligned(size_t size, size_t alignment = alignof(T)) {
+	return reinterpret_cast<T*>(alloc_aligned(size, alignment));
+}
+
+/*! \brief Get the usable size of an allocated memory block
+ *
+ * \param addr Address of an previously allocated memory block.
+ * \return Number of usable bytes (at least the requested size)
+ */
+size_t size(uintptr_t addr);
+
+template<typename T>
+inline size_t size(T* addr) {
+	return size(reinterpret_cast<uintptr_t>(addr));
+}
+
 /*! \brief Free an allocated memory block
  *
  * \param addr Address of an previously allocated memory block.
@@ -66,6 +94,151 @@ inline T* alloc_array(size_t nmemb) {
 	return reinterpret_cast<T*>(alloc_array(nmemb, sizeof(T)));
 }
 
+/*! \brief Allocator statistics
+ * Allocations are grouped in size classes using the binary logarithm of their
+ * (usable) size rounded up, i.e., class `n` contains sizes in (2^(n-1), 2^n].
+ */
+struct Statistics {
+	/*! \brief Number of size classes */
+	static const size_t CLASSES = 8 * sizeof(size_t);
+
+	/*! \brief Number of allocations per size class */
+	size_t allocations[CLASSES];
+
+	/*! \brief Number of frees per size class */
+	size_t frees[CLASSES];
+
+	/*! \brief Bytes currently in use (usable size of all allocations) */
+	size_t used;
+
+	/*! \brief Number of allocations using mmap (for large sizes) */
+	size_t mmap;
+
+	/*! \brief Number of resized allocations using mremap */
+	size_t mremap;
+
+	/*! \brief Number of freed allocations using munmap */
+	size_t munmap;
+
+	/*! \brief Bytes currently mapped for large allocations */
+	size_t mapped;
+
+	/*! \brief Bytes in cached mappings of freed large allocations */
+	size_t map_cached;
+
+	/*! \brief Number of large allocations reusing a cached mapping */
+	size_t map_cache_hits;
+
+	/*! \brief Peak of bytes mapped by the allocator (heap and large allocations) */
+	size_t peak;
+
+	/*! \brief Bytes reserved for the heap */
+	size_t heap_reserved;
+
+	/*! \brief Size of the address space covered by the heaps (buddy) tree */
+	size_t heap_size;
+
+	/*! \brief Number of free heap blocks per size class */
+	size_t heap_free_blocks[CLASSES];
+
+	/*! \brief Bytes in free heap blocks */
+	size_t heap_free;
+
+	/*! \brief Size of the largest free heap block */
+	size_t heap_free_largest;
+
+	/*! \brief Number of pages used for small objects (slabs) */
+	size_t slab_pages;
+
+	/*! \brief Bytes of free heap memory released to the kernel (accumulated) */
+	size_t trimmed;
+
+	/*! \brief Fragmentation of the heap
+	 * \return percentage of free heap memory not available in the largest free block
+	 */
+	unsigned fragmentation() const {
+		return heap_free == 0 ? 0 : static_cast<unsigned>(100 - heap_free_largest * 100 / heap_free);
+	}
+};
+
+/*! \brief Get a snapshot of the allocator statistics
+ * \note Counters of other threads using per-thread caches are merged in
+ *       batches and therefore might be slightly behind.
+ * \return statistics
+ */
+Statistics stats();
+
+/*! \brief Print allocator statistics to log (with level `INFO`)
+ */
+void log_stats();
+
+/*! \brief Huge page modes for heap and large allocations
+ */
+enum HugePages {
+	HUGE_PAGES_DISABLED = 0,     ///< Use regular pages only
+	HUGE_PAGES_TRANSPARENT = 1,  ///< Align regions to huge pages and request transparent huge pages (`MADV_HUGEPAGE`)
+	HUGE_PAGES_EXPLICIT = 2,     ///< Use explicit huge pages (`MAP_HUGETLB`) for large allocations, fall back to transparent huge pages
+};
+
+/*! \brief Back memory with huge pages to reduce TLB misses
+ * Heap regions are reserved in chunks of the huge page size and advised to use
+ * transparent huge pages (the already mapped heap is advised as well), large
+ * allocations (using `mmap`) of at least the huge page size are aligned to it.
+ * The default mode can be set at build time using the `HUGE_PAGES` macro.
+ *
+ * \param mode huge page mode
+ * \note The heap is not affected in legacy mode (program break)
+ */
+void huge_pages(HugePages mode);
+
+/*! \brief Release unused pages of free heap memory to the kernel
+ * The pages of free blocks are advised as not needed (`madvise`), which
+ * reduces the resident memory while keeping the address space reserved.
+ * Cached mappings of freed large allocations are unmapped.
+ *
+ * \return number of bytes released
+ */
+size_t trim();
+
+/*! \brief Set threshold for automatic trim
+ * Free heap memory is automatically released to the kernel if both the
+ * memory freed since the last trim and the total free heap memory exceed
+ * this threshold.
+ *
+ * \param bytes threshold in bytes or `0` to disable automatic trim
+ */
+void trim_threshold(size_t bytes);
+
+/*! \brief Configure the cache for mappings of large allocations
+ * Instead of unmapping freed large allocations (using `mmap`), their mappings
+ * are kept in a cache (grouped by size class) for reuse by subsequent large
+ * allocations, which avoids page faults and TLB shootdowns.
+ * If a limit is exceeded, the least recently cached mappings are unmapped.
+ * The defaults can be set at build time using the `MAP_CACHE_*` macros.
+ *
+ * \param limit maximum total size of cached mappings in bytes (`0` disables the cache)
+ * \param max_size maximum size of a single cached mapping in bytes
+ * \param release advise kernel that the pages of cached mappings are not needed (`MADV_FREE`)
+ * \note Has no effect in legacy mode (no mappings are used for large allocations)
+ */
+void map_cache(size_t limit, size_t max_size, bool release = false);
+
+/*! \brief Use per-thread caches for small allocations
+ * Freed blocks are kept in a cache of the current thread (anchored in its
+ * thread control block) and exchanged in batches with the global allocator,
+ * hence most allocations do not require the global allocator lock.
+ *
+ * \param enable `true` to use per-thread caches
+ * \note Requires a valid thread control block (`Thread::self()`) in every
+ *       thread using the allocator.
+ */
+void thread_cache(bool enable);
+
+/*! \brief Return all cached blocks of the current thread to the global allocator
+ * Called on `Thread::exit`.
+ */
+void thread_cache_release();
+
 /*! \brief Copy a memory area
  * \ingroup string
  * \param dest destination buffer
@@ -74,16 +247,7 @@ inline T* alloc_array(size_t nmemb) {
  * \return Address of destination
  * \note The memory must not overlap!
  */
-inline uintptr_t copy(uintptr_t dest, uintptr_t src, size_t size) {
-	unsigned char * __restrict__ destination = reinterpret_cast<unsigned char*>(dest);
-	unsigned char const * __restrict__ source = reinterpret_cast<unsigned char const*>(src);
-
-	for(size_t i = 0; i != size; ++i) {
-		destination[i] = source[i];
-	}
-
-	return dest;
-}
+uintptr_t copy(uintptr_t dest, uintptr_t src, size_t size);
 
 /*! \brief Copy a memory area
  * \ingroup string
@@ -106,20 +270,7 @@ inline T* copy(T * __restrict__ dest, U const * __restrict__ src, size_t size) {
  * \param size number of bytes to copy
  * \return Address of destination
  */
-inline uintptr_t move(uintptr_t dest, uintptr_t src, size_t size) {
-	unsigned char * __restrict__ destination = reinterpret_cast<unsigned char*>(dest);
-	unsigned char const * __restrict__ source = reinterpret_cast<unsigned char const*>(src);
-
-	if(source > destination) {
-		for(size_t i = 0; i != size; ++i)
-			destination[i] = source[i];
-	} else {
-		for(size_t i = size; i != 0; --i)
-			destination[i-1] = source[i-1];
-	}
-
-	return dest;
-}
+uintptr_t move(uintptr_t dest, uintptr_t src, size_t size);
 
 /*! \brief Copy a memory area
  * while the source may overlap with the destination
@@ -141,15 +292,7 @@ inline T* move(T * dest, U const * src, size_t size) {
  * \param size number of bytes to fill with pattern
  * \return address of destination
  */
-inline uintptr_t set(uintptr_t dest, int pattern, size_t size) {
-	unsigned char *destination = reinterpret_cast<unsigned char*>(dest);
-
-	for(size_t i = 0; i != size; ++i) {
-		destination[i] = static_cast<unsigned char>(pattern);
-	}
-
-	return dest;
-}
+uintptr_t set(uintptr_t dest, int pattern, size_t size);
 
 /*! \brief Fill a memory area with a pattern
  * \ingroup string
@@ -163,6 +306,67 @@ inline T* set(T* dest, int pattern, size_t size) {
 	return reinterpret_cast<T*>(set(reinterpret_cast<uintptr_t>(dest), pattern, size));
 }
 
+/*! \brief Copy a memory area using non-temporal stores
+ * The destination is written bypassing the caches (and the source is
+ * prefetched), which avoids evicting the working set when copying areas
+ * larger than the last level cache.
+ * \ref copy does this automatically for areas exceeding the \ref stream_threshold.
+ * \ingroup string
+ * \param dest destination buffer
+ * \param src source buffer
+ * \param size number of bytes to copy
+ * \return Address of destination
+ * \note The memory must not overlap!
+ */
+uintptr_t stream_copy(uintptr_t dest, uintptr_t src, size_t size);
+
+/*! \brief Copy a memory area using non-temporal stores
+ * \ingroup string
+ * \param dest destination buffer
+ * \param src source buffer
+ * \param size number of bytes to copy
+ * \return pointer to destination
+ * \note The memory must not overlap!
+ */
+template<typename T, typename U>
+inline T* stream_copy(T * __restrict__ dest, U const * __restrict__ src, size_t size) {
+	return reinterpret_cast<T*>(stream_copy(reinterpret_cast<uintptr_t>(dest), reinterpret_cast<uintptr_t>(src), size));
+}
+
+/*! \brief Fill a memory area with a pattern using non-temporal stores
+ * The destination is written bypassing the caches,
+ * \ref set does this automatically for areas exceeding the \ref stream_threshold.
+ * \ingroup string
+ * \param dest destination buffer
+ * \param pattern single byte pattern
+ * \param size number of bytes to fill with pattern
+ * \return address of destination
+ */
+uintptr_t stream_set(uintptr_t dest, int pattern, size_t size);
+
+/*! \brief Fill a memory area with a pattern using non-temporal stores
+ * \ingroup string
+ * \param dest destination buffer
+ * \param pattern single byte pattern
+ * \param size number of bytes to fill with pattern
+ * \return pointer to destination
+ */
+template<typename T>
+inline T* stream_set(T* dest, int pattern, size_t size) {
+	return reinterpret_cast<T*>(stream_set(reinterpret_cast<uintptr_t>(dest), pattern, size));
+}
+
+/*! \brief Minimum size for \ref copy and \ref set to use non-temporal stores
+ * \return size in bytes
+ */
+size_t stream_threshold();
+
+/*! \brief Set minimum size for \ref copy and \ref set to use non-temporal stores
+ * \param size size in bytes, `0` for default (depending on the size of the
+ *             last level cache) or `SIZE_MAX` to disable
+ */
+void stream_threshold(size_t size);
+
 /*! \brief Compare a memory area
  * \ingroup string
  * \param s1 pointer to first element
@@ -171,16 +375,7 @@ inline T* set(T* dest, int pattern, size_t size) {
  * \return an integer less than, equal to, or greater than zero if the given number of bytes of the first element are
  *          found, respectively, to be less than, to match, or be greater than second element
  */
-inline int compare(uintptr_t s1, uintptr_t s2, size_t n) {
-	const unsigned char * c1 = reinterpret_cast<const unsigned char*>(s1);
-	const unsigned char * c2 = reinterpret_cast<const unsigned char*>(s2);
-
-	for(size_t i = 0; i != n; ++i)
-		if (c1[i] != c2[i])
-			return static_cast<int>(c1[i]) - static_cast<int>(c2[i]);
-
-	return 0;
-}
+int compare(uintptr_t s1, uintptr_t s2, size_t n);
 
 
 /*! \brief Compare a memory area
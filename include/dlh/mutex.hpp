@@ -14,7 +14,7 @@ class Mutex {
 	} var;
 
  public:
-	Mutex();
+	constexpr Mutex() : var(FUTEX_UNLOCKED) {}
 
 	/*! \brief Lock
 	 * \param at maximum waiting (relative)
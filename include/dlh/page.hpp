@@ -10,6 +10,7 @@
 
 struct Page {
 	static const size_t SIZE = 0x1000;
+	static const size_t HUGE_SIZE = 0x200000;
 	uintptr_t addr;
 	size_t size;
 
@@ -22,9 +22,13 @@ class Config {
 	Source source;
 	bool consume_env;
 	TreeMap<const char *, const char *> contents;
+	char * last_line = nullptr;  ///< Copy of an unterminated last line
 
  public:
 	explicit Config(const char * path, Source source = CONFIG_ONLY, bool consume_env = false);
+	Config(const Config&) = delete;
+	Config& operator=(const Config&) = delete;
+	~Config();
 
 	const char * value(const char * name);
 
@@ -0,0 +1,298 @@
+// Dirty Little Helper (DLH) - system support library for C/C++
+// Copyright 2021-2023 by Bernhard Heinloth <heinloth@cs.fau.de>
+// SPDX-License-Identifier: AGPL-3.0-or-later
+
+/*! \file
+ *  \brief \ref Pool "Object pool" for fixed-size objects
+ */
+
+#pragma once
+
+#include <dlh/mem.hpp>
+#include <dlh/math.hpp>
+#include <dlh/mutex.hpp>
+#include <dlh/types.hpp>
+#include <dlh/assert.hpp>
+#include <dlh/utility.hpp>
+
+/*! \brief Object pool for objects of a single type
+ *
+ * Slots for objects are carved from large pages (allocated on the heap) and
+ * kept in a free list after release, pages are returned to the heap on
+ * destruction of the pool (if no object is in use anymore).
+ * Access to the pool is synchronized, a \ref Magazine can be used by a thread
+ * to exchange slots with the pool in batches (without locking).
+ *
+ * \tparam T type of objects
+ * \tparam PAGE_SIZE size of pages allocated from heap
+ *                   (default fits in a 16 KiB heap block including allocator meta data)
+ */
+template<typename T, size_t PAGE_SIZE = 16 * 1024 - 64>
+class Pool {
+	/*! \brief Object slot */
+	union Slot {
+		Slot * next;
+		alignas(T) unsigned char data[sizeof(T)];
+	};
+
+	/*! \brief Page header (slots follow right after it) */
+	struct Page {
+		Page * next;
+	};
+
+	/*! \brief Offset of the first slot in a page */
+	static const size_t PAGE_HEADER = Math::align_up(sizeof(Page), alignof(Slot));
+
+	/*! \brief Number of slots in a page */
+	static const size_t SLOTS = (PAGE_SIZE - PAGE_HEADER) / sizeof(Slot);
+
+	Mutex _mutex;
+
+	/*! \brief Released slots */
+	Slot * _free = nullptr;
+
+	/*! \brief List of allocated pages */
+	Page * _pages = nullptr;
+
+	/*! \brief Next never used slot in the recent page */
+	Slot * _unused = nullptr;
+
+	/*! \brief End of recent page */
+	Slot * _unused_end = nullptr;
+
+	/*! \brief Number of slots in use (including slots in magazines) */
+	size_t _used = 0;
+
+	/*! \brief Number of allocated pages */
+	size_t _page_count = 0;
+
+	/*! \brief Get a free slot
+	 * \note Requires lock
+	 * \return pointer to slot or `nullptr` if no memory is available
+	 */
+	Slot * take() {
+		Slot * slot = _free;
+		if (slot != nullptr) {
+			_free = slot->next;
+		} else {
+			if (_unused == _unused_end) {
+				Page * page = Memory::alloc<Page>(PAGE_HEADER + SLOTS * sizeof(Slot));
+				if (page == nullptr)
+					return nullptr;
+				page->next = _pages;
+				_pages = page;
+				_page_count++;
+				_unused = reinterpret_cast<Slot *>(reinterpret_cast<uintptr_t>(page) + PAGE_HEADER);
+				_unused_end = _unused + SLOTS;
+			}
+			slot = _unused++;
+		}
+		_used++;
+		return slot;
+	}
+
+	/*! \brief Return a slot
+	 * \note Requires lock
+	 * \param slot pointer to slot
+	 */
+	void give(Slot * slot) {
+		assert(slot != nullptr && _used > 0);
+		slot->next = _free;
+		_free = slot;
+		_used--;
+	}
+
+ public:
+	/*! \brief Per-thread cache of free slots
+	 * Slots are exchanged with the pool in batches, hence only every few
+	 * allocations require the pool lock.
+	 * \note A magazine must only be used by a single thread.
+	 */
+	class Magazine {
+		/*! \brief Maximum number of cached slots */
+		static const size_t CAPACITY = 32;
+
+		Pool & _pool;
+		Slot * _slot[CAPACITY];
+		size_t _count = 0;
+
+	 public:
+		/*! \brief Create magazine
+		 * \param pool pool to take slots from
+		 */
+		explicit Magazine(Pool & pool) : _pool(pool) {}
+
+		Magazine(const Magazine &) = delete;
+		Magazine & operator=(const Magazine &) = delete;
+
+		/*! \brief Return all cached slots to pool
+		 */
+		~Magazine() {
+			flush();
+		}
+
+		/*! \brief Allocate uninitialized memory for an object
+		 * \return pointer to memory or `nullptr` if no memory is available
+		 */
+		T * alloc() {
+			if (_count == 0) {
+				Guarded<Mutex> section(_pool._mutex);
+				while (_count < CAPACITY / 2 && (_slot[_count] = _pool.take()) != nullptr)
+					_count++;
+				if (_count == 0)
+					return nullptr;
+			}
+			return reinterpret_cast<T *>(_slot[--_count]->data);
+		}
+
+		/*! \brief Free memory of an object
+		 * \param ptr pointer to memory allocated from the same pool
+		 */
+		void free(T * ptr) {
+			if (ptr == nullptr)
+				return;
+			if (_count == CAPACITY) {
+				Guarded<Mutex> section(_pool._mutex);
+				while (_count > CAPACITY / 2)
+					_pool.give(_slot[--_count]);
+			}
+			_slot[_count++] = reinterpret_cast<Slot *>(ptr);
+		}
+
+		/*! \brief Create an object
+		 * \param args arguments for constructor
+		 * \return pointer to object or `nullptr` if no memory is available
+		 */
+		template<typename... ARGS>
+		T * create(ARGS&&... args) {
+			T * ptr = alloc();
+			return ptr == nullptr ? nullptr : new (ptr) T(forward<ARGS>(args)...);
+		}
+
+		/*! \brief Destroy an object
+		 * \param ptr pointer to object created by the same pool
+		 */
+		void destroy(T * ptr) {
+			if (ptr != nullptr) {
+				ptr->~T();
+				free(ptr);
+			}
+		}
+
+		/*! \brief Return all cached slots to pool
+		 */
+		void flush() {
+			if (_count > 0) {
+				Guarded<Mutex> section(_pool._mutex);
+				while (_count > 0)
+					_pool.give(_slot[--_count]);
+			}
+		}
+	};
+
+	/*! \brief Create empty pool
+	 */
+	constexpr Pool() {}
+
+	Pool(const Pool &) = delete;
+	Pool & operator=(const Pool &) = delete;
+
+	/*! \brief Destroy pool
+	 * Pages are only released if no object is in use anymore
+	 */
+	~Pool() {
+		if (_used == 0) {
+			while (_pages != nullptr) {
+				Page * next = _pages->next;
+				Memory::free(_pages);
+				_pages = next;
+			}
+			_free = _unused = _unused_end = nullptr;
+			_page_count = 0;
+		}
+	}
+
+	/*! \brief Allocate uninitialized memory for an object
+	 * \return pointer to memory or `nullptr` if no memory is available
+	 */
+	T * alloc() {
+		Guarded<Mutex> section(_mutex);
+		Slot * slot = take();
+		return slot == nullptr ? nullptr : reinterpret_cast<T *>(slot->data);
+	}
+
+	/*! \brief Free memory of an object
+	 * \param ptr pointer to memory allocated from this pool
+	 */
+	void free(T * ptr) {
+		if (ptr != nullptr) {
+			Guarded<Mutex> section(_mutex);
+			give(reinterpret_cast<Slot *>(ptr));
+		}
+	}
+
+	/*! \brief Create an object
+	 * \param args arguments for constructor
+	 * \return pointer to object or `nullptr` if no memory is available
+	 */
+	template<typename... ARGS>
+	T * create(ARGS&&... args) {
+		T * ptr = alloc();
+		return ptr == nullptr ? nullptr : new (ptr) T(forward<ARGS>(args)...);
+	}
+
+	/*! \brief Destroy an object
+	 * \param ptr pointer to object created by this pool
+	 */
+	void destroy(T * ptr) {
+		if (ptr != nullptr) {
+			ptr->~T();
+			free(ptr);
+		}
+	}
+
+	/*! \brief Number of objects in use
+	 * \return number of slots allocated (including slots cached in magazines)
+	 */
+	size_t used() const {
+		return __atomic_load_n(&_used, __ATOMIC_RELAXED);
+	}
+
+	/*! \brief Number of slots
+	 * \return number of slots in all pages allocated by this pool
+	 */
+	size_t capacity() const {
+		return __atomic_load_n(&_page_count, __ATOMIC_RELAXED) * SLOTS;
+	}
+
+	/*! \brief Global pool for this type (used by \ref Pooled)
+	 */
+	static Pool global;
+
+	static_assert(SLOTS > 0, "Page size too small for object");
+};
+
+template<typename T, size_t PAGE_SIZE>
+Pool<T, PAGE_SIZE> Pool<T, PAGE_SIZE>::global;
+
+/*! \brief Allocate objects of a class using the global pool of the class
+ * Classes deriving from this will use `Pool<T>::global` for `new` and `delete`.
+ * Derived classes with a different size fall back to the heap.
+ *
+ * \tparam T class type
+ */
+template<typename T>
+struct Pooled {
+	static void * operator new(size_t size) {
+		void * ptr = size == sizeof(T) ? Pool<T>::global.alloc() : reinterpret_cast<void *>(Memory::alloc(size));
+		assert(ptr != nullptr);
+		return ptr;
+	}
+
+	static void operator delete(void * ptr, size_t size) {
+		if (size == sizeof(T))
+			Pool<T>::global.free(reinterpret_cast<T *>(ptr));
+		else
+			Memory::free(ptr);
+	}
+};
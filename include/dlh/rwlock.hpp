@@ -6,63 +6,134 @@
 
 #include <dlh/mutex.hpp>
 
+/*! \brief Number of readers holding a \ref RWLock (with flag for a writer)
+ *
+ * Readers only modify a single atomic counter (as long as there is no
+ * writer), hence concurrent readers do not serialize on a mutex.
+ */
+class ReaderCount {
+	/*! \brief Flag indicating a writer (holding or waiting for the lock) */
+	static const int WRITER = 1 << 30;
+
+	/*! \brief Number of readers and \ref WRITER flag */
+	int state = 0;
+
+ public:
+	constexpr ReaderCount() = default;
+
+	/*! \brief Add reader (if there is no writer)
+	 * \return `true` if added, `false` if there is a writer
+	 */
+	bool enter() {
+		int s = __atomic_load_n(&state, __ATOMIC_RELAXED);
+		while ((s & WRITER) == 0)
+			if (__atomic_compare_exchange_n(&state, &s, s + 1, true, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+				return true;
+		return false;
+	}
+
+	/*! \brief Add reader (unconditionally)
+	 * \note only allowed while writers are excluded
+	 */
+	void enter_exclusive() {
+		__atomic_fetch_add(&state, 1, __ATOMIC_ACQUIRE);
+	}
+
+	/*! \brief Remove reader (and wake a waiting writer if it was the last one)
+	 */
+	void leave() {
+		if (__atomic_sub_fetch(&state, 1, __ATOMIC_RELEASE) == WRITER)
+			wake();
+	}
+
+	/*! \brief Set writer flag and wait until all readers have left
+	 * \note only one writer at a time is allowed
+	 */
+	void lock();
+
+	/*! \brief Set writer flag if there are no readers
+	 * \note only one writer at a time is allowed
+	 * \return `true` if set
+	 */
+	bool trylock() {
+		int s = 0;
+		return __atomic_compare_exchange_n(&state, &s, WRITER, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED);
+	}
+
+	/*! \brief Clear writer flag
+	 */
+	void unlock() {
+		__atomic_fetch_and(&state, ~WRITER, __ATOMIC_RELEASE);
+	}
+
+ private:
+	/*! \brief Wake writer waiting for the readers to leave */
+	void wake();
+};
+
+/*! \brief Reader/writer lock
+ *
+ * Multiple readers can hold the lock at the same time, a writer has
+ * exclusive access.
+ * Writers are preferred: once a writer is waiting, new readers block until
+ * it has released the lock (hence a thread must not acquire a read lock
+ * recursively).
+ * \tparam T mutex type (serializing writers and blocked readers)
+ */
 template <class T = Mutex>
 class RWLock {
-	unsigned block = 0;
-	T reader, global;
+	ReaderCount readers;
+	T writer;
 
  public:
 	/*! \brief Lock for reading
 	 */
 	void read_lock() {
-		reader.lock();
-		if (++block == 1)
-			global.lock();
-		reader.unlock();
+		if (!readers.enter()) {
+			// Wait for the writer
+			writer.lock();
+			readers.enter_exclusive();
+			writer.unlock();
+		}
 	}
 
 	/*! \brief Try to lock for reading
 	 * \return `true` if lock could be aquired without blocking thread
 	 */
 	bool read_trylock() {
-		if (!reader.trylock())
-			return false;
-
-		bool r = true;
-		if (++block == 1 && !global.trylock()) {
-			block--;
-			r = false;
-		}
-		reader.unlock();
-		return r;
+		return readers.enter();
 	}
 
 	/*! \brief Unlock reader
 	 */
 	void read_unlock() {
-		reader.lock();
-		if (--block == 0)
-			global.unlock();
-		reader.unlock();
+		readers.leave();
 	}
 
 	/*! \brief Lock for writing
 	 */
 	void write_lock() {
-		global.lock();
+		writer.lock();
+		readers.lock();
 	}
 
 	/*! \brief Try to lock for writing
 	 * \return `true` if lock could be aquired without blocking thread
 	 */
 	bool write_trylock() {
-		return global.trylock();
+		if (!writer.trylock())
+			return false;
+		if (readers.trylock())
+			return true;
+		writer.unlock();
+		return false;
 	}
 
 	/*! \brief Unlock writer
 	 */
 	void write_unlock() {
-		global.unlock();
+		readers.unlock();
+		writer.unlock();
 	}
 };
 
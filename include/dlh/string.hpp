@@ -5,10 +5,266 @@
 #pragma once
 
 #include <dlh/types.hpp>
+#include <dlh/arena.hpp>
 #include <dlh/container/vector.hpp>
 
 namespace String {
 
+/*! \brief Runtime implementations of the `constexpr` functions
+ * using SIMD kernels (selected depending on the processor features)
+ */
+namespace Vectorized {
+
+/*! \brief Calculate the length of a string
+ * \param s pointer to a string (not `nullptr`)
+ * \param n max length to check
+ * \return number of bytes in the string
+ */
+size_t len(const char *s, size_t n);
+
+/*! \brief Compare two strings
+ * \param s1 first string (not `nullptr`)
+ * \param s2 second string (not `nullptr`)
+ * \param n number of bytes to compare
+ * \return difference of the first differing characters (or `0` if equal)
+ */
+int compare(const char *s1, const char *s2, size_t n);
+
+}  // namespace Vectorized
+
+/*! \brief Precompiled substring search
+ *
+ * Preprocesses the needle once, hence repeated searches for the same needle
+ * only pay the setup costs once.
+ * Short needles use a SIMD filter (comparing the first and last character of
+ * the needle for several positions at once), long needles the Two-Way
+ * algorithm (linear time, constant space) with a bad character shift.
+ * \note The needle is not copied and has to stay valid
+ */
+class Searcher {
+	/*! \brief Maximum needle length for the SIMD filter */
+	static const size_t SHORT = 32;
+
+	/*! \brief Needle */
+	const char * _needle;
+
+	/*! \brief Length of the needle */
+	size_t _len;
+
+	/*! \brief Critical position of the needle (Two-Way) */
+	ssize_t _critical = -1;
+
+	/*! \brief Period of the needle (Two-Way) */
+	size_t _period = 0;
+
+	/*! \brief Needle is periodic (Two-Way) */
+	bool _periodic = false;
+
+	/*! \brief Bad character shift for the last byte of the window (Two-Way)
+	 * \note limited to 16 bit, which is sufficient to skip large parts
+	 */
+	uint16_t _shift[256];
+
+	/*! \brief Search with Two-Way algorithm
+	 * \param haystack string to search in
+	 * \param haystack_len length of haystack
+	 * \return Pointer to first occurrence of the needle or `nullptr`
+	 */
+	const char * two_way(const char * haystack, size_t haystack_len) const;
+
+ public:
+	/*! \brief Preprocess needle
+	 * \param needle string to search for
+	 */
+	explicit Searcher(const char * needle);
+
+	/*! \brief Preprocess needle
+	 * \param needle string to search for (not required to be null-terminated)
+	 * \param needle_len length of needle
+	 */
+	Searcher(const char * needle, size_t needle_len);
+
+	/*! \brief Length of the needle
+	 * \return number of bytes
+	 */
+	size_t length() const {
+		return _len;
+	}
+
+	/*! \brief Find the first occurrence of the needle
+	 * \param haystack string to search in
+	 * \return Pointer to first occurrence of the needle or `nullptr` if not found
+	 *         (haystack if needle is empty)
+	 */
+	const char * find(const char * haystack) const;
+
+	/*! \brief Find the first occurrence of the needle in a buffer
+	 * \param haystack buffer to search in (may contain null bytes)
+	 * \param haystack_len length of the buffer
+	 * \return Pointer to first occurrence of the needle or `nullptr` if not found
+	 *         (haystack if needle is empty)
+	 */
+	const char * find(const char * haystack, size_t haystack_len) const;
+
+	/*! \brief Find the last occurrence of the needle
+	 * \param haystack string to search in
+	 * \return Pointer to last occurrence of the needle or `nullptr` if not found
+	 *         (haystack if needle is empty)
+	 */
+	const char * find_last(const char * haystack) const;
+};
+
+/*! \brief Lazy tokenizer
+ *
+ * Splits a buffer at delimiter characters without modifying or copying it,
+ * yielding one token at a time as pointer and length (the tokens are not
+ * null-terminated).
+ * The delimiters are located by a SIMD kernel comparing several bytes with
+ * each character of the delimiter set at once.
+ * Tokenizing (e.g., the lines of a large file mapped into memory) therefore
+ * requires no allocation at all.
+ * Like \ref split, empty tokens are omitted and after `max` splits the
+ * remainder is returned as last token.
+ * \note The source and the delimiters are not copied and have to stay valid
+ */
+class Tokenizer {
+	/*! \brief Start of the remaining source */
+	const char * _pos;
+
+	/*! \brief End of the source */
+	const char * _end;
+
+	/*! \brief Set of delimiters (`nullptr` for \ref _delimiter) */
+	const char * _delimiters;
+
+	/*! \brief Number of characters in the delimiter set */
+	size_t _delimiters_len;
+
+	/*! \brief Single delimiter character */
+	char _delimiter;
+
+	/*! \brief Remaining number of splits */
+	size_t _max;
+
+ public:
+	/*! \brief Token */
+	struct Token {
+		/*! \brief Start of the token (not null-terminated) */
+		const char * str;
+
+		/*! \brief Length of the token (not zero) */
+		size_t len;
+	};
+
+	class Iterator;
+
+	/*! \brief Tokenize a buffer by a set of delimiters
+	 * \param source buffer (may contain null bytes)
+	 * \param source_len length of the buffer
+	 * \param delimiters null-terminated list of characters to split the buffer
+	 *                   (`nullptr` or empty for no splitting)
+	 * \param max maximum number of splits
+	 */
+	Tokenizer(const char * source, size_t source_len, const char * delimiters, size_t max = SIZE_MAX);
+
+	/*! \brief Tokenize a string by a set of delimiters
+	 * \param source null-terminated string
+	 * \param delimiters null-terminated list of characters to split the string
+	 *                   (`nullptr` or empty for no splitting)
+	 * \param max maximum number of splits
+	 */
+	Tokenizer(const char * source, const char * delimiters, size_t max = SIZE_MAX);
+
+	/*! \brief Tokenize a buffer by a delimiter
+	 * \param source buffer (may contain null bytes)
+	 * \param source_len length of the buffer
+	 * \param delimiter character to split the buffer
+	 * \param max maximum number of splits
+	 */
+	Tokenizer(const char * source, size_t source_len, char delimiter, size_t max = SIZE_MAX);
+
+	/*! \brief Tokenize a string by a delimiter
+	 * \param source null-terminated string
+	 * \param delimiter character to split the string
+	 * \param max maximum number of splits
+	 */
+	Tokenizer(const char * source, char delimiter, size_t max = SIZE_MAX);
+
+	/*! \brief Get the next token
+	 * \param[out] token next token
+	 * \return `false` if there are no more tokens
+	 */
+	bool next(Token & token);
+
+	/*! \brief Remaining source (not yet tokenized)
+	 * \return pointer to the remaining bytes of the source
+	 */
+	const char * remaining() const {
+		return _pos;
+	}
+
+	/*! \brief Iterator at the next token
+	 * \note Iterating does not advance this tokenizer
+	 */
+	Iterator begin() const;
+
+	/*! \brief End iterator */
+	Iterator end() const;
+};
+
+/*! \brief Iterator for range-based for loops */
+class Tokenizer::Iterator {
+	friend class Tokenizer;
+
+	/*! \brief Tokenizer state */
+	Tokenizer _tokenizer;
+
+	/*! \brief Current token (`nullptr` at the end) */
+	Token _token;
+
+	/*! \brief Create iterator at the first (remaining) token
+	 * \param tokenizer tokenizer
+	 */
+	explicit Iterator(const Tokenizer & tokenizer) : _tokenizer(tokenizer), _token{nullptr, 0} {
+		if (!_tokenizer.next(_token))
+			_token.str = nullptr;
+	}
+
+	/*! \brief Create end iterator */
+	Iterator() : _tokenizer(nullptr, 0, '\0'), _token{nullptr, 0} {}
+
+ public:
+	Iterator& operator++() {
+		if (!_tokenizer.next(_token))
+			_token.str = nullptr;
+		return *this;
+	}
+
+	const Token & operator*() const {
+		return _token;
+	}
+
+	const Token * operator->() const {
+		return &_token;
+	}
+
+	bool operator==(const Iterator & other) const {
+		return _token.str == other._token.str;
+	}
+
+	bool operator!=(const Iterator & other) const {
+		return _token.str != other._token.str;
+	}
+};
+
+inline Tokenizer::Iterator Tokenizer::begin() const {
+	return Iterator(*this);
+}
+
+inline Tokenizer::Iterator Tokenizer::end() const {
+	return Iterator();
+}
+
 /*! \brief Find the first occurrence of a character in a string
  * \param s string to search in
  * \param c character to find
@@ -76,6 +332,16 @@ char * replace_inplace(char *target, int from, int to, size_t max = SIZE_MAX);
  */
 char * replace(const char *source, int from, int to, size_t max = SIZE_MAX);
 
+/*! \brief Replace characters in a string copied to an arena
+ * \param arena arena to allocate target from
+ * \param source pointer to string (string will be copied)
+ * \param from character to be replaced
+ * \param to replacement character
+ * \param max maximum number of replacements to be performed
+ * \return Pointer to the target string
+ */
+char * replace(Memory::Arena & arena, const char *source, int from, int to, size_t max = SIZE_MAX);
+
 /*! \brief Replace stubstrings in a string
  * \param target pointer to string  (target memory will be modified!)
  * \param from substring to be replaced
@@ -105,6 +371,16 @@ char * replace_inplace(char *target, size_t target_len, const char *from, const
  */
 char * replace(const char *source, const char *from, const char * to, size_t max = SIZE_MAX);
 
+/*! \brief Replace stubstrings in a string copied to an arena
+ * \param arena arena to allocate target from
+ * \param source pointer to string (string will be copied)
+ * \param from substring to be replaced
+ * \param to replacement substring
+ * \param max maximum number of replacements to be performed
+ * \return Pointer to the target string
+ */
+char * replace(Memory::Arena & arena, const char *source, const char *from, const char * to, size_t max = SIZE_MAX);
+
 /*! \brief Compare two strings
  * \param s1 first string
  * \param s2 second string
@@ -115,6 +391,9 @@ constexpr int compare(const char *s1, const char *s2) {
 	if (s1 == s2 || s1 == nullptr || s2 == nullptr)
 		return 0;
 
+	if (!__builtin_is_constant_evaluated())
+		return Vectorized::compare(s1, s2, SIZE_MAX);
+
 	while(*s1 == *s2++)
 		if (*s1++ == '\0')
 			return 0;
@@ -133,6 +412,9 @@ constexpr int compare(const char *s1, const char *s2, size_t n) {
 	if (s1 == s2)
 		return 0;
 
+	if (s1 != nullptr && s2 != nullptr && !__builtin_is_constant_evaluated())
+		return Vectorized::compare(s1, s2, n);
+
 	if (s1 != nullptr && s2 != nullptr) {
 		for (size_t i = 0; i < n; i++) {
 			if (s1[i] != s2[i])
@@ -177,20 +459,89 @@ bool starts_with(const char *str, const char * start);
  */
 bool ends_with(const char *str, const char * end);
 
-/*! \brief String hash (djb2)
- * \see http://www.cse.yorku.ca/~oz/hash.html
- * \param s String to hash
+namespace detail {
+
+/*! \brief Secret constants for the string hash (wyhash) */
+constexpr uint64_t hash_secret[4] = { 0x2d358dccaa6c78a5ULL, 0x8bb84b93962eacc9ULL, 0x4b33a62ed433d4a3ULL, 0x4d5a2da51de1aa47ULL };
+
+/*! \brief Multiply two 64 bit values to 128 bit and fold the result
+ * \param a first factor
+ * \param b second factor
+ * \return lower half xor upper half of the product
+ */
+constexpr uint64_t hash_mix(uint64_t a, uint64_t b) {
+	__uint128_t r = static_cast<__uint128_t>(a) * b;
+	return static_cast<uint64_t>(r) ^ static_cast<uint64_t>(r >> 64);
+}
+
+/*! \brief Read little endian value (usable in constant expressions)
+ * \note compiled to a single (unaligned) load on x86_64
+ * \param p pointer to string
+ * \param bytes number of bytes to read (at most 8)
+ * \return value
+ */
+constexpr uint64_t hash_read(const char * p, size_t bytes) {
+	uint64_t v = 0;
+	for (size_t i = 0; i < bytes; i++)
+		v |= static_cast<uint64_t>(static_cast<unsigned char>(p[i])) << (8 * i);
+	return v;
+}
+
+}  // namespace detail
+
+/*! \brief String hash (wyhash)
+ * Processes 16 bytes per step, each folding a full 128 bit multiplication
+ * (good avalanche even for similar keys).
+ * \see https://github.com/wangyi-fudan/wyhash
+ * \param s String to hash (not required to be null-terminated)
+ * \param len length of the string
  * \return unsigned 32bit integer with string hash
  */
-constexpr uint32_t hash(const char * s) {
+constexpr uint32_t hash(const char * s, size_t len) {
+	using detail::hash_secret;
+	using detail::hash_mix;
+	using detail::hash_read;
 	if (s == nullptr)
 		return 0;
-	uint_fast32_t h = 5381;
-	for (unsigned char c = *s; c != '\0'; c = *++s)
-		h = h * 33 + c;
-	return h & 0xffffffff;
-}
 
+	uint64_t seed = hash_mix(hash_secret[0], hash_secret[1]);
+	uint64_t a = 0;
+	uint64_t b = 0;
+	if (len <= 16) {
+		if (len >= 4) {
+			// (Overlapping) reads of 4 bytes each
+			const size_t o = (len >> 3) << 2;
+			a = (hash_read(s, 4) << 32) | hash_read(s + o, 4);
+			b = (hash_read(s + len - 4, 4) << 32) | hash_read(s + len - 4 - o, 4);
+		} else if (len > 0) {
+			a = (hash_read(s, 1) << 16) | (hash_read(s + (len >> 1), 1) << 8) | hash_read(s + len - 1, 1);
+		}
+	} else {
+		const char * p = s;
+		size_t i = len;
+		if (i > 48) {
+			// Three independent lanes
+			uint64_t see1 = seed;
+			uint64_t see2 = seed;
+			do {
+				seed = hash_mix(hash_read(p, 8) ^ hash_secret[1], hash_read(p + 8, 8) ^ seed);
+				see1 = hash_mix(hash_read(p + 16, 8) ^ hash_secret[2], hash_read(p + 24, 8) ^ see1);
+				see2 = hash_mix(hash_read(p + 32, 8) ^ hash_secret[3], hash_read(p + 40, 8) ^ see2);
+				p += 48;
+				i -= 48;
+			} while (i > 48);
+			seed ^= see1 ^ see2;
+		}
+		for (; i > 16; i -= 16, p += 16)
+			seed = hash_mix(hash_read(p, 8) ^ hash_secret[1], hash_read(p + 8, 8) ^ seed);
+		// Last 16 bytes (overlapping)
+		a = hash_read(p + i - 16, 8);
+		b = hash_read(p + i - 8, 8);
+	}
+	__uint128_t r = static_cast<__uint128_t>(a ^ hash_secret[1]) * (b ^ seed);
+	uint64_t h = hash_mix(static_cast<uint64_t>(r) ^ hash_secret[0] ^ len, static_cast<uint64_t>(r >> 64) ^ hash_secret[1]);
+	return static_cast<uint32_t>(h ^ (h >> 32));
+}
 
 /*! \brief Calculate the length of a string
  * \param s pointer to a string
@@ -198,6 +549,9 @@ constexpr uint32_t hash(const char * s) {
  * \return number of bytes in the string
  */
 constexpr size_t len(const char *s, size_t n = SIZE_MAX) {
+	if (s != nullptr && !__builtin_is_constant_evaluated())
+		return Vectorized::len(s, n);
+
 	size_t len = 0;
 	if (s != nullptr)
 		while (*s++ != '\0' && n-- > 0)
@@ -206,6 +560,14 @@ constexpr size_t len(const char *s, size_t n = SIZE_MAX) {
 	return len;
 }
 
+/*! \brief String hash
+ * \param s String to hash
+ * \return unsigned 32bit integer with string hash
+ */
+constexpr uint32_t hash(const char * s) {
+	return hash(s, len(s));
+}
+
 /*! \brief Copy the contents of a string
  * including the terminating null byte (`\0`)
  * \param dest destination string buffer
@@ -240,6 +602,22 @@ char* duplicate(const char *s);
  */
 char* duplicate(const char *s, size_t n);
 
+/*! \brief Duplicate a string in an arena
+ * \param arena arena to allocate from
+ * \param s pointer to a string
+ * \return pointer to a duplicated string or `nullptr` if allocation failed.
+ */
+char* duplicate(Memory::Arena & arena, const char *s);
+
+/*! \brief Duplicate a string in an arena
+ * \param arena arena to allocate from
+ * \param s pointer to a string
+ * \param n available bytes to allocate
+ * \return pointer to a duplicated string (with `n+1` bytes, always null-terminated)
+ *         or `nullptr` if allocation failed.
+ */
+char* duplicate(Memory::Arena & arena, const char *s, size_t n);
+
 /*! \brief Split a string by a delimiter
  * \param source pointer to a string (target memory will be modified!)
  * \param delimiter character to split string
@@ -257,6 +635,15 @@ Vector<const char *> split_inplace(char * source, int delimiter, size_t max = SI
  */
 Vector<const char *> split(const char * source, int delimiter, size_t max = SIZE_MAX);
 
+/*! \brief Split a string by a delimiter into an arena
+ * \param arena arena to allocate the vector and the substrings from
+ * \param source pointer to a string
+ * \param delimiter character to split string
+ * \param max maximum number of splits (hence the vector contains not more than max + 1 elements)
+ * \return Vector with pointers to the start of each substring (empty substrings are omitted)
+ */
+Vector<const char *> split(Memory::Arena & arena, const char * source, int delimiter, size_t max = SIZE_MAX);
+
 /*! \brief Split a string by any of the given delimiters
  * \param source pointer to a string (target memory will be modified!)
  * \param delimiter null-terminated list of characters to split the string
@@ -274,6 +661,15 @@ Vector<const char *> split_any_inplace(char * source, const char * delimiter, si
  */
 Vector<const char *> split_any(const char * source, const char * delimiter, size_t max = SIZE_MAX);
 
+/*! \brief Split a string by any of the given delimiters into an arena
+ * \param arena arena to allocate the vector and the substrings from
+ * \param source pointer to a string
+ * \param delimiter null-terminated list of characters to split the string
+ * \param max maximum number of splits (hence the vector contains not more than max + 1 elements)
+ * \return Vector with pointers to the start of each substring (empty substrings are omitted)
+ */
+Vector<const char *> split_any(Memory::Arena & arena, const char * source, const char * delimiter, size_t max = SIZE_MAX);
+
 /*! \brief Split a string by a delimiter
  * \param source pointer to a string (target memory will be modified!)
  * \param delimiter substring to split string
@@ -290,4 +686,13 @@ Vector<const char *> split_inplace(char * source, const char * delimiter, size_t
  * \note You have to free each element of the result vector!
  */
 Vector<const char *> split(const char * source, const char * delimiter, size_t max = SIZE_MAX);
+
+/*! \brief Split a string by a substring into an arena
+ * \param arena arena to allocate the vector and the substrings from
+ * \param source pointer to a string
+ * \param delimiter substring to split string
+ * \param max maximum number of splits (hence the vector contains not more than max + 1 elements)
+ * \return Vector with pointers to the start of each substring (empty substrings are omitted)
+ */
+Vector<const char *> split(Memory::Arena & arena, const char * source, const char * delimiter, size_t max = SIZE_MAX);
 }  // namespace String
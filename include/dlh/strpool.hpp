@@ -0,0 +1,91 @@
+// Dirty Little Helper (DLH) - system support library for C/C++
+// Copyright 2021-2023 by Bernhard Heinloth <heinloth@cs.fau.de>
+// SPDX-License-Identifier: AGPL-3.0-or-later
+
+/*! \file
+ *  \brief \ref StringPool "String pool" for interning strings
+ */
+
+#pragma once
+
+#include <dlh/atom.hpp>
+#include <dlh/arena.hpp>
+#include <dlh/rwlock.hpp>
+#include <dlh/strptr.hpp>
+#include <dlh/types.hpp>
+#include <dlh/container/hash.hpp>
+
+/*! \brief Pool of interned strings
+ *
+ * Each distinct string is copied once into arena-backed storage (kept until
+ * the pool is destroyed) and referred to by an \ref Atom, which allows
+ * comparing and hashing strings in constant time.
+ * Access to the pool is synchronized (lookups of already interned strings
+ * only require a shared lock).
+ */
+class StringPool {
+	RWLock<> _lock;
+
+	/*! \brief Storage of the strings (including their \ref Atom::Header) */
+	Memory::Arena _arena;
+
+	/*! \brief Index of all interned strings */
+	HashSet<StrPtr> _strings;
+
+	/*! \brief Bytes used for strings */
+	size_t _bytes = 0;
+
+ public:
+	StringPool() = default;
+	StringPool(const StringPool &) = delete;
+	StringPool & operator=(const StringPool &) = delete;
+
+	/*! \brief Intern a string
+	 * \param s string (with cached hash and length)
+	 * \return handle of the interned string (empty if `s` is `nullptr` or no memory is available)
+	 */
+	Atom intern(const StrPtr & s);
+
+	/*! \brief Intern a string
+	 * \param s string (not required to be null-terminated)
+	 * \param len length of the string
+	 * \return handle of the interned string (empty if `s` is `nullptr` or no memory is available)
+	 */
+	inline Atom intern(const char * s, size_t len) {
+		return intern(StrPtr(s, len));
+	}
+
+	/*! \brief Intern a null-terminated string
+	 * \param s string
+	 * \return handle of the interned string (empty if `s` is `nullptr` or no memory is available)
+	 */
+	inline Atom intern(const char * s) {
+		return intern(StrPtr(s));
+	}
+
+	/*! \brief Get handle of an already interned string
+	 * \param s string (with cached hash and length)
+	 * \return handle of the interned string (empty if it has not been interned)
+	 */
+	Atom find(const StrPtr & s);
+
+	/*! \brief Get handle of an already interned string
+	 * \param s null-terminated string
+	 * \return handle of the interned string (empty if it has not been interned)
+	 */
+	inline Atom find(const char * s) {
+		return find(StrPtr(s));
+	}
+
+	/*! \brief Number of interned strings
+	 */
+	size_t size();
+
+	/*! \brief Bytes used for interned strings (including meta data)
+	 */
+	size_t bytes();
+
+	/*! \brief Pool shared by the whole process
+	 */
+	static StringPool & global();
+};
@@ -13,7 +13,13 @@ struct StrPtr {
 	uint32_t hash;
 	size_t len;
 
-	explicit constexpr StrPtr(const char * s = nullptr) : str(s), hash(String::hash(s)), len(String::len(s)) {}
+	explicit constexpr StrPtr(const char * s = nullptr) : StrPtr(s, String::len(s)) {}
+
+	/*! \brief Create from string with known length
+	 * \param s string
+	 * \param l length of string
+	 */
+	constexpr StrPtr(const char * s, size_t l) : str(s), hash(String::hash(s, l)), len(l) {}
 
 	constexpr StrPtr(const StrPtr& s) : str(s.str), hash(s.hash), len(s.len) {}
 
@@ -25,7 +31,7 @@ struct StrPtr {
 		if (str != nullptr) {
 			for (const char * i = str; *i != '\0'; ++i) {
 				if (*i == c)
-					return StrPtr(i);
+					return StrPtr(i, len - (i - str));
 			}
 		}
 		return *this;
@@ -39,7 +45,7 @@ struct StrPtr {
 		if (str != nullptr) {
 			for (size_t l = len; l > 0; --l) {
 				if (str[l] == c)
-					return StrPtr(str + l + 1);
+					return StrPtr(str + l + 1, len - l - 1);
 			}
 		}
 		return *this;
@@ -79,8 +85,8 @@ struct StrPtr {
 
 	constexpr StrPtr& operator=(const char * other) {
 		str = other;
-		hash = String::hash(other);
 		len = String::len(other);
+		hash = String::hash(other, len);
 		return *this;
 	}
 };
@@ -174,6 +174,7 @@ ReturnValue<int> kill(pid_t pid, signal_t sig);
 ReturnValue<int> tgkill(pid_t tgid, pid_t tid, signal_t sig);
 
 ReturnValue<int> getrlimit(rlimit_t resource, struct rlimit *rlim);
+ReturnValue<int> sched_getaffinity(pid_t pid, size_t size, void * mask);
 ReturnValue<int> arch_prctl(arch_code_t code, unsigned long addr);
 ReturnValue<int> prctl(prctl_t option, unsigned long arg2, unsigned long arg3 = 0, unsigned long arg4 = 0, unsigned long arg5 = 0);
 
@@ -193,6 +194,7 @@ ReturnValue<uintptr_t> mremap(uintptr_t old_addr, size_t old_len, size_t new_len
 ReturnValue<int> mprotect(uintptr_t start, size_t len, int prot);
 ReturnValue<int> munmap(uintptr_t start, size_t len);
 ReturnValue<int> msync(uintptr_t start, size_t len, int flags);
+ReturnValue<int> madvise(uintptr_t start, size_t len, int advice);
 
 ReturnValue<int> socket(protocol_family_t domain, socket_type_t type, int protocol = 0);
 ReturnValue<int> getsockopt(int fd, int level, int optname, void * __restrict__ optval, socklen_t * __restrict__ optlen);
@@ -50,6 +50,7 @@ struct Thread {
 			int tls_errno;
 			uintptr_t map_base;
 			size_t map_size;
+			void * alloc_cache;
 		};
 		void * __padding[8] = { nullptr };
 	};
@@ -157,7 +158,7 @@ struct Thread {
 	   Padding for newer GLIBC compatibility */
 	char end_padding[256] = { };
 
-	explicit Thread(DynamicThreadVector * dtv = nullptr, uintptr_t base = 0, size_t size = 0, bool detach = false) : tcb(this), dtv(dtv), selfptr(this), map_base(base), map_size(size), joindid(detach ? this : 0) {
+	explicit Thread(DynamicThreadVector * dtv = nullptr, uintptr_t base = 0, size_t size = 0, bool detach = false) : tcb(this), dtv(dtv), selfptr(this), map_base(base), map_size(size), alloc_cache(nullptr), joindid(detach ? this : 0) {
 		list.next = &list;
 		list.prev = &list;
 	}
@@ -4,7 +4,7 @@
 // Copyright 2014 by Yann Collet (XXHash)
 // SPDX-License-Identifier: AGPL-3.0-or-later
 
-/*! \file XXHash (64 bit), based on Yann Collet's descriptions
+/*! \file XXHash (64 bit) and XXH3 (64 and 128 bit), based on Yann Collet's descriptions
  * \see http://cyan4973.github.io/xxHash/
  *
  * Copyright (c) 2016 Stephan Brumme. All rights reserved.
@@ -275,3 +275,366 @@ constexpr bool XXHash64::add<const char *>(const char *input) {
 	for (const char * s = input; s != nullptr && *s++ != '\0'; len++) {}
 	return add(input, len);
 }
+
+/*! \brief XXH3 (64 and 128 bit), streaming and one-shot
+ * Inputs up to 240 bytes are hashed by `constexpr` functions (hence usable at
+ * compile time), longer inputs are accumulated by SIMD kernels (SSE2 or
+ * AVX2, selected at runtime) with only the last stripe processed by scalar code.
+ * \see https://github.com/Cyan4973/xxHash/blob/dev/doc/xxhash_spec.md
+ */
+class XXHash3 {
+ public:
+	/*! \brief 128 bit hash value */
+	struct Hash128 {
+		uint64_t low;
+		uint64_t high;
+
+		constexpr bool operator==(const Hash128 & other) const {
+			return low == other.low && high == other.high;
+		}
+
+		constexpr bool operator!=(const Hash128 & other) const {
+			return !operator==(other);
+		}
+	};
+
+	/// size of the (default) secret
+	static const size_t SecretSize = 192;
+
+	/// bytes per stripe (processed by the SIMD kernels)
+	static const size_t StripeLen = 64;
+
+ private:
+	/// magic constants :-)
+	static const uint64_t Prime32_1 = 0x9E3779B1U;
+	static const uint64_t Prime32_2 = 0x85EBCA77U;
+	static const uint64_t Prime32_3 = 0xC2B2AE3DU;
+	static const uint64_t Prime64_1 = 0x9E3779B185EBCA87ULL;
+	static const uint64_t Prime64_2 = 0xC2B2AE3D27D4EB4FULL;
+	static const uint64_t Prime64_3 = 0x165667B19E3779F9ULL;
+	static const uint64_t Prime64_4 = 0x85EBCA77C2B2AE63ULL;
+	static const uint64_t Prime64_5 = 0x27D4EB2F165667C5ULL;
+	static const uint64_t PrimeMx1 = 0x165667919E3779F9ULL;
+	static const uint64_t PrimeMx2 = 0x9FB21C651E98DF25ULL;
+
+	/// largest input hashed without the SIMD kernels
+	static const size_t MidSizeMax = 240;
+
+	/// temporarily store up to 256 bytes between multiple add() calls
+	static const size_t MaxBufferSize = 256;
+
+	/// pseudorandom default secret (taken from FARSH)
+	static constexpr unsigned char Secret[SecretSize] = {
+		0xb8, 0xfe, 0x6c, 0x39, 0x23, 0xa4, 0x4b, 0xbe, 0x7c, 0x01, 0x81, 0x2c, 0xf7, 0x21, 0xad, 0x1c,
+		0xde, 0xd4, 0x6d, 0xe9, 0x83, 0x90, 0x97, 0xdb, 0x72, 0x40, 0xa4, 0xa4, 0xb7, 0xb3, 0x67, 0x1f,
+		0xcb, 0x79, 0xe6, 0x4e, 0xcc, 0xc0, 0xe5, 0x78, 0x82, 0x5a, 0xd0, 0x7d, 0xcc, 0xff, 0x72, 0x21,
+		0xb8, 0x08, 0x46, 0x74, 0xf7, 0x43, 0x24, 0x8e, 0xe0, 0x35, 0x90, 0xe6, 0x81, 0x3a, 0x26, 0x4c,
+		0x3c, 0x28, 0x52, 0xbb, 0x91, 0xc3, 0x00, 0xcb, 0x88, 0xd0, 0x65, 0x8b, 0x1b, 0x53, 0x2e, 0xa3,
+		0x71, 0x64, 0x48, 0x97, 0xa2, 0x0d, 0xf9, 0x4e, 0x38, 0x19, 0xef, 0x46, 0xa9, 0xde, 0xac, 0xd8,
+		0xa8, 0xfa, 0x76, 0x3f, 0xe3, 0x9c, 0x34, 0x3f, 0xf9, 0xdc, 0xbb, 0xc7, 0xc7, 0x0b, 0x4f, 0x1d,
+		0x8a, 0x51, 0xe0, 0x4b, 0xcd, 0xb4, 0x59, 0x31, 0xc8, 0x9f, 0x7e, 0xc9, 0xd9, 0x78, 0x73, 0x64,
+		0xea, 0xc5, 0xac, 0x83, 0x34, 0xd3, 0xeb, 0xc3, 0xc5, 0x81, 0xa0, 0xff, 0xfa, 0x13, 0x63, 0xeb,
+		0x17, 0x0d, 0xdd, 0x51, 0xb7, 0xf0, 0xda, 0x49, 0xd3, 0x16, 0x55, 0x26, 0x29, 0xd4, 0x68, 0x9e,
+		0x2b, 0x16, 0xbe, 0x58, 0x7d, 0x47, 0xa1, 0xfc, 0x8f, 0xf8, 0xb8, 0xd1, 0x7a, 0xd0, 0x31, 0xce,
+		0x45, 0xcb, 0x3a, 0x8f, 0x95, 0x16, 0x04, 0x28, 0xaf, 0xd7, 0xfb, 0xca, 0xbb, 0x4b, 0x40, 0x7e,
+	};
+
+	/// accumulators
+	uint64_t      acc[8];
+	/// secret derived from the seed
+	unsigned char secret[SecretSize];
+	/// unprocessed input
+	unsigned char buffer[MaxBufferSize];
+	unsigned int  bufferSize;
+	/// stripes processed in the current block
+	size_t        stripes;
+	uint64_t      totalLength;
+	uint64_t      seed;
+
+	/// read little endian value byte by byte (usable in constant expressions, compiles to a single load)
+	template<typename T>
+	static constexpr uint64_t read(const T * p, size_t bytes) {
+		uint64_t v = 0;
+		for (size_t i = 0; i < bytes; i++)
+			v |= static_cast<uint64_t>(static_cast<unsigned char>(p[i])) << (8 * i);
+		return v;
+	}
+
+	template<typename T>
+	static constexpr uint64_t read32(const T * p) {
+		return read(p, 4);
+	}
+
+	template<typename T>
+	static constexpr uint64_t read64(const T * p) {
+		return read(p, 8);
+	}
+
+	static constexpr uint64_t rotateLeft(uint64_t x, unsigned char bits) {
+		return (x << bits) | (x >> (64 - bits));
+	}
+
+	static constexpr uint32_t rotateLeft32(uint32_t x, unsigned char bits) {
+		return (x << bits) | (x >> (32 - bits));
+	}
+
+	static constexpr Hash128 multiply(uint64_t a, uint64_t b) {
+		__uint128_t r = static_cast<__uint128_t>(a) * b;
+		return { static_cast<uint64_t>(r), static_cast<uint64_t>(r >> 64) };
+	}
+
+	/// 64x64 -> 128 bit multiplication, folded to 64 bit
+	static constexpr uint64_t multiplyFold(uint64_t a, uint64_t b) {
+		Hash128 r = multiply(a, b);
+		return r.low ^ r.high;
+	}
+
+	/// final mix of XXH64
+	static constexpr uint64_t avalanche64(uint64_t h) {
+		h ^= h >> 33;
+		h *= Prime64_2;
+		h ^= h >> 29;
+		h *= Prime64_3;
+		h ^= h >> 32;
+		return h;
+	}
+
+	static constexpr uint64_t avalanche(uint64_t h) {
+		h ^= h >> 37;
+		h *= PrimeMx1;
+		h ^= h >> 32;
+		return h;
+	}
+
+	static constexpr uint64_t rrmxmx(uint64_t h, uint64_t len) {
+		h ^= rotateLeft(h, 49) ^ rotateLeft(h, 24);
+		h *= PrimeMx2;
+		h ^= (h >> 35) + len;
+		h *= PrimeMx2;
+		return h ^ (h >> 28);
+	}
+
+	/// mix 16 bytes of input with 16 bytes of secret
+	static constexpr uint64_t mix16(const char * input, const unsigned char * sec, uint64_t seed) {
+		return multiplyFold(read64(input) ^ (read64(sec) + seed), read64(input + 8) ^ (read64(sec + 8) - seed));
+	}
+
+	/// mix two 16 byte inputs (for 128 bit hashes)
+	static constexpr Hash128 mix32(Hash128 acc, const char * input1, const char * input2, const unsigned char * sec, uint64_t seed) {
+		acc.low += mix16(input1, sec, seed);
+		acc.low ^= read64(input2) + read64(input2 + 8);
+		acc.high += mix16(input2, sec + 16, seed);
+		acc.high ^= read64(input1) + read64(input1 + 8);
+		return acc;
+	}
+
+	static constexpr uint64_t hashShort(const char * input, size_t len, uint64_t seed) {
+		if (len > 8) {
+			const uint64_t bitflip1 = (read64(Secret + 24) ^ read64(Secret + 32)) + seed;
+			const uint64_t bitflip2 = (read64(Secret + 40) ^ read64(Secret + 48)) - seed;
+			const uint64_t low = read64(input) ^ bitflip1;
+			const uint64_t high = read64(input + len - 8) ^ bitflip2;
+			return avalanche(len + __builtin_bswap64(low) + high + multiplyFold(low, high));
+		} else if (len >= 4) {
+			seed ^= static_cast<uint64_t>(__builtin_bswap32(static_cast<uint32_t>(seed))) << 32;
+			const uint64_t bitflip = (read64(Secret + 8) ^ read64(Secret + 16)) - seed;
+			return rrmxmx((read32(input + len - 4) + (read32(input) << 32)) ^ bitflip, len);
+		} else if (len > 0) {
+			const uint64_t combined = (static_cast<uint64_t>(static_cast<unsigned char>(input[0])) << 16)
+			                        | (static_cast<uint64_t>(static_cast<unsigned char>(input[len >> 1])) << 24)
+			                        | static_cast<uint64_t>(static_cast<unsigned char>(input[len - 1]))
+			                        | (len << 8);
+			return avalanche64(combined ^ ((read32(Secret) ^ read32(Secret + 4)) + seed));
+		} else {
+			return avalanche64(seed ^ read64(Secret + 56) ^ read64(Secret + 64));
+		}
+	}
+
+	static constexpr uint64_t hashMid(const char * input, size_t len, uint64_t seed) {
+		uint64_t acc = len * Prime64_1;
+		if (len <= 128) {
+			for (size_t i = (len - 1) / 32 + 1; i-- > 0;) {
+				acc += mix16(input + 16 * i, Secret + 32 * i, seed);
+				acc += mix16(input + len - 16 * (i + 1), Secret + 32 * i + 16, seed);
+			}
+			return avalanche(acc);
+		} else {
+			for (size_t i = 0; i < 8; i++)
+				acc += mix16(input + 16 * i, Secret + 16 * i, seed);
+			acc = avalanche(acc);
+			uint64_t accEnd = mix16(input + len - 16, Secret + 136 - 17, seed);
+			for (size_t i = 8; i < len / 16; i++)
+				accEnd += mix16(input + 16 * i, Secret + 16 * (i - 8) + 3, seed);
+			return avalanche(acc + accEnd);
+		}
+	}
+
+	static constexpr Hash128 hashShort128(const char * input, size_t len, uint64_t seed) {
+		if (len > 8) {
+			const uint64_t bitflipLow = (read64(Secret + 32) ^ read64(Secret + 40)) - seed;
+			const uint64_t bitflipHigh = (read64(Secret + 48) ^ read64(Secret + 56)) + seed;
+			const uint64_t low = read64(input);
+			const uint64_t high = read64(input + len - 8) ^ bitflipHigh;
+			Hash128 m = multiply(low ^ read64(input + len - 8) ^ bitflipLow, Prime64_1);
+			m.low += static_cast<uint64_t>(len - 1) << 54;
+			m.high += high + (high & 0xffffffff) * (Prime32_2 - 1);
+			m.low ^= __builtin_bswap64(m.high);
+			Hash128 h = multiply(m.low, Prime64_2);
+			h.high += m.high * Prime64_2;
+			return { avalanche(h.low), avalanche(h.high) };
+		} else if (len >= 4) {
+			seed ^= static_cast<uint64_t>(__builtin_bswap32(static_cast<uint32_t>(seed))) << 32;
+			const uint64_t bitflip = (read64(Secret + 16) ^ read64(Secret + 24)) + seed;
+			Hash128 m = multiply((read32(input) + (read32(input + len - 4) << 32)) ^ bitflip, Prime64_1 + (len << 2));
+			m.high += m.low << 1;
+			m.low ^= m.high >> 3;
+			m.low ^= m.low >> 35;
+			m.low *= PrimeMx2;
+			m.low ^= m.low >> 28;
+			return { m.low, avalanche(m.high) };
+		} else if (len > 0) {
+			const uint32_t combined = (static_cast<uint32_t>(static_cast<unsigned char>(input[0])) << 16)
+			                        | (static_cast<uint32_t>(static_cast<unsigned char>(input[len >> 1])) << 24)
+			                        | static_cast<uint32_t>(static_cast<unsigned char>(input[len - 1]))
+			                        | static_cast<uint32_t>(len << 8);
+			const uint64_t combinedHigh = rotateLeft32(__builtin_bswap32(combined), 13);
+			return {
+				avalanche64(combined ^ ((read32(Secret) ^ read32(Secret + 4)) + seed)),
+				avalanche64(combinedHigh ^ ((read32(Secret + 8) ^ read32(Secret + 12)) - seed))
+			};
+		} else {
+			return {
+				avalanche64(seed ^ read64(Secret + 64) ^ read64(Secret + 72)),
+				avalanche64(seed ^ read64(Secret + 80) ^ read64(Secret + 88))
+			};
+		}
+	}
+
+	static constexpr Hash128 hashMid128(const char * input, size_t len, uint64_t seed) {
+		Hash128 acc = { len * Prime64_1, 0 };
+		if (len <= 128) {
+			for (size_t i = (len - 1) / 32 + 1; i-- > 0;)
+				acc = mix32(acc, input + 16 * i, input + len - 16 * (i + 1), Secret + 32 * i, seed);
+		} else {
+			for (size_t i = 32; i < 160; i += 32)
+				acc = mix32(acc, input + i - 32, input + i - 16, Secret + i - 32, seed);
+			acc = { avalanche(acc.low), avalanche(acc.high) };
+			for (size_t i = 160; i <= len; i += 32)
+				acc = mix32(acc, input + i - 32, input + i - 16, Secret + 3 + i - 160, seed);
+			acc = mix32(acc, input + len - 16, input + len - 32, Secret + 136 - 17 - 16, 0 - seed);
+		}
+		return {
+			avalanche(acc.low + acc.high),
+			0 - avalanche(acc.low * Prime64_1 + acc.high * Prime64_4 + (len - seed) * Prime64_2)
+		};
+	}
+
+	/// hash inputs longer than 240 bytes (using SIMD kernels)
+	static uint64_t hashLong(const void * input, size_t length, uint64_t seed);
+	static Hash128 hashLong128(const void * input, size_t length, uint64_t seed);
+
+	/// accumulate the final stripes of a streamed input
+	void digestLong(uint64_t * result, const unsigned char * sec) const;
+
+ public:
+	/*! \brief create new XXH3 hash
+	 *  \param seed your seed value, even zero is a valid seed
+	 */
+	explicit XXHash3(uint64_t seed = 0) {
+		reset(seed);
+	}
+
+	/*! \brief reset to initial state
+	 *  \param seed new seed value
+	 */
+	void reset(uint64_t seed = 0);
+
+	/*! \brief add a chunk of zero bytes
+	 * \param length number of zero bytes
+	 * \return `false` if length is zero
+	 */
+	bool addZeros(uint64_t length);
+
+	/*! \brief add a chunk of bytes
+	 * \param input pointer to a continuous block of data (or nullptr to add zeros)
+	 * \param length number of bytes
+	 * \return `false` if parameters are invalid / zero
+	 */
+	bool add(const void* input, uint64_t length);
+
+	/*! \brief add a chunk of bytes
+	 * \param input address of a continuous block of data (or `0` to add zeros)
+	 * \param length number of bytes
+	 * \return `false` if parameters are invalid / zero
+	 */
+	bool add(const uintptr_t input, uint64_t length) {
+		return add(reinterpret_cast<const void*>(input), length);
+	}
+
+	template<typename T>
+	bool add(T input) {
+		return add(&input, sizeof(T));
+	}
+
+	template<size_t CAPACITY>
+	bool add(const ByteBuffer<CAPACITY> & bb) {
+		return add(bb.buffer(), bb.size());
+	}
+
+	/*! \brief get current hash
+	 * \return 64 bit XXH3 hash
+	 */
+	uint64_t hash() const;
+
+	/*! \brief get current hash
+	 * \return 128 bit XXH3 hash
+	 */
+	Hash128 hash128() const;
+
+	/*! \brief 64 bit hash of a continuous block of data (one-shot)
+	 * \note constant expression for inputs up to 240 bytes
+	 * \param  input  pointer to a continuous block of data
+	 * \param  length number of bytes
+	 * \param  seed your seed value, e.g. zero is a valid seed
+	 * \return 64 bit XXH3 hash
+	 */
+	static constexpr uint64_t hash(const char* input, size_t length, uint64_t seed = 0) {
+		if (length <= 16)
+			return hashShort(input, length, seed);
+		else if (length <= MidSizeMax)
+			return hashMid(input, length, seed);
+		else
+			return hashLong(input, length, seed);
+	}
+
+	static uint64_t hash(const void* input, size_t length, uint64_t seed = 0) {
+		return hash(static_cast<const char*>(input), length, seed);
+	}
+
+	/*! \brief 128 bit hash of a continuous block of data (one-shot)
+	 * \note constant expression for inputs up to 240 bytes
+	 * \param  input  pointer to a continuous block of data
+	 * \param  length number of bytes
+	 * \param  seed your seed value, e.g. zero is a valid seed
+	 * \return 128 bit XXH3 hash
+	 */
+	static constexpr Hash128 hash128(const char* input, size_t length, uint64_t seed = 0) {
+		if (length <= 16)
+			return hashShort128(input, length, seed);
+		else if (length <= MidSizeMax)
+			return hashMid128(input, length, seed);
+		else
+			return hashLong128(input, length, seed);
+	}
+
+	static Hash128 hash128(const void* input, size_t length, uint64_t seed = 0) {
+		return hash128(static_cast<const char*>(input), length, seed);
+	}
+};
+
+template<>
+inline bool XXHash3::add<const char *>(const char *input) {
+	size_t len = 0;
+	for (const char * s = input; s != nullptr && *s++ != '\0'; len++) {}
+	return add(input, len);
+}
@@ -41,6 +41,38 @@ extern "C" void *realloc(void *ptr, size_t size);
  */
 extern "C" void *calloc(size_t nmemb, size_t size);
 
+/*! \brief Allocate an aligned memory block
+ * The memory is not initialized.
+ *
+ * \param alignment Alignment (power of two)
+ * \param size Requested size of memory in bytes.
+ * \return Pointer to memory or `nullptr` on error
+ */
+extern "C" void *aligned_alloc(size_t alignment, size_t size);
+
+/*! \brief Allocate an aligned memory block
+ * The memory is not initialized.
+ *
+ * \param memptr Pointer to store the address of the allocated memory
+ * \param alignment Alignment (power of two multiple of `sizeof(void *)`)
+ * \param size Requested size of memory in bytes.
+ * \return `0` on success, `EINVAL` for invalid alignment or `ENOMEM`
+ */
+extern "C" int posix_memalign(void **memptr, size_t alignment, size_t size);
+
+/*! \brief Allocate an aligned memory block (obsolete)
+ * \param alignment Alignment (power of two)
+ * \param size Requested size of memory in bytes.
+ * \return Pointer to memory or `nullptr` on error
+ */
+extern "C" void *memalign(size_t alignment, size_t size);
+
+/*! \brief Get the usable size of an allocated memory block
+ * \param ptr Pointer to an previously allocated memory block.
+ * \return Number of usable bytes
+ */
+extern "C" size_t malloc_usable_size(void *ptr);
+
 
 extern "C" int rand();
 extern "C" void srand(unsigned int seed);
@@ -45,6 +45,8 @@ namespace Allocator {
  * allocates memory within a fixed linear address range. It spans the address
  * range with a binary tree that tracks free space. Both `malloc` and `free`
  * are O(log N) time where N is the maximum possible number of allocations.
+ * The bucket for a request is determined in constant time, and a bitmap of
+ * non-empty buckets allows finding the block to split without scanning.
  *
  * The "buddy" term comes from how the tree is used. When memory is allocated,
  * nodes in the tree are split recursively until a node of the appropriate size
@@ -65,8 +67,12 @@ namespace Allocator {
  *                         Returns a pointer to the new start address if the
  *                         requested memory was successfully reserved,
  *                         otherwise `0`.
+ * \tparam ALIGN_LOG2      binary logarithm value of the maximum alignment of
+ *                         the returned memory: The address of an allocation
+ *                         is aligned to its block size, but at most to this
+ *                         value (has to be at least 4 = 16 bytes)
  */
-template<size_t MIN_ALLOC_LOG2, size_t MAX_ALLOC_LOG2, uintptr_t RESERVE(size_t, uintptr_t &)>
+template<size_t MIN_ALLOC_LOG2, size_t MAX_ALLOC_LOG2, uintptr_t RESERVE(size_t, uintptr_t &), size_t ALIGN_LOG2 = 4>
 class Buddy {
 	/*! \brief Header
 	 * Every allocation needs an header to store the allocation size while
@@ -86,6 +92,10 @@ class Buddy {
 	 */
 	static const size_t MAX_ALLOC = static_cast<size_t>(1) << MAX_ALLOC_LOG2;
 
+	/*! \brief Maximum alignment of returned addresses
+	 */
+	static const size_t ALIGN = static_cast<size_t>(1) << ALIGN_LOG2;
+
 	/*! \brief Free List structure
 	 * Free lists are stored as circular doubly-linked lists. Every possible
 	 * allocation size has an associated free list that is threaded through all
@@ -140,6 +150,13 @@ class Buddy {
 		List * pop() {
 			return prev == this ? nullptr : prev->remove();
 		}
+
+		/*! \brief Check if the list is empty
+		 * \return `true` if there is no entry in the list
+		 */
+		bool empty() const {
+			return next == this;
+		}
 	};
 
 
@@ -160,6 +177,12 @@ class Buddy {
 	 */
 	List * buckets;
 
+	/*! \brief Bitmap of buckets with a non-empty free list
+	 * Bit `n` is set if the free list of the bucket with index `n` contains
+	 * at least one entry.
+	 */
+	size_t non_empty;
+
 
 	/*! \brief Allocation size
 	 * We could initialize the allocator by giving it one free block the size of
@@ -212,6 +235,10 @@ class Buddy {
 	 */
 	uintptr_t max_ptr;
 
+	/*! \brief Size of all allocated blocks
+	 */
+	size_t allocated;
+
 
 	/*! \brief Prepare request for more reserved memory
 	 * \param new_value the requested new end for the reserved memory -- all
@@ -264,15 +291,53 @@ class Buddy {
 	}
 
 	/*! \brief Get the smallest bucket for the requested size
+	 * The binary logarithm of the request (rounded up) is determined using
+	 * count leading zeros.
 	 * \param the requested size passed to malloc
 	 * \param index of the smallest bucket that can fit that size
 	 */
-	size_t bucket_for_request(size_t request) const {
-		size_t bucket = BUCKET_COUNT - 1;
-		for (size_t size = MIN_ALLOC; size < request; size *= 2) {
-			bucket--;
-		}
-		return bucket;
+	static size_t bucket_for_request(size_t request) {
+		if (request <= MIN_ALLOC)
+			return BUCKET_COUNT - 1;
+		return MAX_ALLOC_LOG2 - (8 * sizeof(size_t) - __builtin_clzl(request - 1));
+	}
+
+	/*! \brief Clear the free list of a bucket
+	 * \param bucket bucket index
+	 */
+	void bucket_clear(size_t bucket) {
+		buckets[bucket].clear();
+		non_empty &= ~(static_cast<size_t>(1) << bucket);
+	}
+
+	/*! \brief Append an entry to the free list of a bucket
+	 * \param bucket bucket index
+	 * \param entry new list entry
+	 */
+	void bucket_push(size_t bucket, List * entry) {
+		buckets[bucket].push(entry);
+		non_empty |= static_cast<size_t>(1) << bucket;
+	}
+
+	/*! \brief Remove an entry from the free list of a bucket
+	 * \param bucket bucket index
+	 * \param entry list entry of the bucket
+	 */
+	void bucket_remove(size_t bucket, List * entry) {
+		entry->remove();
+		if (buckets[bucket].empty())
+			non_empty &= ~(static_cast<size_t>(1) << bucket);
+	}
+
+	/*! \brief Remove and return the first entry in the free list of a bucket
+	 * \param bucket bucket index
+	 * \return the first entry or nullptr if the list is empty.
+	 */
+	List * bucket_pop(size_t bucket) {
+		List * entry = buckets[bucket].pop();
+		if (buckets[bucket].empty())
+			non_empty &= ~(static_cast<size_t>(1) << bucket);
+		return entry;
 	}
 
 	/*
@@ -289,9 +354,9 @@ class Buddy {
 			// clear the root free list, increase the bucket limit, and add a single
 			// block with the newly-expanded address space to the new root free list.
 			if (!parent_is_split(root)) {
-				reinterpret_cast<List*>(base_ptr)->remove();
-				buckets[--bucket_limit].clear();
-				buckets[bucket_limit].push(reinterpret_cast<List*>(base_ptr));
+				bucket_remove(bucket_limit, reinterpret_cast<List*>(base_ptr));
+				bucket_clear(--bucket_limit);
+				bucket_push(bucket_limit, reinterpret_cast<List*>(base_ptr));
 				continue;
 			}
 
@@ -305,8 +370,8 @@ class Buddy {
 			if (!update_max_ptr(reinterpret_cast<uintptr_t>(right_child) + sizeof(List))) {
 				return 0;
 			}
-			buckets[bucket_limit].push(right_child);
-			buckets[--bucket_limit].clear();
+			bucket_push(bucket_limit, right_child);
+			bucket_clear(--bucket_limit);
 
 			// Set the grandparent's SPLIT flag so if we need to lower the bucket limit
 			// again, we'll know that the new root node we just added is in use.
@@ -338,17 +403,17 @@ class Buddy {
 		if (base_ptr == 0) {
 			// GNU Libc: The address of a block returned by malloc or realloc
 			// in GNU systems is always a multiple of eight (or sixteen on 64-bit systems).
-			// Hence, `align_size` represents our target alignment.
-			size_t align_size = 2 * sizeof(void*);
-			if ((buckets = reinterpret_cast<List*>(RESERVE((BUCKET_COUNT + 1) * sizeof(List) + 2 * align_size, max_ptr))) == 0) {
+			// Hence, `ALIGN` (at least 16 bytes) represents our target alignment.
+			if ((buckets = reinterpret_cast<List*>(RESERVE((BUCKET_COUNT + 1) * sizeof(List) + 2 * ALIGN, max_ptr))) == 0) {
 				return 0;
 			}
 			// By modifing our base_ptr we can achieve a correct alignment for all calls
-			base_ptr = Math::align_up(reinterpret_cast<uintptr_t>(buckets + BUCKET_COUNT), align_size) + align_size - HEADER_SIZE;
+			base_ptr = Math::align_up(reinterpret_cast<uintptr_t>(buckets + BUCKET_COUNT) + HEADER_SIZE, ALIGN) - HEADER_SIZE;
 
 			bucket_limit = BUCKET_COUNT - 1;
-			buckets[BUCKET_COUNT - 1].clear();
-			buckets[BUCKET_COUNT - 1].push(reinterpret_cast<List *>(base_ptr));
+			non_empty = 0;
+			bucket_clear(BUCKET_COUNT - 1);
+			bucket_push(BUCKET_COUNT - 1, reinterpret_cast<List *>(base_ptr));
 		}
 
 		// Find the smallest bucket that will fit this request. This doesn't check
@@ -356,80 +421,81 @@ class Buddy {
 		size_t bucket = bucket_for_request(request + HEADER_SIZE);
 		size_t original_bucket = bucket;
 
-		// Search for a bucket with a non-empty free list that's as large or larger
-		// than what we need. If there isn't an exact match, we'll need to split a
-		// larger one to get a match.
-		while (bucket + 1 != 0) {
-			// We may need to grow the tree to be able to fit an allocation of this
-			// size. Try to grow the tree and stop here if we can't.
-			if (!lower_bucket_limit(bucket)) {
-				return 0;
-			}
-
-			// Try to pop a block off the free list for this bucket. If the free list
-			// is empty, we're going to have to split a larger block instead.
-			uintptr_t ptr = reinterpret_cast<uintptr_t>(buckets[bucket].pop());
-			if (ptr == 0) {
-				// If we're not at the root of the tree or it's impossible to grow the
-				// tree any more, continue on to the next bucket.
-				if (bucket != bucket_limit || bucket == 0) {
-					bucket--;
-					continue;
-				}
+		// We may need to grow the tree to be able to fit an allocation of this
+		// size. Try to grow the tree and stop here if we can't.
+		if (!lower_bucket_limit(bucket)) {
+			return 0;
+		}
 
-				// Otherwise, grow the tree one more level and then pop a block off the
-				// free list again. Since we know the root of the tree is used (because
-				// the free list was empty), this will add a parent above this node in
-				// the SPLIT state and then add the new right child node to the free list
-				// for this bucket. Popping the free list will give us this right child.
-				if (!lower_bucket_limit(bucket - 1)) {
-					return 0;
-				}
-				ptr = reinterpret_cast<uintptr_t>(buckets[bucket].pop());
+		// Search for the smallest bucket with a non-empty free list that's as
+		// large or larger than what we need (i.e., the highest set bit in the
+		// bitmap up to the bucket of the request). If there isn't an exact match,
+		// we'll need to split a larger one to get a match.
+		uintptr_t ptr;
+		size_t available = non_empty & ((static_cast<size_t>(2) << bucket) - 1);
+		if (available != 0) {
+			bucket = 8 * sizeof(size_t) - 1 - __builtin_clzl(available);
+			ptr = reinterpret_cast<uintptr_t>(bucket_pop(bucket));
+		} else {
+			// All free lists up to the root of the tree are empty. If it's impossible
+			// to grow the tree any more, we are out of memory.
+			bucket = bucket_limit;
+			if (bucket == 0) {
+				return 0;
 			}
 
-			// Try to expand the address space first before going any further. If we
-			// have run out of space, put this block back on the free list and fail.
-			size_t size = static_cast<size_t>(1) << (MAX_ALLOC_LOG2 - bucket);
-			size_t bytes_needed = bucket < original_bucket ? size / 2 + sizeof(List) : size;
-			if (!update_max_ptr(ptr + bytes_needed)) {
-				buckets[bucket].push(reinterpret_cast<List *>(ptr));
+			// Otherwise, grow the tree one more level and then pop a block off the
+			// free list of the former root. Since we know the root of the tree is
+			// used (because the free list was empty), this will add a parent above
+			// this node in the SPLIT state and then add the new right child node to
+			// the free list for this bucket. Popping the free list will give us this
+			// right child.
+			if (!lower_bucket_limit(bucket - 1)) {
 				return 0;
 			}
+			ptr = reinterpret_cast<uintptr_t>(bucket_pop(bucket));
+		}
 
-			// If we got a node off the free list, change the node from UNUSED to USED.
-			// This involves flipping our parent's "is split" bit because that bit is
-			// the exclusive-or of the UNUSED flags of both children, and our UNUSED
-			// flag (which isn't ever stored explicitly) has just changed.
-
-			// Note that we shouldn't ever need to flip the "is split" bit of our
-			// grandparent because we know our buddy is USED so it's impossible for our
-			// grandparent to be UNUSED (if our buddy chunk was UNUSED, our parent
-			// wouldn't ever have been split in the first place).
-			size_t i = node_for_ptr(ptr, bucket);
-			if (i != 0) {
-				flip_parent_is_split(i);
-			}
+		// Try to expand the address space first before going any further. If we
+		// have run out of space, put this block back on the free list and fail.
+		size_t size = static_cast<size_t>(1) << (MAX_ALLOC_LOG2 - bucket);
+		size_t bytes_needed = bucket < original_bucket ? size / 2 + sizeof(List) : size;
+		if (!update_max_ptr(ptr + bytes_needed)) {
+			bucket_push(bucket, reinterpret_cast<List *>(ptr));
+			return 0;
+		}
 
-			// If the node we got is larger than we need, split it down to the correct
-			// size and put the new unused child nodes on the free list in the
-			// corresponding bucket. This is done by repeatedly moving to the left
-			// child, splitting the parent, and then adding the right child to the free
-			// list.
-			while (bucket < original_bucket) {
-				i = i * 2 + 1;
-				bucket++;
-				flip_parent_is_split(i);
-				buckets[bucket].push(ptr_for_node(i + 1, bucket));
-			}
+		// If we got a node off the free list, change the node from UNUSED to USED.
+		// This involves flipping our parent's "is split" bit because that bit is
+		// the exclusive-or of the UNUSED flags of both children, and our UNUSED
+		// flag (which isn't ever stored explicitly) has just changed.
+
+		// Note that we shouldn't ever need to flip the "is split" bit of our
+		// grandparent because we know our buddy is USED so it's impossible for our
+		// grandparent to be UNUSED (if our buddy chunk was UNUSED, our parent
+		// wouldn't ever have been split in the first place).
+		size_t i = node_for_ptr(ptr, bucket);
+		if (i != 0) {
+			flip_parent_is_split(i);
+		}
 
-			// Now that we have a memory address, write the block header (just the size
-			// of the allocation) and return the address immediately after the header.
-			*reinterpret_cast<size_t *>(ptr) = request;
-			return ptr + HEADER_SIZE;
+		// If the node we got is larger than we need, split it down to the correct
+		// size and put the new unused child nodes on the free list in the
+		// corresponding bucket. This is done by repeatedly moving to the left
+		// child, splitting the parent, and then adding the right child to the free
+		// list.
+		while (bucket < original_bucket) {
+			i = i * 2 + 1;
+			bucket++;
+			flip_parent_is_split(i);
+			bucket_push(bucket, ptr_for_node(i + 1, bucket));
 		}
 
-		return 0;
+		// Now that we have a memory address, write the block header (just the size
+		// of the allocation) and return the address immediately after the header.
+		*reinterpret_cast<size_t *>(ptr) = request;
+		allocated += static_cast<size_t>(1) << (MAX_ALLOC_LOG2 - original_bucket);
+		return ptr + HEADER_SIZE;
 	}
 
 	/*! \brief Resize memory (only possible if it will stay in the same bucket)
@@ -459,6 +525,7 @@ class Buddy {
 			ptr -= HEADER_SIZE;
 			size_t bucket = bucket_for_request(*reinterpret_cast<size_t *>(ptr) + HEADER_SIZE);
 			size_t i = node_for_ptr(ptr, bucket);
+			allocated -= static_cast<size_t>(1) << (MAX_ALLOC_LOG2 - bucket);
 
 			// Traverse up to the root node, flipping USED blocks to UNUSED and merging
 			// UNUSED buddies together into a single UNUSED parent.
@@ -490,7 +557,7 @@ class Buddy {
 				 * add the merged parent to its free list yet. That will be done once after
 				 * this loop is finished.
 				 */
-				ptr_for_node(((i - 1) ^ 1) + 1, bucket)->remove();
+				bucket_remove(bucket, ptr_for_node(((i - 1) ^ 1) + 1, bucket));
 				i = (i - 1) / 2;
 				bucket--;
 			}
@@ -499,10 +566,18 @@ class Buddy {
 			// list because "malloc" takes from the back of the list and we want a "free"
 			// followed by a "malloc" of the same size to ideally use the same address
 			// for better memory locality.
-			buckets[bucket].push(ptr_for_node(i, bucket));
+			bucket_push(bucket, ptr_for_node(i, bucket));
 		}
 	}
 
+	/*! \brief Size of the block serving a request
+	 * \param request the size passed to malloc
+	 * \return size of the block (including header)
+	 */
+	static size_t block_size(size_t request) {
+		return static_cast<size_t>(1) << (MAX_ALLOC_LOG2 - bucket_for_request(request + HEADER_SIZE));
+	}
+
 	/*! \brief Retrieve the allocated size
 	 * \brief ptr pointer to the start of the allocated memory
 	 * \return size of the allocated memory or `0` if invalid
@@ -511,9 +586,66 @@ class Buddy {
 		return ptr == 0 || ptr < base_ptr || ptr > max_ptr ? 0 : *reinterpret_cast<size_t *>(ptr - HEADER_SIZE);
 	}
 
+	/*! \brief Size of the reserved memory
+	 * \return number of bytes reserved using the callback function
+	 */
+	size_t reserved() const {
+		return base_ptr == 0 ? 0 : max_ptr - reinterpret_cast<uintptr_t>(buckets);
+	}
+
+	/*! \brief Current size of the tree
+	 * The tree grows by lowering the bucket limit.
+	 * \return size of address space covered by the tree
+	 */
+	size_t tree_size() const {
+		return base_ptr == 0 ? 0 : static_cast<size_t>(1) << (MAX_ALLOC_LOG2 - bucket_limit);
+	}
+
+	/*! \brief Size of free memory in the tree
+	 * \return number of bytes not allocated (including not yet reserved memory)
+	 */
+	size_t free_size() const {
+		return tree_size() - allocated;
+	}
+
+	/*! \brief Visit the unused memory of all free blocks with a minimum size
+	 * The free list entry at the begin of each block and the memory which is
+	 * not reserved yet are excluded.
+	 * \param min_size_log2 binary logarithm value of the minimum block size
+	 * \param visit callback with start address and size of unused memory
+	 */
+	template<typename F>
+	void foreach_unused(size_t min_size_log2, F visit) const {
+		if (base_ptr != 0)
+			for (size_t bucket = bucket_limit; bucket < BUCKET_COUNT && MAX_ALLOC_LOG2 - bucket >= min_size_log2; bucket++)
+				for (const List * entry = buckets[bucket].next; entry != &buckets[bucket]; entry = entry->next) {
+					uintptr_t start = reinterpret_cast<uintptr_t>(entry + 1);
+					uintptr_t end = Math::min(reinterpret_cast<uintptr_t>(entry) + (static_cast<size_t>(1) << (MAX_ALLOC_LOG2 - bucket)), max_ptr);
+					if (start < end)
+						visit(start, end - start);
+				}
+	}
+
+	/*! \brief Count free blocks of a certain size
+	 * \param size_log2 binary logarithm value of the block size
+	 * \return number of blocks in the free list of the corresponding bucket
+	 */
+	size_t free_blocks(size_t size_log2) const {
+		size_t blocks = 0;
+		if (base_ptr != 0 && size_log2 >= MIN_ALLOC_LOG2 && size_log2 <= MAX_ALLOC_LOG2) {
+			size_t bucket = MAX_ALLOC_LOG2 - size_log2;
+			if (bucket >= bucket_limit && (non_empty & (static_cast<size_t>(1) << bucket)) != 0)
+				for (const List * entry = buckets[bucket].next; entry != &buckets[bucket]; entry = entry->next)
+					blocks++;
+		}
+		return blocks;
+	}
+
 	// Sanity checks
 	static_assert(MIN_ALLOC >= sizeof(List), "Minimum allocation size has to be at least the size of a List item!");
 	static_assert(MIN_ALLOC_LOG2 < MAX_ALLOC_LOG2, "Minimum allocation has to be smaller than maximum allocation size!");
+	static_assert(BUCKET_COUNT <= 8 * sizeof(size_t), "Too many buckets for bitmap!");
+	static_assert(ALIGN_LOG2 >= 4 && ALIGN_LOG2 < MAX_ALLOC_LOG2, "Alignment has to be at least 16 bytes and smaller than maximum allocation size!");
 };
 
 }  // namespace Allocator
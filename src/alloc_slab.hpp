@@ -0,0 +1,303 @@
+// Dirty Little Helper (DLH) - system support library for C/C++
+// Copyright 2021-2023 by Bernhard Heinloth <heinloth@cs.fau.de>
+// SPDX-License-Identifier: AGPL-3.0-or-later
+
+/*! \file
+ *  \brief A \ref Allocator::Slab "slab allocator" for small objects
+ */
+
+#pragma once
+
+#include <dlh/types.hpp>
+#include <dlh/math.hpp>
+#include <dlh/assert.hpp>
+
+namespace Allocator {
+
+/*! \brief Slab Allocator Template
+ *
+ * Small objects are grouped in size classes (in steps of the granularity of
+ * 16 bytes). Each class allocates pages (slabs) from a backing allocator and
+ * carves them into objects of the same size.
+ * Free objects of a page are tracked in a singly-linked free list (threaded
+ * through the free objects), never used objects are handed out by bumping a
+ * pointer, hence a new page is only touched on demand.
+ *
+ * Pages have to be aligned to their size, which allows to get the page
+ * (containing the meta data) of an object in constant time.
+ * Objects start at a 64 byte boundary in the page, hence objects with a size
+ * of a multiple of 32 or 64 bytes are aligned accordingly.
+ * A bitmap with a bit for each page in the managed address area is used to
+ * check if an address belongs to this allocator.
+ *
+ * \tparam MAX_SIZE    maximum size of an object (multiple of 16 bytes)
+ * \tparam PAGE_LOG2   binary logarithm value of the page size
+ * \tparam AREA_LOG2   binary logarithm value of the address range size of the
+ *                     backing allocator (all pages must be within an area
+ *                     starting at the aligned address of the first page)
+ * \tparam PAGE_ALLOC  Callback function to allocate a page with the requested
+ *                     size, the returned address has to be aligned to the
+ *                     page size. Returns `0` on failure.
+ * \tparam PAGE_FREE   Callback function to free a page
+ */
+template<size_t MAX_SIZE, size_t PAGE_LOG2, size_t AREA_LOG2, uintptr_t PAGE_ALLOC(size_t), void PAGE_FREE(uintptr_t)>
+class Slab {
+	/*! \brief Size class step and alignment of objects
+	 */
+	static const size_t GRANULARITY = 16;
+
+	/*! \brief Number of size classes
+	 */
+	static const size_t CLASSES = MAX_SIZE / GRANULARITY;
+
+	/*! \brief Size of a page (including meta data)
+	 */
+	static const size_t PAGE_SIZE = static_cast<size_t>(1) << PAGE_LOG2;
+
+	/*! \brief Bytes at the end of each page which are not requested
+	 * The backing allocator might store meta data of the adjacent memory
+	 * there (e.g., the header of the next block)
+	 */
+	static const size_t PAGE_RESERVE = GRANULARITY;
+
+	/*! \brief Maximum number of pages in the area
+	 * The area is twice the size of the backing allocators address range,
+	 * since its start is aligned down.
+	 */
+	static const size_t PAGES = static_cast<size_t>(2) << (AREA_LOG2 - PAGE_LOG2);
+
+	/*! \brief Free object
+	 */
+	struct Object {
+		Object * next;
+	};
+
+	/*! \brief Page meta data (stored at the begin of each page)
+	 */
+	struct Page {
+		/*! \brief Previous page with free objects in the same class */
+		Page * prev;
+
+		/*! \brief Next page with free objects in the same class */
+		Page * next;
+
+		/*! \brief List of freed objects */
+		Object * free;
+
+		/*! \brief Address of the next never used object */
+		uintptr_t unused;
+
+		/*! \brief Number of objects in use */
+		uint32_t used;
+
+		/*! \brief Size class of objects in this page */
+		uint32_t size_class;
+
+		/*! \brief Size of an object */
+		size_t object_size() const {
+			return (size_class + 1) * GRANULARITY;
+		}
+
+		/*! \brief Check if there are no free objects left */
+		bool full() const {
+			return free == nullptr && unused + object_size() > reinterpret_cast<uintptr_t>(this) + PAGE_SIZE - PAGE_RESERVE;
+		}
+	};
+
+	/*! \brief Offset of first object in page
+	 */
+	static const size_t PAGE_HEADER = Math::align_up(sizeof(Page), 64);
+
+	/*! \brief Pages with free objects for each size class
+	 */
+	Page * partial[CLASSES];
+
+	/*! \brief Start of the address area
+	 */
+	uintptr_t area;
+
+	/*! \brief Has the start of the address area been set?
+	 */
+	bool area_set;
+
+	/*! \brief Number of allocated pages
+	 */
+	size_t page_count;
+
+	/*! \brief Bitmap of all pages in the area used by this allocator
+	 */
+	uint8_t page_is_slab[PAGES / 8];
+
+	/*! \brief Get index of page in bitmap
+	 * \param ptr address within the page
+	 * \return index of page or `PAGES` if outside of area
+	 */
+	size_t page_index(uintptr_t ptr) const {
+		return !area_set || ptr < area ? PAGES : Math::min((ptr - area) >> PAGE_LOG2, PAGES);
+	}
+
+	/*! \brief Flip the bit of a page in bitmap
+	 * \param index index of page
+	 */
+	void flip_page_is_slab(size_t index) {
+		page_is_slab[index / 8] ^= 1 << (index % 8);
+	}
+
+	/*! \brief Get page of an object
+	 * \param ptr address of object
+	 * \return pointer to page
+	 */
+	static Page * page_for(uintptr_t ptr) {
+		return reinterpret_cast<Page *>(ptr & ~(PAGE_SIZE - 1));
+	}
+
+	/*! \brief Insert page at the front of the list of pages with free objects
+	 * \param page page to insert
+	 */
+	void link(Page * page) {
+		Page * & head = partial[page->size_class];
+		page->prev = nullptr;
+		page->next = head;
+		if (head != nullptr)
+			head->prev = page;
+		head = page;
+	}
+
+	/*! \brief Remove page from the list of pages with free objects
+	 * \param page page to remove
+	 */
+	void unlink(Page * page) {
+		if (page->prev == nullptr)
+			partial[page->size_class] = page->next;
+		else
+			page->prev->next = page->next;
+		if (page->next != nullptr)
+			page->next->prev = page->prev;
+	}
+
+	/*! \brief Allocate a new page for a size class
+	 * \param size_class size class of the page
+	 * \return pointer to page or `nullptr` on failure
+	 */
+	Page * add_page(size_t size_class) {
+		uintptr_t ptr = PAGE_ALLOC(PAGE_SIZE - PAGE_RESERVE);
+		if (ptr == 0)
+			return nullptr;
+		assert(ptr % PAGE_SIZE == 0);
+
+		if (!area_set) {
+			area = Math::align_down(ptr, static_cast<size_t>(1) << AREA_LOG2);
+			area_set = true;
+		}
+
+		size_t index = page_index(ptr);
+		if (index >= PAGES) {
+			PAGE_FREE(ptr);
+			return nullptr;
+		}
+		flip_page_is_slab(index);
+		page_count++;
+
+		Page * page = reinterpret_cast<Page *>(ptr);
+		page->free = nullptr;
+		page->unused = ptr + PAGE_HEADER;
+		page->used = 0;
+		page->size_class = size_class;
+		link(page);
+		return page;
+	}
+
+ public:
+	/*! \brief Maximum object size
+	 */
+	static const size_t MAX = MAX_SIZE;
+
+	/*! \brief Maximum alignment of objects
+	 * Objects are aligned to the largest power of two (up to this value)
+	 * dividing their size
+	 */
+	static const size_t ALIGN = PAGE_HEADER;
+
+	/*! \brief Allocate uninitialized memory
+	 * \param request the size for the memory (has to be greater than 0 and at most `MAX`)
+	 * \return address of the allocated memory or 0
+	 */
+	uintptr_t malloc(size_t request) {
+		assert(request > 0 && request <= MAX_SIZE);
+		size_t size_class = (request - 1) / GRANULARITY;
+
+		Page * page = partial[size_class];
+		if (page == nullptr && (page = add_page(size_class)) == nullptr)
+			return 0;
+
+		uintptr_t ptr;
+		if (page->free != nullptr) {
+			ptr = reinterpret_cast<uintptr_t>(page->free);
+			page->free = page->free->next;
+		} else {
+			ptr = page->unused;
+			page->unused += page->object_size();
+		}
+		page->used++;
+
+		if (page->full())
+			unlink(page);
+
+		return ptr;
+	}
+
+	/*! \brief Free allocated memory
+	 * \param ptr pointer to the start of a memory allocated using malloc
+	 */
+	void free(uintptr_t ptr) {
+		assert(owns(ptr));
+		Page * page = page_for(ptr);
+		bool was_full = page->full();
+
+		Object * object = reinterpret_cast<Object *>(ptr);
+		object->next = page->free;
+		page->free = object;
+		page->used--;
+
+		if (was_full) {
+			link(page);
+		} else if (page->used == 0 && (page->prev != nullptr || page->next != nullptr)) {
+			// Release empty page (but keep the last one of a size class)
+			unlink(page);
+			flip_page_is_slab(page_index(ptr));
+			page_count--;
+			PAGE_FREE(reinterpret_cast<uintptr_t>(page));
+		}
+	}
+
+	/*! \brief Check if memory was allocated by this allocator
+	 * \param ptr pointer to the start of the allocated memory
+	 * \return `true` if it is an object of this allocator
+	 */
+	bool owns(uintptr_t ptr) const {
+		size_t index = page_index(ptr);
+		return index < PAGES && ((page_is_slab[index / 8] >> (index % 8)) & 1) != 0;
+	}
+
+	/*! \brief Retrieve the usable size of allocated memory
+	 * \brief ptr pointer to the start of the allocated memory
+	 * \return size of the object or `0` if not allocated by this allocator
+	 */
+	size_t size(uintptr_t ptr) const {
+		return owns(ptr) ? page_for(ptr)->object_size() : 0;
+	}
+
+	/*! \brief Number of pages in use
+	 * \return number of pages allocated from the backing allocator
+	 */
+	size_t pages() const {
+		return page_count;
+	}
+
+	// Sanity checks
+	static_assert(MAX_SIZE % GRANULARITY == 0, "Maximum object size has to be a multiple of the granularity!");
+	static_assert(MAX_SIZE + PAGE_HEADER + PAGE_RESERVE <= PAGE_SIZE, "Page size too small for maximum object size!");
+	static_assert(PAGE_LOG2 < AREA_LOG2, "Page has to be smaller than area size!");
+};
+
+}  // namespace Allocator
@@ -0,0 +1,77 @@
+// Dirty Little Helper (DLH) - system support library for C/C++
+// Copyright 2021-2023 by Bernhard Heinloth <heinloth@cs.fau.de>
+// SPDX-License-Identifier: AGPL-3.0-or-later
+
+#include <dlh/arena.hpp>
+#include <dlh/log.hpp>
+
+namespace Memory {
+
+Arena::~Arena() {
+	for (Chunk * chunk = _first; chunk != nullptr; ) {
+		Chunk * next = chunk->next;
+		Memory::free(chunk);
+		chunk = next;
+	}
+}
+
+uintptr_t Arena::grow(size_t size, size_t alignment) {
+	// Use next (previously allocated) chunk if it is large enough
+	Chunk * next = _current == nullptr ? _first : _current->next;
+	if (next != nullptr) {
+		uintptr_t ptr = Math::align_up(next->begin(), alignment);
+		if (ptr <= next->end() && size <= next->end() - ptr) {
+			_current = next;
+			_top = ptr + size;
+			return _last = ptr;
+		}
+	}
+
+	// Allocate new chunk (inserted after current chunk)
+	size_t chunk_size = Math::max(_chunk_size, sizeof(Chunk) + size + (alignment > 16 ? alignment : 0));
+	Chunk * chunk = Memory::alloc<Chunk>(chunk_size);
+	if (chunk == nullptr) {
+		LOG_WARNING << "Arena allocation of " << chunk_size << " bytes failed" << endl;
+		return 0;
+	}
+	chunk->size = chunk_size;
+	chunk->next = next;
+	if (_current == nullptr)
+		_first = chunk;
+	else
+		_current->next = chunk;
+	_current = chunk;
+
+	uintptr_t ptr = Math::align_up(chunk->begin(), alignment);
+	_top = ptr + size;
+	return _last = ptr;
+}
+
+uintptr_t Arena::realloc(uintptr_t addr, size_t old_size, size_t size) {
+	if (addr == 0) {
+		return alloc(size);
+	} else if (size == 0) {
+		free(addr);
+		return 0;
+	} else if (addr == _last && size <= _current->end() - addr) {
+		// Resize most recent allocation in place
+		_top = addr + size;
+		return addr;
+	} else if (size <= old_size) {
+		return addr;
+	} else {
+		uintptr_t ptr = alloc(size);
+		if (ptr != 0)
+			Memory::copy(ptr, addr, old_size);
+		return ptr;
+	}
+}
+
+size_t Arena::reserved() const {
+	size_t size = 0;
+	for (Chunk * chunk = _first; chunk != nullptr; chunk = chunk->next)
+		size += chunk->size;
+	return size;
+}
+
+}  // namespace Memory
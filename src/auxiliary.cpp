@@ -7,6 +7,10 @@
 extern char **environ;
 
 Auxiliary * Auxiliary::begin() {
+	// Environment (and hence auxiliary vector) is not set before startup
+	if (environ == nullptr)
+		return nullptr;
+
 	static int envc = -1;
 	if (envc == -1) {
 		for (envc = 0; environ[envc] != nullptr; envc++) {}
@@ -18,6 +22,9 @@ Auxiliary * Auxiliary::begin() {
 Auxiliary * Auxiliary::data(Auxiliary::type type) {
 	// Read current auxiliary vectors
 	Auxiliary * auxv = begin();
+	if (auxv == nullptr)
+		return nullptr;
+
 	for (int auxc = 0 ; auxv[auxc].a_type != Auxiliary::AT_NULL; auxc++)
 		if (auxv[auxc].a_type == type)
 			return auxv + auxc;
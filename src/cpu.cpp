@@ -0,0 +1,286 @@
+// Dirty Little Helper (DLH) - system support library for C/C++
+// Copyright 2021-2023 by Bernhard Heinloth <heinloth@cs.fau.de>
+// SPDX-License-Identifier: AGPL-3.0-or-later
+
+#include <dlh/cpu.hpp>
+#include <dlh/auxiliary.hpp>
+#include <dlh/environ.hpp>
+
+#ifndef CPU_DISABLE_VARIABLE
+// Environment variable with comma separated list of features to disable
+#define CPU_DISABLE_VARIABLE "DLH_CPU_DISABLE"
+#endif
+
+extern char **environ;
+
+namespace Cpu {
+
+// Detected features (bit 31 marks completed detection)
+static const uint32_t DETECTED = 1U << 31;
+static uint32_t detected = 0;
+
+// Vendor identification (12 characters)
+static char vendor_id[13] = {};
+
+// Auxiliary vector
+static unsigned long hwcap_value = 0;
+static unsigned long hwcap2_value = 0;
+
+// Cache geometry
+static size_t line_size = 0;
+static size_t cache_sizes[3] = {};
+
+/*! \brief Register values of cpuid */
+struct Registers {
+	uint32_t eax, ebx, ecx, edx;
+};
+
+/*! \brief Query processor
+ * \param leaf leaf (`eax`)
+ * \param subleaf subleaf (`ecx`)
+ * \return register values
+ */
+static Registers cpuid(uint32_t leaf, uint32_t subleaf = 0) {
+	Registers r;
+	asm volatile("cpuid" : "=a"(r.eax), "=b"(r.ebx), "=c"(r.ecx), "=d"(r.edx) : "a"(leaf), "c"(subleaf));
+	return r;
+}
+
+/*! \brief Check bit in register value
+ * \param reg register value
+ * \param bit bit number
+ * \return `true` if set
+ */
+static inline bool bit(uint32_t reg, unsigned bit) {
+	return (reg & (1U << bit)) != 0;
+}
+
+/*! \brief Detect caches using deterministic cache parameters
+ * \param leaf cpuid leaf (`4` on Intel, `0x8000001d` on AMD)
+ */
+static void detect_caches(uint32_t leaf) {
+	for (uint32_t i = 0; i < 16; i++) {
+		Registers r = cpuid(leaf, i);
+		uint32_t type = r.eax & 0x1f;
+		if (type == 0)
+			break;
+		// Skip instruction caches
+		if (type == 2)
+			continue;
+		uint32_t level = (r.eax >> 5) & 0x7;
+		size_t line = (r.ebx & 0xfff) + 1;
+		size_t partitions = ((r.ebx >> 12) & 0x3ff) + 1;
+		size_t ways = (r.ebx >> 22) + 1;
+		size_t sets = static_cast<size_t>(r.ecx) + 1;
+		if (level >= 1 && level <= 3)
+			cache_sizes[level - 1] = ways * partitions * line * sets;
+		if (level == 1)
+			line_size = line;
+	}
+}
+
+/*! \brief Value of the auxiliary vector
+ * \param type entry type
+ * \return value or `0` if not available
+ */
+static unsigned long aux(Auxiliary::type type) {
+	return static_cast<unsigned long>(Auxiliary::vector(type).value());
+}
+
+/*! \brief Parse list of feature names
+ * \param list comma separated names (see \ref name)
+ * \return bit mask of features
+ * \note Must not use string functions (since they depend on the features)
+ */
+static uint32_t parse(const char * list) {
+	uint32_t mask = 0;
+	while (*list != '\0') {
+		size_t len = 0;
+		while (list[len] != '\0' && list[len] != ',')
+			len++;
+		for (uint32_t f = 1; f != 0 && f != DETECTED; f <<= 1) {
+			const char * n = name(static_cast<Feature>(f));
+			size_t i = 0;
+			while (n != nullptr && i < len && n[i] == list[i])
+				i++;
+			if (n != nullptr && i == len && n[i] == '\0')
+				mask |= f;
+		}
+		list += len;
+		if (*list == ',')
+			list++;
+	}
+	return mask;
+}
+
+void init() {
+	if (__atomic_load_n(&detected, __ATOMIC_RELAXED) != 0)
+		return;
+
+	// Auxiliary vector and environment are not available before startup,
+	// detection has to be repeated later (using the baseline until then)
+	if (environ == nullptr)
+		return;
+
+	uint32_t result = SSE2;
+
+	Registers r = cpuid(0);
+	const uint32_t max_leaf = r.eax;
+	const uint32_t id[3] = { r.ebx, r.edx, r.ecx };
+	for (size_t i = 0; i < 12; i++)
+		vendor_id[i] = static_cast<char>(id[i / 4] >> (8 * (i % 4)));
+	const bool intel = id[0] == 0x756e6547 && id[1] == 0x49656e69 && id[2] == 0x6c65746e;  // "GenuineIntel"
+	const bool amd = id[0] == 0x68747541 && id[1] == 0x69746e65 && id[2] == 0x444d4163;  // "AuthenticAMD"
+
+	const uint32_t max_ext_leaf = cpuid(0x80000000).eax;
+
+	if (max_leaf >= 1) {
+		r = cpuid(1);
+		if (bit(r.ecx, 0))
+			result |= SSE3;
+		if (bit(r.ecx, 9))
+			result |= SSSE3;
+		if (bit(r.ecx, 19))
+			result |= SSE4_1;
+		if (bit(r.ecx, 20))
+			result |= SSE4_2;
+		if (bit(r.ecx, 23))
+			result |= POPCNT;
+		if (bit(r.ecx, 25))
+			result |= AES;
+		// Line size for clflush (in 8 byte units)
+		line_size = ((r.ebx >> 8) & 0xff) * 8;
+
+		// Extended processor states have to be enabled by the OS (OSXSAVE and XCR0)
+		uint32_t xcr0 = 0;
+		if (bit(r.ecx, 27)) {
+			uint32_t xcr0_hi;
+			asm volatile("xgetbv" : "=a"(xcr0), "=d"(xcr0_hi) : "c"(0));
+		}
+		const bool avx_state = (xcr0 & 0x6) == 0x6;  // SSE and AVX
+		const bool avx512_state = avx_state && (xcr0 & 0xe0) == 0xe0;  // opmask and ZMM
+		if (avx_state && bit(r.ecx, 28))
+			result |= AVX;
+
+		if (max_leaf >= 7) {
+			r = cpuid(7);
+			if (bit(r.ebx, 3))
+				result |= BMI1;
+			if (avx_state && bit(r.ebx, 5))
+				result |= AVX2;
+			if (bit(r.ebx, 8))
+				result |= BMI2;
+			if (bit(r.ebx, 9))
+				result |= ERMS;
+			if (avx512_state && bit(r.ebx, 16))
+				result |= AVX512F;
+			if (avx512_state && bit(r.ebx, 30))
+				result |= AVX512BW;
+			if (bit(r.edx, 4))
+				result |= FSRM;
+		}
+	}
+
+	// Caches
+	if (intel && max_leaf >= 4) {
+		detect_caches(4);
+	} else if (amd && max_ext_leaf >= 0x8000001d && bit(cpuid(0x80000001).ecx, 22)) {
+		detect_caches(0x8000001d);
+	} else if (amd && max_ext_leaf >= 0x80000006) {
+		r = cpuid(0x80000005);
+		cache_sizes[0] = static_cast<size_t>(r.ecx >> 24) * 1024;
+		line_size = r.ecx & 0xff;
+		r = cpuid(0x80000006);
+		cache_sizes[1] = static_cast<size_t>(r.ecx >> 16) * 1024;
+		cache_sizes[2] = static_cast<size_t>(r.edx >> 18) * 512 * 1024;
+	}
+
+	// Auxiliary vector (cache information is only provided on some architectures)
+	hwcap_value = aux(Auxiliary::AT_HWCAP);
+	hwcap2_value = aux(Auxiliary::AT_HWCAP2);
+	const Auxiliary::type aux_cache[3] = { Auxiliary::AT_L1D_CACHESIZE, Auxiliary::AT_L2_CACHESIZE, Auxiliary::AT_L3_CACHESIZE };
+	for (size_t i = 0; i < 3; i++)
+		if (cache_sizes[i] == 0)
+			cache_sizes[i] = aux(aux_cache[i]);
+	if (line_size == 0)
+		line_size = aux(Auxiliary::AT_DCACHEBSIZE);
+	if (line_size == 0)
+		line_size = 64;
+
+	// Features disabled by user (SSE2 is required by x86_64)
+	const char * disabled = Environ::variable(CPU_DISABLE_VARIABLE);
+	if (disabled != nullptr)
+		result &= ~parse(disabled) | SSE2;
+
+	__atomic_store_n(&detected, result | DETECTED, __ATOMIC_RELEASE);
+}
+
+uint32_t features() {
+	uint32_t f = __atomic_load_n(&detected, __ATOMIC_ACQUIRE);
+	if (f == 0) {
+		init();
+		f = __atomic_load_n(&detected, __ATOMIC_ACQUIRE);
+		// Not detected yet (called before startup)
+		if (f == 0)
+			return SSE2;
+	}
+	return f & ~DETECTED;
+}
+
+bool initialized() {
+	return __atomic_load_n(&detected, __ATOMIC_ACQUIRE) != 0;
+}
+
+void disable(uint32_t mask) {
+	init();
+	// SSE2 is required by x86_64
+	__atomic_fetch_and(&detected, ~(mask & ~static_cast<uint32_t>(SSE2)), __ATOMIC_RELAXED);
+}
+
+const char * name(Feature feature) {
+	switch (feature) {
+		case SSE2:     return "sse2";
+		case SSE3:     return "pni";
+		case SSSE3:    return "ssse3";
+		case SSE4_1:   return "sse4_1";
+		case SSE4_2:   return "sse4_2";
+		case POPCNT:   return "popcnt";
+		case AES:      return "aes";
+		case AVX:      return "avx";
+		case AVX2:     return "avx2";
+		case BMI1:     return "bmi1";
+		case BMI2:     return "bmi2";
+		case ERMS:     return "erms";
+		case FSRM:     return "fsrm";
+		case AVX512F:  return "avx512f";
+		case AVX512BW: return "avx512bw";
+	}
+	return nullptr;
+}
+
+const char * vendor() {
+	init();
+	return vendor_id;
+}
+
+unsigned long hwcap() {
+	init();
+	return hwcap_value;
+}
+
+unsigned long hwcap2() {
+	init();
+	return hwcap2_value;
+}
+
+size_t cache_line() {
+	init();
+	return line_size;
+}
+
+size_t cache_size(unsigned level) {
+	init();
+	return level >= 1 && level <= 3 ? cache_sizes[level - 1] : 0;
+}
+
+}  // namespace Cpu
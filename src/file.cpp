@@ -5,6 +5,7 @@
 #include <dlh/file.hpp>
 
 #include <dlh/log.hpp>
+#include <dlh/hash.hpp>
 #include <dlh/string.hpp>
 #include <dlh/syscall.hpp>
 #include <dlh/stream/buffer.hpp>
@@ -216,6 +217,39 @@ Vector<const char *> lines(const char * path) {
 	return String::split_inplace(File::contents::get(path, size), '\n');
 }
 
+Optional<XXHash3::Hash128> hash(const char * path, unsigned threads) {
+	auto fd = Syscall::open(path, O_RDONLY);
+	if (fd.failed()) {
+		LOG_ERROR << "Opening file " << path << " failed: " << fd.error_message() << endl;
+		return Optional<XXHash3::Hash128>{};
+	}
+
+	struct stat sb;
+	auto fstat = Syscall::fstat(fd.value(), &sb);
+	if (fstat.failed()) {
+		LOG_ERROR << "Stat file " << path << " failed: " << fstat.error_message() << endl;
+		Syscall::close(fd.value());
+		return Optional<XXHash3::Hash128>{};
+	} else if (sb.st_size == 0) {
+		Syscall::close(fd.value());
+		return Optional<XXHash3::Hash128>{Hash::parallel(nullptr, 0, threads)};
+	}
+
+	size_t size = sb.st_size;
+	auto addr = Syscall::mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd.value(), 0);
+	Syscall::close(fd.value());
+	if (addr.failed()) {
+		LOG_ERROR << "Mmap file " << path << " failed: " << addr.error_message() << endl;
+		return Optional<XXHash3::Hash128>{};
+	}
+
+	// Each thread reads its chunks sequentially
+	Syscall::madvise(addr.value(), size, MADV_SEQUENTIAL);
+	auto result = Hash::parallel(reinterpret_cast<const void *>(addr.value()), size, threads);
+	Syscall::munmap(addr.value(), size);
+	return Optional<XXHash3::Hash128>{result};
+}
+
 void __procfdname(char *buf, unsigned fd) {
 	unsigned i = 0;
 	for (; (buf[i] = "/proc/self/fd/"[i]) != 0; i++) {}
@@ -0,0 +1,89 @@
+// Dirty Little Helper (DLH) - system support library for C/C++
+// Copyright 2021-2023 by Bernhard Heinloth <heinloth@cs.fau.de>
+// SPDX-License-Identifier: AGPL-3.0-or-later
+
+#include <dlh/hash.hpp>
+#include <dlh/syscall.hpp>
+#include <dlh/thread.hpp>
+#include <dlh/mem.hpp>
+
+#ifndef HASH_PARALLEL_THREADS
+// Maximum number of threads for parallel hashing
+// Default: 64
+#define HASH_PARALLEL_THREADS 64
+#endif
+
+namespace Hash {
+
+/*! \brief Shared state of the hashing threads */
+struct Job {
+	const char * buffer;
+	size_t length;
+	size_t chunks;
+	XXHash3::Hash128 * digests;
+	size_t next;
+};
+
+/*! \brief Hash a single chunk
+ * \param job job
+ * \param i index of the chunk
+ * \return digest of the chunk
+ */
+static XXHash3::Hash128 chunk(const Job * job, size_t i) {
+	const size_t offset = i * ChunkSize;
+	const size_t size = job->length - offset < ChunkSize ? job->length - offset : ChunkSize;
+	return XXHash3::hash128(job->buffer + offset, size, i);
+}
+
+/*! \brief Hash chunks until all are done
+ * \param arg pointer to the job
+ * \return `nullptr`
+ */
+static void * worker(void * arg) {
+	Job * job = reinterpret_cast<Job *>(arg);
+	for (size_t i; (i = __atomic_fetch_add(&job->next, 1, __ATOMIC_RELAXED)) < job->chunks;)
+		job->digests[i] = chunk(job, i);
+	return nullptr;
+}
+
+unsigned processors() {
+	unsigned long mask[16] = {};
+	unsigned count = 0;
+	if (auto bytes = Syscall::sched_getaffinity(0, sizeof(mask), mask))
+		for (size_t i = 0; i < static_cast<size_t>(bytes.value()) / sizeof(unsigned long); i++)
+			count += __builtin_popcountl(mask[i]);
+	return count > 0 ? count : 1;
+}
+
+XXHash3::Hash128 parallel(const void * buffer, size_t length, unsigned threads) {
+	Job job = { reinterpret_cast<const char *>(buffer), length, (length + ChunkSize - 1) / ChunkSize, nullptr, 0 };
+	if (job.chunks > 0 && (job.digests = Memory::alloc<XXHash3::Hash128>(job.chunks * sizeof(XXHash3::Hash128))) == nullptr) {
+		// Out of memory: hash all chunks sequentially
+		XXHash3 tree(length);
+		for (size_t i = 0; i < job.chunks; i++)
+			tree.add(chunk(&job, i));
+		return tree.hash128();
+	}
+
+	if (threads == 0)
+		threads = processors();
+	if (threads > job.chunks)
+		threads = static_cast<unsigned>(job.chunks);
+	if (threads > HASH_PARALLEL_THREADS)
+		threads = HASH_PARALLEL_THREADS;
+
+	// The current thread works as well
+	Thread * helper[HASH_PARALLEL_THREADS];
+	for (unsigned t = 1; t < threads; t++)
+		helper[t] = Thread::create(worker, &job);
+	worker(&job);
+	for (unsigned t = 1; t < threads; t++)
+		if (helper[t] != nullptr)
+			helper[t]->join();
+
+	XXHash3::Hash128 result = XXHash3::hash128(job.digests, job.chunks * sizeof(XXHash3::Hash128), length);
+	Memory::free(job.digests);
+	return result;
+}
+
+}  // namespace Hash
@@ -2,6 +2,8 @@
 // Copyright 2021-2023 by Bernhard Heinloth <heinloth@cs.fau.de>
 // SPDX-License-Identifier: AGPL-3.0-or-later
 
+#include <dlh/cpu.hpp>
+#include <dlh/mem.hpp>
 #include <dlh/error.hpp>
 #include <dlh/types.hpp>
 #include <dlh/thread.hpp>
@@ -31,9 +33,13 @@ __attribute__((__noinline__)) void __dlh_init(char **envp, const char *name) {
 	(void)name;
 	environ = envp;
 
+	// Processor features (from cpuid and auxiliary vector) for kernel dispatch
+	Cpu::init();
+
 #ifdef DLH_LEGACY
 	static Thread main_tcb;
 	Syscall::arch_prctl(ARCH_SET_FS, reinterpret_cast<uintptr_t>(&main_tcb));
+	Memory::thread_cache(true);
 #endif
 
 /*
@@ -3,6 +3,7 @@
 // SPDX-License-Identifier: AGPL-3.0-or-later
 
 #include <dlh/mem.hpp>
+#include <dlh/error.hpp>
 
 #ifdef DLH_LEGACY
 extern "C" void * malloc(size_t size) {
@@ -21,6 +22,32 @@ extern "C" void * calloc(size_t nmemb, size_t size) {
 	return reinterpret_cast<void*>(Memory::alloc_array(nmemb, size));
 }
 
+extern "C" void * aligned_alloc(size_t alignment, size_t size) {
+	return Memory::alloc_aligned<void>(size, alignment);
+}
+
+extern "C" int posix_memalign(void **memptr, size_t alignment, size_t size) {
+	if (alignment % sizeof(void*) != 0 || (alignment & (alignment - 1)) != 0)
+		return EINVAL;
+	if (size == 0) {
+		*memptr = nullptr;
+		return 0;
+	}
+	void * ptr = Memory::alloc_aligned<void>(size, alignment);
+	if (ptr == nullptr)
+		return ENOMEM;
+	*memptr = ptr;
+	return 0;
+}
+
+extern "C" void * memalign(size_t alignment, size_t size) {
+	return Memory::alloc_aligned<void>(size, alignment);
+}
+
+extern "C" size_t malloc_usable_size(void *ptr) {
+	return Memory::size(ptr);
+}
+
 #include <dlh/random.hpp>
 static Random random;
 extern "C" int rand() {
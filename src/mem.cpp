@@ -9,8 +9,10 @@
 #include <dlh/mutex.hpp>
 #include <dlh/assert.hpp>
 #include <dlh/string.hpp>
+#include <dlh/thread.hpp>
 
 #include "alloc_buddy.hpp"
+#include "alloc_slab.hpp"
 
 namespace Memory {
 
@@ -36,6 +38,126 @@ namespace Memory {
 #define MAX_ALLOC_LOG2 30
 #endif
 
+#ifndef SLAB_MAX_SIZE
+// Maximum object size (multiple of 16 bytes) for the slab allocator
+#define SLAB_MAX_SIZE 512
+#endif
+
+#ifndef SLAB_PAGE_LOG2
+// Size of slab pages (allocated from buddy allocator)
+// Default: 2^14 = 16 KiB
+#define SLAB_PAGE_LOG2 14
+#endif
+
+#ifndef HUGE_PAGES
+// Back heap and large mappings with huge pages (see Memory::HugePages)
+// Default: 0 = disabled
+#define HUGE_PAGES 0
+#endif
+
+#ifndef TRIM_THRESHOLD
+// Free heap memory (in bytes) to automatically release unused pages to the kernel
+// Default: 16 MiB (0 to disable)
+#define TRIM_THRESHOLD (16UL * 1024 * 1024)
+#endif
+
+#ifndef MAP_CACHE_LIMIT
+// Maximum total size (in bytes) of freed memory mappings kept for reuse
+// Default: 64 MiB (0 to disable)
+#define MAP_CACHE_LIMIT (64UL * 1024 * 1024)
+#endif
+
+#ifndef MAP_CACHE_MAX_SIZE
+// Maximum size (in bytes) of a single freed memory mapping kept for reuse
+// Default: 16 MiB
+#define MAP_CACHE_MAX_SIZE (16UL * 1024 * 1024)
+#endif
+
+#ifndef MAP_CACHE_ENTRIES
+// Maximum number of cached memory mappings per size class
+#define MAP_CACHE_ENTRIES 4
+#endif
+
+#ifndef MAP_CACHE_RELEASE
+// Release pages of cached memory mappings to the kernel (MADV_FREE)
+// Default: 0 = keep pages
+#define MAP_CACHE_RELEASE 0
+#endif
+
+#ifndef THREAD_CACHE_MAX_LOG2
+// Maximum block size served by per-thread caches
+// Default: 2^14 = 16 KiB
+#define THREAD_CACHE_MAX_LOG2 14
+#endif
+
+#ifndef THREAD_CACHE_LIMIT
+// Maximum number of free blocks per bucket in each per-thread cache
+#define THREAD_CACHE_LIMIT 32
+#endif
+
+#ifndef THREAD_CACHE_BATCH
+// Number of blocks exchanged at once between per-thread cache and allocator
+#define THREAD_CACHE_BATCH 8
+#endif
+
+// Counters for statistics (updated atomically)
+static Statistics statistics;
+
+// Bytes currently mapped by the allocator (heap and mmap path)
+static size_t mapped_total = 0;
+
+/*! \brief Atomically increment counter
+ * \param counter reference to counter
+ * \param value increment
+ */
+static inline void count(size_t & counter, size_t value = 1) {
+	__atomic_fetch_add(&counter, value, __ATOMIC_RELAXED);
+}
+
+/*! \brief Account memory mapped by the allocator (and update peak)
+ * \param bytes number of additional bytes
+ */
+static void count_mapped(size_t bytes) {
+	size_t current = __atomic_add_fetch(&mapped_total, bytes, __ATOMIC_RELAXED);
+	size_t peak = __atomic_load_n(&statistics.peak, __ATOMIC_RELAXED);
+	while (current > peak && !__atomic_compare_exchange_n(&statistics.peak, &peak, current, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {}
+}
+
+#ifndef DLH_LEGACY
+/*! \brief Account memory unmapped by the allocator
+ * \param bytes number of released bytes
+ */
+static void count_unmapped(size_t bytes) {
+	__atomic_sub_fetch(&mapped_total, bytes, __ATOMIC_RELAXED);
+}
+#endif
+
+// Current huge page mode
+static HugePages huge_pages_mode = static_cast<HugePages>(HUGE_PAGES);
+
+#ifndef DLH_LEGACY
+/*! \brief Advise kernel to back a memory region with transparent huge pages
+ * \param addr page aligned start address
+ * \param size size of region
+ */
+static void advise_huge_pages(uintptr_t addr, size_t size) {
+	if (huge_pages_mode != HUGE_PAGES_DISABLED && size > 0) {
+		auto madvise = Syscall::madvise(addr, size, MADV_HUGEPAGE);
+		// Fails with EINVAL if kernel has no transparent huge page support
+		if (madvise.failed())
+			LOG_DEBUG << "Advising huge pages for " << size << " bytes at " << reinterpret_cast<void*>(addr) << " failed: " << madvise.error_message() << endl;
+	}
+}
+#endif
+
+/*! \brief Size class for statistics
+ * \param size usable size
+ * \return binary logarithm of the size (rounded up)
+ */
+static inline size_t size_class(size_t size) {
+	return size <= 1 ? 0 : Math::min(8 * sizeof(size_t) - __builtin_clzl(size - 1), Statistics::CLASSES - 1);
+}
+
 #ifdef DLH_LEGACY
 // Use program break based allocator (with 128 KiB chunks)
 static uintptr_t reserve_sbrk(size_t size, uintptr_t & max_ptr) {
@@ -47,32 +169,38 @@ static uintptr_t reserve_sbrk(size_t size, uintptr_t & max_ptr) {
 		uintptr_t ptr = sbrk.value();
 		assert(max_ptr == 0 || max_ptr == ptr);
 		max_ptr = ptr + size;
+		count_mapped(size);
 		return ptr;
 	} else {
 		LOG_WARNING << "Allocator reserve by incrementing program break of " << size << " bytes failed: " << sbrk.error_message() << endl;
 		return 0;
 	}
 }
-static Allocator::Buddy<MIN_ALLOC_LOG2, MAX_ALLOC_LOG2, reserve_sbrk> allocator;
+static Allocator::Buddy<MIN_ALLOC_LOG2, MAX_ALLOC_LOG2, reserve_sbrk, SLAB_PAGE_LOG2> allocator;
 #else
+// Mapping address of heap
+static uintptr_t heap_start = MMAP_ALLOC_START;
+
+// End of heap mapping (or 0 if not mapped yet)
+static uintptr_t heap_end = 0;
+
 // Use mmap based allocator
 static uintptr_t reserve_mmap(size_t size, uintptr_t & max_ptr) {
-	// Mapping address
-	static uintptr_t mmap_addr = MMAP_ALLOC_START;
-
 	uintptr_t ptr = 0;
 
-	// Calculate size uising 1 MiB chunks
-	const size_t block_size = 256 * Page::SIZE;
+	// Calculate size uising 1 MiB chunks (or huge pages)
+	const size_t block_size = huge_pages_mode == HUGE_PAGES_DISABLED ? 256 * Page::SIZE : Page::HUGE_SIZE;
 	size = Math::align_up(size, block_size);
 
 	if (max_ptr == 0) {
 		// Initial mapping
-		if (auto mmap = Syscall::mmap(mmap_addr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0)) {
-			mmap_addr = ptr = mmap.value();
-			max_ptr = ptr + size;
+		if (auto mmap = Syscall::mmap(heap_start, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0)) {
+			heap_start = ptr = mmap.value();
+			heap_end = max_ptr = ptr + size;
+			count_mapped(size);
+			advise_huge_pages(ptr, size);
 		} else {
-			LOG_WARNING << "Allocator reserve by mmap of " << size << " bytes at " << reinterpret_cast<void*>(mmap_addr) << " failed: " << mmap.error_message() << endl;
+			LOG_WARNING << "Allocator reserve by mmap of " << size << " bytes at " << reinterpret_cast<void*>(heap_start) << " failed: " << mmap.error_message() << endl;
 		}
 		return ptr;
 	} else {
@@ -88,76 +216,726 @@ static uintptr_t reserve_mmap(size_t size, uintptr_t & max_ptr) {
 		}
 		*/
 
-		size_t old_size = max_ptr - mmap_addr;
+		size_t old_size = max_ptr - heap_start;
 		size_t new_size = old_size + size;
-		assert(old_size % block_size == 0);
-		if (auto mremap = Syscall::mremap(mmap_addr, old_size, new_size, 0)) {
-			assert(mmap_addr == mremap.value());
+		assert(old_size % Page::SIZE == 0);
+		if (auto mremap = Syscall::mremap(heap_start, old_size, new_size, 0)) {
+			assert(heap_start == mremap.value());
 			ptr = max_ptr;
-			max_ptr += size;
+			heap_end = max_ptr += size;
+			count_mapped(size);
+			advise_huge_pages(ptr, size);
 		} else {
-			LOG_WARNING << "Allocator reserve by mremap of " << old_size << " bytes to " << new_size << " bytes at " << reinterpret_cast<void*>(mmap_addr) << " failed: " << mremap.error_message() << endl;
+			LOG_WARNING << "Allocator reserve by mremap of " << old_size << " bytes to " << new_size << " bytes at " << reinterpret_cast<void*>(heap_start) << " failed: " << mremap.error_message() << endl;
 		}
 	}
 
 	return ptr;
 }
 
-static Allocator::Buddy<MIN_ALLOC_LOG2, MAX_ALLOC_LOG2, reserve_mmap> allocator;
+static Allocator::Buddy<MIN_ALLOC_LOG2, MAX_ALLOC_LOG2, reserve_mmap, SLAB_PAGE_LOG2> allocator;
 #endif
 
 static Mutex mutex;
 
+// Free heap memory to trigger automatic trim
+static size_t trim_limit = TRIM_THRESHOLD;
+
+// Bytes freed in the heap since last trim
+static size_t trim_pending = 0;
+
+// Advice for unused pages (fallback to MADV_DONTNEED on old kernels)
+static int trim_advice = MADV_FREE;
+
+/*! \brief Advise kernel that pages are not needed anymore
+ * \param addr page aligned start address
+ * \param size size (multiple of page size)
+ * \return `true` on success
+ */
+static bool release(uintptr_t addr, size_t size) {
+	auto madvise = Syscall::madvise(addr, size, trim_advice);
+	// MADV_FREE is not supported prior to Linux 4.5
+	if (madvise.error() == EINVAL && trim_advice != MADV_DONTNEED) {
+		trim_advice = MADV_DONTNEED;
+		return release(addr, size);
+	} else if (madvise.failed()) {
+		LOG_WARNING << "Releasing " << size << " bytes at " << reinterpret_cast<void*>(addr) << " failed: " << madvise.error_message() << endl;
+		return false;
+	}
+	return true;
+}
+
+/*! \brief Release the pages of free heap blocks to the kernel
+ * \note Requires lock
+ * \return number of released bytes
+ */
+static size_t heap_trim() {
+	size_t bytes = 0;
+	allocator.foreach_unused(__builtin_ctzl(Page::SIZE) + 1, [&bytes](uintptr_t start, size_t size) {
+		uintptr_t from = Math::align_up(start, Page::SIZE);
+		uintptr_t to = Math::align_down(start + size, Page::SIZE);
+		if (from < to) {
+			if (release(from, to - from))
+				bytes += to - from;
+		}
+	});
+	trim_pending = 0;
+	count(statistics.trimmed, bytes);
+	return bytes;
+}
+
+/*! \brief Free memory of buddy allocator
+ * \note Requires lock
+ * \param addr address of allocated memory
+ */
+static void buddy_free(uintptr_t addr) {
+	trim_pending += allocator.block_size(allocator.size(addr));
+	allocator.free(addr);
+}
+
+// Slab pages are buddy allocations (aligned to their size)
+static uintptr_t slab_page_alloc(size_t size) {
+	return allocator.malloc(size);
+}
+
+static void slab_page_free(uintptr_t addr) {
+	buddy_free(addr);
+}
+
+static Allocator::Slab<SLAB_MAX_SIZE, SLAB_PAGE_LOG2, MAX_ALLOC_LOG2, slab_page_alloc, slab_page_free> slab;
+
+/*! \brief Allocate from slab (small sizes) or buddy allocator
+ * \note Requires lock
+ * \param size requested size
+ * \return address of allocated memory or `0`
+ */
+static uintptr_t heap_alloc(size_t size) {
+	return size <= slab.MAX ? slab.malloc(size) : allocator.malloc(size);
+}
+
+/*! \brief Free memory of slab or buddy allocator
+ * \note Requires lock
+ * \param addr address of allocated memory
+ */
+static void heap_free(uintptr_t addr) {
+	if (slab.owns(addr))
+		slab.free(addr);
+	else
+		buddy_free(addr);
+
+	// Automatic trim
+	if (trim_limit != 0 && trim_pending >= trim_limit && allocator.free_size() >= trim_limit)
+		heap_trim();
+}
+
+/*! \brief Per-thread cache of free allocator blocks
+ * Each slab size class and each (small) bucket of the buddy allocator has a
+ * singly-linked list of blocks which were freed by the current thread (the
+ * link is stored in the payload of the block, a buddy header still contains
+ * the size).
+ * Blocks are exchanged in batches with the global allocator, hence most
+ * allocations can bypass the global mutex.
+ * The cache is anchored in the thread control block (`Thread::alloc_cache`).
+ */
+class ThreadCache {
+	static const size_t SLAB_BINS = SLAB_MAX_SIZE / 16;
+	static const size_t BINS = SLAB_BINS + THREAD_CACHE_MAX_LOG2 - MIN_ALLOC_LOG2 + 1;
+
+	struct Entry {
+		Entry * next;
+	};
+
+	struct Bin {
+		Entry * head;
+		size_t count;
+	} bins[BINS];
+
+	/*! \brief Local statistic counters
+	 * Merged into the global statistics after a certain number of events
+	 * (or on request), hence the fast path does not require atomic operations
+	 */
+	struct Counters {
+		size_t allocations[Statistics::CLASSES];
+		size_t frees[Statistics::CLASSES];
+		size_t used;
+		size_t events;
+	} local;
+
+	/*! \brief Number of local events before merging into global statistics
+	 */
+	static const size_t MERGE_EVENTS = 256;
+
+	static bool enabled;
+
+	/*! \brief Merge local counters into global statistics
+	 */
+	void merge() {
+		for (size_t i = 0; i < Statistics::CLASSES; i++) {
+			if (local.allocations[i] != 0)
+				count(statistics.allocations[i], local.allocations[i]);
+			if (local.frees[i] != 0)
+				count(statistics.frees[i], local.frees[i]);
+		}
+		count(statistics.used, local.used);
+		set(&local, 0, sizeof(Counters));
+	}
+
+	/*! \brief Bin for the requested size
+	 * \param size requested size
+	 * \return index of bin or `BINS` if not cacheable
+	 */
+	static size_t bin_for_request(size_t size) {
+		if (size <= slab.MAX)
+			return (size - 1) / 16;
+		else if (size >= (static_cast<size_t>(1) << THREAD_CACHE_MAX_LOG2))
+			return BINS;
+		else
+			return SLAB_BINS + __builtin_ctzl(allocator.block_size(size)) - MIN_ALLOC_LOG2;
+	}
+
+	/*! \brief Maximum request size for a bin
+	 * \param index index of bin
+	 * \return size
+	 */
+	static size_t bin_size(size_t index) {
+		if (index < SLAB_BINS)
+			return (index + 1) * 16;
+		else
+			return (static_cast<size_t>(1) << (MIN_ALLOC_LOG2 + index - SLAB_BINS)) - sizeof(size_t);
+	}
+
+	/*! \brief Get blocks from global allocator
+	 * \param bin target bin
+	 * \param index index of bin
+	 * \return `true` if at least one block was added
+	 */
+	static bool refill(Bin & bin, size_t index) {
+		const size_t size = bin_size(index);
+		Guarded<Mutex> section(mutex);
+		for (size_t i = 0; i < THREAD_CACHE_BATCH; i++) {
+			Entry * entry = reinterpret_cast<Entry *>(heap_alloc(size));
+			if (entry == nullptr)
+				break;
+			entry->next = bin.head;
+			bin.head = entry;
+			bin.count++;
+		}
+		return bin.head != nullptr;
+	}
+
+	/*! \brief Return blocks to global allocator
+	 * \param bin source bin
+	 * \param num maximum number of blocks to return
+	 */
+	static void drain(Bin & bin, size_t num) {
+		Guarded<Mutex> section(mutex);
+		for (; bin.head != nullptr && num > 0; num--) {
+			Entry * entry = bin.head;
+			bin.head = entry->next;
+			bin.count--;
+			heap_free(reinterpret_cast<uintptr_t>(entry));
+		}
+	}
+
+	/*! \brief Cache of the current thread
+	 * \param create allocate cache if it does not exist yet
+	 * \return pointer to cache or `nullptr`
+	 */
+	static ThreadCache * get(bool create = true) {
+		Thread * self = Thread::self();
+		if (self->alloc_cache == nullptr && create) {
+			Guarded<Mutex> section(mutex);
+			if (auto cache = reinterpret_cast<ThreadCache *>(heap_alloc(sizeof(ThreadCache)))) {
+				set(cache, 0, sizeof(ThreadCache));
+				self->alloc_cache = cache;
+			}
+		}
+		return reinterpret_cast<ThreadCache *>(self->alloc_cache);
+	}
+
+ public:
+	/*! \brief Enable caches
+	 * \param enable `true` if per thread caches should be used
+	 */
+	static void enable(bool enable) {
+		enabled = enable;
+	}
+
+	/*! \brief Allocate from cache of current thread
+	 * \param size requested size
+	 * \param addr reference to store the address of the allocated memory
+	 * \return `true` if request was handled by the cache
+	 */
+	static bool alloc(size_t size, uintptr_t & addr) {
+		size_t index;
+		if (!enabled || (index = bin_for_request(size)) >= BINS)
+			return false;
+
+		ThreadCache * cache = get();
+		if (cache == nullptr)
+			return false;
+
+		Bin & bin = cache->bins[index];
+		if (bin.head == nullptr && !refill(bin, index)) {
+			addr = 0;
+		} else {
+			Entry * entry = bin.head;
+			bin.head = entry->next;
+			bin.count--;
+			addr = reinterpret_cast<uintptr_t>(entry);
+			if (index >= SLAB_BINS) {
+				// Update size in block header
+				bool resized = allocator.resize(addr, size);
+				assert(resized);
+				(void) resized;
+			}
+		}
+		return true;
+	}
+
+	/*! \brief Free into cache of current thread
+	 * \param addr address of memory allocated by slab or buddy allocator
+	 * \param size (usable) size of allocated memory
+	 * \return `true` if block was put into the cache
+	 */
+	static bool free(uintptr_t addr, size_t size) {
+		size_t index;
+		if (!enabled || (index = bin_for_request(size)) >= BINS)
+			return false;
+
+		ThreadCache * cache = get();
+		if (cache == nullptr)
+			return false;
+
+		Bin & bin = cache->bins[index];
+		Entry * entry = reinterpret_cast<Entry *>(addr);
+		entry->next = bin.head;
+		bin.head = entry;
+		if (++bin.count > THREAD_CACHE_LIMIT)
+			drain(bin, THREAD_CACHE_BATCH);
+		return true;
+	}
+
+	/*! \brief Account allocation or free in the cache of the current thread
+	 * \param alloc `true` for an allocation, `false` for a free
+	 * \param size usable size
+	 * \return `true` if accounted, `false` if there is no cache
+	 */
+	static bool account(bool alloc, size_t size) {
+		ThreadCache * cache;
+		if (!enabled || (cache = get(false)) == nullptr)
+			return false;
+
+		if (alloc) {
+			cache->local.allocations[size_class(size)]++;
+			cache->local.used += size;
+		} else {
+			cache->local.frees[size_class(size)]++;
+			cache->local.used -= size;
+		}
+		if (++cache->local.events >= MERGE_EVENTS)
+			cache->merge();
+		return true;
+	}
+
+	/*! \brief Merge statistic counters of the current thread
+	 */
+	static void flush() {
+		ThreadCache * cache;
+		if (enabled && (cache = get(false)) != nullptr)
+			cache->merge();
+	}
+
+	/*! \brief Return all cached blocks of the current thread to the allocator
+	 */
+	static void release() {
+		if (ThreadCache * cache = get(false)) {
+			cache->merge();
+			for (auto & bin : cache->bins)
+				drain(bin, bin.count);
+			Thread::self()->alloc_cache = nullptr;
+			Guarded<Mutex> section(mutex);
+			heap_free(reinterpret_cast<uintptr_t>(cache));
+		}
+	}
+};
+
+bool ThreadCache::enabled = false;
+
+/*! \brief Account an allocation
+ * \param size usable size
+ */
+static void count_alloc(size_t size) {
+	if (!ThreadCache::account(true, size)) {
+		count(statistics.allocations[size_class(size)]);
+		count(statistics.used, size);
+	}
+}
+
+/*! \brief Account a free
+ * \param size usable size
+ */
+static void count_free(size_t size) {
+	if (!ThreadCache::account(false, size)) {
+		count(statistics.frees[size_class(size)]);
+		__atomic_sub_fetch(&statistics.used, size, __ATOMIC_RELAXED);
+	}
+}
+
+/*! \brief Usable size of a slab or buddy allocation
+ * \param size requested size
+ * \return usable size
+ */
+static inline size_t usable_size(size_t size) {
+	return size <= slab.MAX ? Math::align_up(size, 16) : size;
+}
+
 #ifndef DLH_LEGACY
+/*! \brief Cache of freed memory mappings (for reuse by large allocations)
+ * Mappings are grouped in size classes by the binary logarithm of their size
+ * (rounded down), each class has a fixed number of slots.
+ * A request is served by the most recently cached mapping of at least the
+ * requested size and at most twice the requested size.
+ * If a class is full or the total size exceeds the limit, the least recently
+ * cached mappings are unmapped.
+ */
+class MapCache {
+	static const size_t CLASSES = 8 * sizeof(size_t);
+
+	struct Entry {
+		/*! \brief Start address of mapping (`0` if slot is unused) */
+		uintptr_t start;
+		/*! \brief Size of the mapping (multiple of page size) */
+		size_t size;
+		/*! \brief Time of insertion (for eviction) */
+		size_t tick;
+	};
+
+	static Entry entries[CLASSES][MAP_CACHE_ENTRIES];
+	static Mutex mutex;
+	static size_t tick;
+	static size_t total;
+	static size_t limit;
+	static size_t max_size;
+	static bool release_pages;
+
+	/*! \brief Size class of a mapping
+	 * \param size size of mapping
+	 * \return binary logarithm of the size (rounded down)
+	 */
+	static size_t size_class(size_t size) {
+		return 8 * sizeof(size_t) - 1 - __builtin_clzl(size);
+	}
+
+	/*! \brief Remove entry from cache and unmap memory
+	 * \note Requires lock
+	 * \param entry cache entry
+	 */
+	static void evict(Entry & entry) {
+		auto munmap = Syscall::munmap(entry.start, entry.size);
+		if (munmap.failed()) {
+			LOG_WARNING << "Allocator using munmap of cached " << entry.size << " bytes at " << reinterpret_cast<void*>(entry.start) << " failed: " << munmap.error_message() << endl;
+		} else {
+			count(statistics.munmap);
+			count_unmapped(entry.size);
+		}
+		total -= entry.size;
+		__atomic_sub_fetch(&statistics.map_cached, entry.size, __ATOMIC_RELAXED);
+		entry.start = 0;
+	}
+
+	/*! \brief Evict least recently cached mappings until total size is within limit
+	 * \note Requires lock
+	 * \param size additional required space
+	 */
+	static void shrink(size_t size) {
+		while (total > 0 && total + size > limit) {
+			Entry * oldest = nullptr;
+			for (auto & cls : entries)
+				for (auto & entry : cls)
+					if (entry.start != 0 && (oldest == nullptr || entry.tick < oldest->tick))
+						oldest = &entry;
+			assert(oldest != nullptr);
+			evict(*oldest);
+		}
+	}
+
+ public:
+	/*! \brief Get cached mapping
+	 * \param size minimum size of mapping (multiple of page size), will be
+	 *             updated with the size of the returned mapping
+	 * \return start address of mapping or `0` if none is available
+	 */
+	static uintptr_t take(size_t & size) {
+		if (__atomic_load_n(&total, __ATOMIC_RELAXED) == 0)
+			return 0;
+
+		Guarded<Mutex> section(mutex);
+		Entry * best = nullptr;
+		for (size_t c = size_class(size); c < CLASSES && c <= size_class(size) + 1; c++)
+			for (auto & entry : entries[c])
+				if (entry.start != 0 && entry.size >= size && entry.size / 2 <= size && (best == nullptr || entry.tick > best->tick))
+					best = &entry;
+
+		if (best == nullptr)
+			return 0;
+
+		uintptr_t start = best->start;
+		size = best->size;
+		best->start = 0;
+		total -= size;
+		__atomic_sub_fetch(&statistics.map_cached, size, __ATOMIC_RELAXED);
+		count(statistics.map_cache_hits);
+		return start;
+	}
+
+	/*! \brief Insert mapping into cache
+	 * \param start start address of mapping
+	 * \param size size of mapping (multiple of page size)
+	 * \return `true` if mapping was cached, `false` if it has to be unmapped
+	 */
+	static bool put(uintptr_t start, size_t size) {
+		if (size > __atomic_load_n(&max_size, __ATOMIC_RELAXED) || size > __atomic_load_n(&limit, __ATOMIC_RELAXED))
+			return false;
+
+		if (__atomic_load_n(&release_pages, __ATOMIC_RELAXED))
+			release(start, size);
+
+		Guarded<Mutex> section(mutex);
+		if (size > max_size || size > limit)
+			return false;
+
+		// Use free slot in size class (or the least recently cached one)
+		Entry * slot = nullptr;
+		for (auto & entry : entries[size_class(size)])
+			if (entry.start == 0) {
+				slot = &entry;
+				break;
+			} else if (slot == nullptr || entry.tick < slot->tick) {
+				slot = &entry;
+			}
+		if (slot->start != 0)
+			evict(*slot);
+
+		shrink(size);
+
+		slot->start = start;
+		slot->size = size;
+		slot->tick = ++tick;
+		total += size;
+		count(statistics.map_cached, size);
+		return true;
+	}
+
+	/*! \brief Change configuration
+	 * \param new_limit maximum total size of cached mappings
+	 * \param new_max_size maximum size of a single cached mapping
+	 * \param release advise kernel that pages of cached mappings are not needed
+	 */
+	static void configure(size_t new_limit, size_t new_max_size, bool release) {
+		Guarded<Mutex> section(mutex);
+		limit = new_limit;
+		max_size = new_max_size;
+		release_pages = release;
+		shrink(0);
+		for (auto & cls : entries)
+			for (auto & entry : cls)
+				if (entry.start != 0 && entry.size > max_size)
+					evict(entry);
+	}
+
+	/*! \brief Unmap all cached mappings
+	 * \return number of released bytes
+	 */
+	static size_t flush() {
+		Guarded<Mutex> section(mutex);
+		size_t bytes = total;
+		for (auto & cls : entries)
+			for (auto & entry : cls)
+				if (entry.start != 0)
+					evict(entry);
+		return bytes;
+	}
+};
+
+MapCache::Entry MapCache::entries[MapCache::CLASSES][MAP_CACHE_ENTRIES];
+Mutex MapCache::mutex;
+size_t MapCache::tick = 0;
+size_t MapCache::total = 0;
+size_t MapCache::limit = MAP_CACHE_LIMIT;
+size_t MapCache::max_size = MAP_CACHE_MAX_SIZE;
+bool MapCache::release_pages = MAP_CACHE_RELEASE != 0;
+
 #define MEMORYMAP_MAGIC 0xDEADBEAFBADF00DUL
+#define MEMORYMAP_MAGIC_HUGETLB 0xDEADBEAFBADF11DUL
+/*! \brief Allocations using memory mappings
+ * The header is stored right in front of the returned address, which is
+ * usually at the start of the mapping.
+ * For alignments above the page size, the header is stored at the end of the
+ * first page of the mapping (the start of the mapping is always the page
+ * containing the header).
+ * Freed mappings are kept in the \ref MapCache for reuse.
+ */
 class MemoryMap {
+	/*! \brief Size of the mapping (multiple of page size) */
 	size_t size;
 	unsigned long magic;
-	char data[];
+
+	/*! \brief Length of the mapping
+	 * Explicit huge page mappings have to be unmapped in multiples of the huge page size
+	 */
+	size_t length() const {
+		return magic == MEMORYMAP_MAGIC_HUGETLB ? Math::align_up(size, Page::HUGE_SIZE) : size;
+	}
+
+	/*! \brief Get header of an allocation
+	 * \param addr address of allocation
+	 * \return pointer to header
+	 */
+	static MemoryMap * get(uintptr_t addr) {
+		MemoryMap * info = reinterpret_cast<MemoryMap *>(addr) - 1;
+		assert(info->magic == MEMORYMAP_MAGIC || info->magic == MEMORYMAP_MAGIC_HUGETLB);
+		return info;
+	}
+
+	/*! \brief Get start of the mapping of an allocation
+	 * \param addr address of allocation
+	 * \return start address of mapping
+	 */
+	static uintptr_t base(uintptr_t addr) {
+		return Math::align_down(addr - sizeof(MemoryMap), Page::SIZE);
+	}
+
+	/*! \brief Map anonymous memory (using huge pages if enabled)
+	 * \param size size of the mapping
+	 * \param alignment alignment (at least page size)
+	 * \param offset offset in mapping which has to be aligned
+	 * \param hugetlb set to `true` if explicit huge pages are used
+	 * \return start address of mapping or `0` on failure
+	 */
+	static uintptr_t map(size_t size, size_t alignment, size_t offset, bool & hugetlb) {
+		hugetlb = false;
+		bool huge = huge_pages_mode != HUGE_PAGES_DISABLED && size >= Page::HUGE_SIZE;
+		if (huge && offset == 0) {
+			alignment = Math::max(alignment, Page::HUGE_SIZE);
+			// Explicit huge pages (fails if not enough huge pages are reserved in the system)
+			if (huge_pages_mode == HUGE_PAGES_EXPLICIT && alignment == Page::HUGE_SIZE)
+				if (auto mmap = Syscall::mmap(0, Math::align_up(size, Page::HUGE_SIZE), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0)) {
+					hugetlb = true;
+					return mmap.value();
+				}
+		}
+
+		// Map additional space to align (and release it afterwards)
+		size_t length = Math::align_up(size, Page::SIZE);
+		size_t extra = alignment - Page::SIZE;
+		if (auto mmap = Syscall::mmap(0, length + extra, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0)) {
+			uintptr_t start = Math::align_up(mmap.value() + offset, alignment) - offset;
+			uintptr_t end = mmap.value() + length + extra;
+			if (start > mmap.value())
+				Syscall::munmap(mmap.value(), start - mmap.value());
+			if (end > start + length)
+				Syscall::munmap(start + length, end - (start + length));
+			if (huge)
+				advise_huge_pages(start, length);
+			return start;
+		} else {
+			LOG_WARNING << "Allocator using mmap of " << (length + extra) << " bytes failed: " << mmap.error_message() << endl;
+			return 0;
+		}
+	}
 
  public:
-	static uintptr_t create(size_t size) {
-		size += sizeof(MemoryMap);
-		if (auto mmap = Syscall::mmap(0, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0)) {
-			MemoryMap * info = reinterpret_cast<MemoryMap *>(mmap.value());
-			info->magic = MEMORYMAP_MAGIC;
+	static uintptr_t create(size_t size, size_t alignment = 16, bool clear = false) {
+		assert((alignment & (alignment - 1)) == 0 && alignment >= 16);
+		size_t offset = alignment <= Page::SIZE ? Math::max(alignment, sizeof(MemoryMap)) : Page::SIZE;
+		size = Math::align_up(size + offset, Page::SIZE);
+		bool hugetlb = false;
+		uintptr_t start = alignment <= Page::SIZE ? MapCache::take(size) : 0;
+		if (start != 0) {
+			// Reused mappings might contain old data
+			if (clear)
+				set(start + offset, 0, size - offset);
+		} else if ((start = map(size, Math::max(alignment, Page::SIZE), alignment <= Page::SIZE ? 0 : offset, hugetlb)) != 0) {
+			count(statistics.mmap);
+			count_mapped(size);
+		}
+		if (start != 0) {
+			uintptr_t addr = start + offset;
+			MemoryMap * info = reinterpret_cast<MemoryMap *>(addr) - 1;
+			info->magic = hugetlb ? MEMORYMAP_MAGIC_HUGETLB : MEMORYMAP_MAGIC;
 			info->size = size;
-			auto addr = reinterpret_cast<uintptr_t>(info->data);
+			count(statistics.mapped, size);
 			// Ensure GLIBC compatibility
-			assert(addr % 16 == 0);
+			assert(addr % alignment == 0);
 			return addr;
 		} else {
-			LOG_WARNING << "Allocator using mmap of " << size << " bytes failed: " << mmap.error_message() << endl;
 			return 0;
 		}
 	}
 
 	static uintptr_t resize(uintptr_t addr, size_t new_size) {
-		new_size += sizeof(MemoryMap);
-		uintptr_t start = addr - __builtin_offsetof(MemoryMap, data);
-		MemoryMap * old_info = reinterpret_cast<MemoryMap *>(start);
-		assert(old_info->magic == MEMORYMAP_MAGIC);
-		if (auto mremap = Syscall::mremap(start, old_info->size, new_size, MREMAP_MAYMOVE)) {
-			MemoryMap * new_info = reinterpret_cast<MemoryMap *>(mremap.value());
-			assert(new_info->magic == MEMORYMAP_MAGIC);
+		MemoryMap * old_info = get(addr);
+		uintptr_t start = base(addr);
+		size_t offset = addr - start;
+		size_t old_size = old_info->size;
+		new_size = Math::align_up(new_size + offset, Page::SIZE);
+		if (old_info->magic == MEMORYMAP_MAGIC_HUGETLB) {
+			// Explicit huge page mappings cannot be remapped
+			if (new_size <= old_info->length()) {
+				old_info->size = new_size;
+				count(statistics.mapped, new_size - old_size);
+				if (new_size > old_size)
+					count_mapped(new_size - old_size);
+				else
+					count_unmapped(old_size - new_size);
+				return addr;
+			}
+			uintptr_t new_addr = create(new_size - offset);
+			if (new_addr != 0) {
+				copy(new_addr, addr, old_size - offset);
+				remove(addr);
+			}
+			return new_addr;
+		}
+		if (auto mremap = Syscall::mremap(start, old_size, new_size, MREMAP_MAYMOVE)) {
+			uintptr_t new_addr = mremap.value() + offset;
+			MemoryMap * new_info = get(new_addr);
 			new_info->size = new_size;
-			return reinterpret_cast<uintptr_t>(new_info->data);
+			count(statistics.mremap);
+			count(statistics.mapped, new_size - old_size);
+			if (new_size > old_size)
+				count_mapped(new_size - old_size);
+			else
+				count_unmapped(old_size - new_size);
+			return new_addr;
 		} else {
-			LOG_WARNING << "Allocator using mremap of " << old_info->size << " bytes to " << new_size << " bytes at " << reinterpret_cast<void*>(start) << " failed: " << mremap.error_message() << endl;
+			LOG_WARNING << "Allocator using mremap of " << old_size << " bytes to " << new_size << " bytes at " << reinterpret_cast<void*>(start) << " failed: " << mremap.error_message() << endl;
 			return 0;
 		}
 	}
 
 	static void remove(uintptr_t addr) {
-		uintptr_t start = addr - __builtin_offsetof(MemoryMap, data);
-		MemoryMap * info = reinterpret_cast<MemoryMap *>(start);
-		assert(info->magic == MEMORYMAP_MAGIC);
+		MemoryMap * info = get(addr);
+		uintptr_t start = base(addr);
 		size_t size = info->size;
-		auto munmap = Syscall::munmap(start, size);
+		if (info->magic == MEMORYMAP_MAGIC && MapCache::put(start, size)) {
+			__atomic_sub_fetch(&statistics.mapped, size, __ATOMIC_RELAXED);
+			return;
+		}
+		auto munmap = Syscall::munmap(start, info->length());
 		if (munmap.failed()) {
 			LOG_WARNING << "Allocator using munmap of " << size << " bytes at " << reinterpret_cast<void*>(start) << " failed: " << munmap.error_message() << endl;
+		} else {
+			count(statistics.munmap);
+			__atomic_sub_fetch(&statistics.mapped, size, __ATOMIC_RELAXED);
+			count_unmapped(size);
 		}
 	}
+
+	static size_t usable(uintptr_t addr) {
+		return get(addr)->size - (addr - base(addr));
+	}
 };
 #endif
 
@@ -166,31 +944,83 @@ uintptr_t alloc(size_t size) {
 		return 0;
 #ifndef DLH_LEGACY
 	} else if (size >= MMAP_ALLOC_THREASHOLD) {
-		return MemoryMap::create(size);
+		uintptr_t addr = MemoryMap::create(size);
+		if (addr != 0)
+			count_alloc(MemoryMap::usable(addr));
+		return addr;
 #endif
 	} else {
-		Guarded<Mutex> section(mutex);
-
-		uintptr_t addr = allocator.malloc(size);
+		uintptr_t addr;
+		if (!ThreadCache::alloc(size, addr)) {
+			Guarded<Mutex> section(mutex);
+			addr = heap_alloc(size);
+		}
 
 		// Ensure GLIBC compatibility
 		assert(addr % 16 == 0);
 
+		if (addr != 0)
+			count_alloc(usable_size(size));
+		return addr;
+	}
+}
+
+uintptr_t alloc_aligned(size_t size, size_t alignment) {
+	if (size == 0 || (alignment & (alignment - 1)) != 0) {
+		return 0;
+	} else if (alignment <= 16) {
+		return alloc(size);
+	} else if (alignment <= slab.ALIGN && Math::align_up(size, alignment) <= slab.MAX) {
+		// Slab objects with a size multiple of the alignment
+		return alloc(Math::align_up(size, alignment));
+#ifndef DLH_LEGACY
+	} else if (size >= MMAP_ALLOC_THREASHOLD || alignment > (1UL << SLAB_PAGE_LOG2)) {
+		uintptr_t addr = MemoryMap::create(size, alignment);
+		if (addr != 0)
+			count_alloc(MemoryMap::usable(addr));
 		return addr;
+#else
+	} else if (alignment > (1UL << SLAB_PAGE_LOG2)) {
+		LOG_WARNING << "Allocator does not support alignment of " << alignment << " bytes" << endl;
+		return 0;
+#endif
+	} else {
+		// Buddy blocks are aligned to their size (if not exceeding the page size of slabs)
+		return alloc(Math::max(Math::max(size, alignment / 2), slab.MAX + 1));
 	}
 }
 
+size_t size(uintptr_t addr) {
+	if (addr == 0)
+		return 0;
+	size_t size = slab.size(addr);
+	if (size == 0)
+		size = allocator.size(addr);
+#ifndef DLH_LEGACY
+	if (size == 0)
+		size = MemoryMap::usable(addr);
+#endif
+	return size;
+}
+
 void free(uintptr_t addr) {
 	if (addr != 0) {
+		size_t size = slab.size(addr);
+		if (size == 0)
+			size = allocator.size(addr);
 #ifndef DLH_LEGACY
-		if (allocator.size(addr) == 0) {
+		if (size == 0) {
+			count_free(MemoryMap::usable(addr));
 			MemoryMap::remove(addr);
 		} else  // NOLINT
 #endif
 		 {
-			Guarded<Mutex> section(mutex);
+			count_free(size);
+			if (!ThreadCache::free(addr, size)) {
+				Guarded<Mutex> section(mutex);
 
-			allocator.free(addr);
+				heap_free(addr);
+			}
 		 }
 	}
 }
@@ -199,26 +1029,51 @@ uintptr_t realloc(uintptr_t addr, size_t size) {
 	if (addr == 0 && size == 0)
 		return 0;
 
+	if (slab.owns(addr)) {
+		size_t old_size = slab.size(addr);
+		// Keep object if it is still large enough
+		if (size != 0 && size <= old_size)
+			return addr;
+
+		uintptr_t new_addr = alloc(size);
+		if (new_addr != 0)
+			copy(new_addr, addr, Math::min(size, old_size));
+		if (new_addr != 0 || size == 0)
+			free(addr);
+		return new_addr;
+	}
+
 	size_t old_size = allocator.size(addr);
 	uintptr_t new_addr = 0;
 
 #ifndef DLH_LEGACY
 	if ((addr != 0 && old_size == 0) || size >= MMAP_ALLOC_THREASHOLD) {
 		if (size == 0) {
+			count_free(MemoryMap::usable(addr));
 			MemoryMap::remove(addr);
 		} else if (old_size == 0 && addr != 0) {
-			new_addr = MemoryMap::resize(addr, size);
+			old_size = MemoryMap::usable(addr);
+			if ((new_addr = MemoryMap::resize(addr, size)) != 0) {
+				count_free(old_size);
+				count_alloc(MemoryMap::usable(new_addr));
+			}
 		} else {
 			Guarded<Mutex> section(mutex);
 			// First try resize in allocator (cheap)
 			if (allocator.resize(addr, size)) {
-				return addr;
-			} else if ((new_addr = MemoryMap::create(size)) != 0 && addr != 0) {
-				// Copy contents from allocator to mapping
-				copy(new_addr, addr, Math::min(size, old_size));
-				// Remove old memory
-				allocator.free(addr);
+				new_addr = addr;
+				count_alloc(size);
+			} else if ((new_addr = MemoryMap::create(size)) != 0) {
+				if (addr != 0) {
+					// Copy contents from allocator to mapping
+					copy(new_addr, addr, Math::min(size, old_size));
+					// Remove old memory
+					heap_free(addr);
+				}
+				count_alloc(MemoryMap::usable(new_addr));
 			}
+			if (new_addr != 0 && addr != 0)
+				count_free(old_size);
 		}
 	} else  // NOLINT
 #endif
@@ -228,16 +1083,24 @@ uintptr_t realloc(uintptr_t addr, size_t size) {
 
 		// Allocate (of size > 0)
 		if (size > 0) {
-			if (old_size != 0 && allocator.resize(addr, size))
+			// Resize in place only if it remains a buddy allocation (otherwise it would end up in a slab bin)
+			if (old_size != 0 && size > slab.MAX && allocator.resize(addr, size)) {
+				count_free(old_size);
+				count_alloc(size);
 				return addr;
-			else if ((new_addr = allocator.malloc(size)) != 0 && addr != 0)
+			} else if ((new_addr = heap_alloc(size)) != 0) {
 				// Copy contents
-				copy(new_addr, addr, Math::min(size, old_size));
+				if (addr != 0)
+					copy(new_addr, addr, Math::min(size, old_size));
+				count_alloc(usable_size(size));
+			}
 		}
 
 		// Free old allocation
-		if (addr != 0)
-			allocator.free(addr);
+		if (addr != 0) {
+			heap_free(addr);
+			count_free(old_size);
+		}
 	 }
 
 	// Ensure GLIBC compatibility
@@ -245,6 +1108,48 @@ uintptr_t realloc(uintptr_t addr, size_t size) {
 	return new_addr;
 }
 
+void huge_pages(HugePages mode) {
+	Guarded<Mutex> section(mutex);
+	huge_pages_mode = mode;
+#ifndef DLH_LEGACY
+	// Apply to already mapped heap
+	if (heap_end != 0)
+		advise_huge_pages(heap_start, heap_end - heap_start);
+#endif
+}
+
+size_t trim() {
+	size_t bytes = 0;
+#ifndef DLH_LEGACY
+	bytes += MapCache::flush();
+#endif
+	Guarded<Mutex> section(mutex);
+	return bytes + heap_trim();
+}
+
+void trim_threshold(size_t bytes) {
+	Guarded<Mutex> section(mutex);
+	trim_limit = bytes;
+}
+
+void map_cache(size_t limit, size_t max_size, bool release) {
+#ifndef DLH_LEGACY
+	MapCache::configure(limit, max_size, release);
+#else
+	(void) limit;
+	(void) max_size;
+	(void) release;
+#endif
+}
+
+void thread_cache(bool enable) {
+	ThreadCache::enable(enable);
+}
+
+void thread_cache_release() {
+	ThreadCache::release();
+}
+
 uintptr_t alloc_array(size_t nmemb, size_t size) {
 	// Catch integer-multiplication overflow
 	size_t bytes = nmemb * size;
@@ -252,8 +1157,12 @@ uintptr_t alloc_array(size_t nmemb, size_t size) {
 		return 0;
 
 #ifndef DLH_LEGACY
-	if (bytes >= MMAP_ALLOC_THREASHOLD)
-		return MemoryMap::create(bytes);
+	if (bytes >= MMAP_ALLOC_THREASHOLD) {
+		uintptr_t addr = MemoryMap::create(bytes, 16, true);
+		if (addr != 0)
+			count_alloc(MemoryMap::usable(addr));
+		return addr;
+	}
 #endif
 
 	// Initialize memory
@@ -263,4 +1172,52 @@ uintptr_t alloc_array(size_t nmemb, size_t size) {
 
 	return new_addr;
 }
+
+Statistics stats() {
+	ThreadCache::flush();
+
+	Statistics result;
+	for (size_t i = 0; i < Statistics::CLASSES; i++) {
+		result.allocations[i] = __atomic_load_n(&statistics.allocations[i], __ATOMIC_RELAXED);
+		result.frees[i] = __atomic_load_n(&statistics.frees[i], __ATOMIC_RELAXED);
+		result.heap_free_blocks[i] = 0;
+	}
+	result.used = __atomic_load_n(&statistics.used, __ATOMIC_RELAXED);
+	result.mmap = __atomic_load_n(&statistics.mmap, __ATOMIC_RELAXED);
+	result.mremap = __atomic_load_n(&statistics.mremap, __ATOMIC_RELAXED);
+	result.munmap = __atomic_load_n(&statistics.munmap, __ATOMIC_RELAXED);
+	result.mapped = __atomic_load_n(&statistics.mapped, __ATOMIC_RELAXED);
+	result.peak = __atomic_load_n(&statistics.peak, __ATOMIC_RELAXED);
+	result.trimmed = __atomic_load_n(&statistics.trimmed, __ATOMIC_RELAXED);
+	result.map_cached = __atomic_load_n(&statistics.map_cached, __ATOMIC_RELAXED);
+	result.map_cache_hits = __atomic_load_n(&statistics.map_cache_hits, __ATOMIC_RELAXED);
+
+	Guarded<Mutex> section(mutex);
+	result.heap_reserved = allocator.reserved();
+	result.heap_size = allocator.tree_size();
+	result.heap_free = 0;
+	result.heap_free_largest = 0;
+	for (size_t i = MIN_ALLOC_LOG2; i <= MAX_ALLOC_LOG2; i++) {
+		size_t blocks = allocator.free_blocks(i);
+		result.heap_free_blocks[i] = blocks;
+		if (blocks > 0) {
+			result.heap_free += blocks << i;
+			result.heap_free_largest = static_cast<size_t>(1) << i;
+		}
+	}
+	result.slab_pages = slab.pages();
+	return result;
+}
+
+void log_stats() {
+	if (LOG.visible(Log::INFO)) {
+		const Statistics s = stats();
+		LOG_INFO << "Allocator statistics: " << s.used << " bytes in use, " << s.heap_reserved << " bytes heap reserved (tree size " << s.heap_size << ", " << s.slab_pages << " slab pages), " << s.mapped << " bytes mapped, peak " << s.peak << " bytes" << endl;
+		LOG_INFO_APPEND << " mmap path: " << s.mmap << " mmap, " << s.mremap << " mremap, " << s.munmap << " munmap, " << s.map_cache_hits << " cache hits (" << s.map_cached << " bytes cached)" << endl;
+		LOG_INFO_APPEND << " heap free: " << s.heap_free << " bytes (largest block " << s.heap_free_largest << " bytes, fragmentation " << s.fragmentation() << "%), " << s.trimmed << " bytes trimmed" << endl;
+		for (size_t i = 0; i < Statistics::CLASSES; i++)
+			if (s.allocations[i] != 0 || s.frees[i] != 0 || s.heap_free_blocks[i] != 0)
+				LOG_INFO_APPEND << " size class 2^" << i << ": " << s.allocations[i] << " allocations, " << s.frees[i] << " frees, " << s.heap_free_blocks[i] << " free heap blocks" << endl;
+	}
+}
 }  // namespace Memory
@@ -0,0 +1,485 @@
+// Dirty Little Helper (DLH) - system support library for C/C++
+// Copyright 2021-2023 by Bernhard Heinloth <heinloth@cs.fau.de>
+// SPDX-License-Identifier: AGPL-3.0-or-later
+
+#include <dlh/cpu.hpp>
+#include <dlh/mem.hpp>
+
+#include "simd.hpp"
+
+#if defined(__GNUC__) && !defined(__clang__)
+// Loops must not be replaced by calls to memcpy / memset (which use these functions)
+#pragma GCC optimize("no-tree-loop-distribute-patterns")
+#endif
+
+#ifndef MEMORY_ERMS_THRESHOLD
+// Minimum size to use `rep movsb` / `rep stosb` (if the CPU supports ERMS)
+// Default: 2 KiB
+#define MEMORY_ERMS_THRESHOLD 2048
+#endif
+
+#ifndef MEMORY_STREAM_THRESHOLD
+// Minimum size to use non-temporal stores in copy / set
+// Default: 0 (three quarters of the last level cache size)
+#define MEMORY_STREAM_THRESHOLD 0
+#endif
+
+#ifndef MEMORY_STREAM_PREFETCH
+// Distance for prefetching the source in non-temporal copies
+// Default: 512 bytes
+#define MEMORY_STREAM_PREFETCH 512
+#endif
+
+namespace Memory {
+
+using SIMD::Vec16;
+using SIMD::Vec32;
+using SIMD::load;
+using SIMD::loadu;
+using SIMD::store;
+using SIMD::storeu;
+using SIMD::stream;
+
+// Minimum size for non-temporal stores (0 if not determined yet)
+static size_t stream_limit = MEMORY_STREAM_THRESHOLD;
+
+/*! \brief Copy up to 32 bytes
+ * All data is loaded before it is stored, hence the areas may overlap.
+ */
+static inline __attribute__((always_inline)) void copy_small(uintptr_t dest, uintptr_t src, size_t size) {
+	if (size >= 16) {
+		Vec16 a = loadu<Vec16>(src), b = loadu<Vec16>(src + size - 16);
+		storeu<Vec16>(dest, a);
+		storeu<Vec16>(dest + size - 16, b);
+	} else if (size >= 8) {
+		uint64_t a = loadu<uint64_t>(src), b = loadu<uint64_t>(src + size - 8);
+		storeu<uint64_t>(dest, a);
+		storeu<uint64_t>(dest + size - 8, b);
+	} else if (size >= 4) {
+		uint32_t a = loadu<uint32_t>(src), b = loadu<uint32_t>(src + size - 4);
+		storeu<uint32_t>(dest, a);
+		storeu<uint32_t>(dest + size - 4, b);
+	} else if (size >= 2) {
+		uint16_t a = loadu<uint16_t>(src), b = loadu<uint16_t>(src + size - 2);
+		storeu<uint16_t>(dest, a);
+		storeu<uint16_t>(dest + size - 2, b);
+	} else if (size == 1) {
+		*reinterpret_cast<char *>(dest) = *reinterpret_cast<const char *>(src);
+	}
+}
+
+/*! \brief Copy forward in vector sized blocks (more than 32 bytes)
+ * Each block is loaded before it is stored, hence the destination may
+ * overlap with the source if it is at a lower address.
+ */
+template<typename V>
+static inline __attribute__((always_inline)) void copy_forward(uintptr_t dest, uintptr_t src, size_t size) {
+	const size_t n = sizeof(V);
+	V tail = loadu<V>(src + size - n);
+	size_t i = 0;
+	for (; i + 4 * n <= size; i += 4 * n) {
+		V a = loadu<V>(src + i), b = loadu<V>(src + i + n), c = loadu<V>(src + i + 2 * n), d = loadu<V>(src + i + 3 * n);
+		storeu<V>(dest + i, a);
+		storeu<V>(dest + i + n, b);
+		storeu<V>(dest + i + 2 * n, c);
+		storeu<V>(dest + i + 3 * n, d);
+	}
+	for (; i + n < size; i += n)
+		storeu<V>(dest + i, loadu<V>(src + i));
+	storeu<V>(dest + size - n, tail);
+}
+
+/*! \brief Copy backward in vector sized blocks (more than 32 bytes)
+ * Each block is loaded before it is stored, hence the destination may
+ * overlap with the source if it is at a higher address.
+ */
+template<typename V>
+static inline __attribute__((always_inline)) void copy_backward(uintptr_t dest, uintptr_t src, size_t size) {
+	const size_t n = sizeof(V);
+	V head = loadu<V>(src);
+	size_t i = size;
+	for (; i > 4 * n; i -= 4 * n) {
+		V a = loadu<V>(src + i - n), b = loadu<V>(src + i - 2 * n), c = loadu<V>(src + i - 3 * n), d = loadu<V>(src + i - 4 * n);
+		storeu<V>(dest + i - n, a);
+		storeu<V>(dest + i - 2 * n, b);
+		storeu<V>(dest + i - 3 * n, c);
+		storeu<V>(dest + i - 4 * n, d);
+	}
+	for (; i > n; i -= n)
+		storeu<V>(dest + i - n, loadu<V>(src + i - n));
+	storeu<V>(dest, head);
+}
+
+/*! \brief Copy non-overlapping areas (more than 32 bytes) with aligned stores
+ * \tparam V vector type
+ */
+template<typename V>
+static inline __attribute__((always_inline)) void copy_aligned(uintptr_t dest, uintptr_t src, size_t size) {
+	const size_t n = sizeof(V);
+	if (size <= 4 * n) {
+		copy_forward<V>(dest, src, size);
+		return;
+	}
+	// Unaligned first and last block, aligned blocks in between
+	V head = loadu<V>(src), tail = loadu<V>(src + size - n);
+	size_t skip = n - (dest & (n - 1));
+	uintptr_t d = dest + skip, s = src + skip;
+	uintptr_t end = dest + size - n;
+	for (; d + 4 * n <= end; d += 4 * n, s += 4 * n) {
+		V a = loadu<V>(s), b = loadu<V>(s + n), c = loadu<V>(s + 2 * n), e = loadu<V>(s + 3 * n);
+		store<V>(d, a);
+		store<V>(d + n, b);
+		store<V>(d + 2 * n, c);
+		store<V>(d + 3 * n, e);
+	}
+	for (; d < end; d += n, s += n)
+		store<V>(d, loadu<V>(s));
+	storeu<V>(dest, head);
+	storeu<V>(end, tail);
+}
+
+/*! \brief Copy using `rep movsb` (fast on CPUs with ERMS)
+ */
+static inline __attribute__((always_inline)) void copy_rep(uintptr_t dest, uintptr_t src, size_t size) {
+	asm volatile("rep movsb" : "+D"(dest), "+S"(src), "+c"(size) :: "memory");
+}
+
+template<bool ERMS>
+static void copy_sse2(uintptr_t dest, uintptr_t src, size_t size) {
+	if (ERMS && size >= MEMORY_ERMS_THRESHOLD)
+		copy_rep(dest, src, size);
+	else
+		copy_aligned<Vec16>(dest, src, size);
+}
+
+template<bool ERMS>
+static __attribute__((target("avx2"))) void copy_avx2(uintptr_t dest, uintptr_t src, size_t size) {
+	if (ERMS && size >= MEMORY_ERMS_THRESHOLD) {
+		copy_rep(dest, src, size);
+	} else {
+		copy_aligned<Vec32>(dest, src, size);
+		asm volatile("vzeroupper" ::: "memory");
+	}
+}
+
+/*! \brief Select kernel for copying more than 64 bytes */
+static Cpu::Dispatch<void(uintptr_t, uintptr_t, size_t)>::Function resolve_copy() {
+	if (Cpu::has(Cpu::AVX2))
+		return Cpu::has(Cpu::ERMS) ? copy_avx2<true> : copy_avx2<false>;
+	else
+		return Cpu::has(Cpu::ERMS) ? copy_sse2<true> : copy_sse2<false>;
+}
+static Cpu::Dispatch<void(uintptr_t, uintptr_t, size_t)> copy_large(resolve_copy);
+
+static void move_sse2(uintptr_t dest, uintptr_t src, size_t size) {
+	if (dest < src)
+		copy_forward<Vec16>(dest, src, size);
+	else
+		copy_backward<Vec16>(dest, src, size);
+}
+
+static __attribute__((target("avx2"))) void move_avx2(uintptr_t dest, uintptr_t src, size_t size) {
+	if (dest < src)
+		copy_forward<Vec32>(dest, src, size);
+	else
+		copy_backward<Vec32>(dest, src, size);
+	asm volatile("vzeroupper" ::: "memory");
+}
+
+/*! \brief Select kernel for moving more than 64 overlapping bytes */
+static Cpu::Dispatch<void(uintptr_t, uintptr_t, size_t)>::Function resolve_move() {
+	return Cpu::has(Cpu::AVX2) ? move_avx2 : move_sse2;
+}
+static Cpu::Dispatch<void(uintptr_t, uintptr_t, size_t)> move_large(resolve_move);
+
+/*! \brief Copy non-overlapping areas (more than 64 bytes) with non-temporal stores
+ * Only the unaligned first and last block use regular stores.
+ */
+static void copy_stream(uintptr_t dest, uintptr_t src, size_t size) {
+	const size_t n = sizeof(Vec16);
+	Vec16 head = loadu<Vec16>(src), tail = loadu<Vec16>(src + size - n);
+	size_t skip = n - (dest & (n - 1));
+	uintptr_t d = dest + skip, s = src + skip;
+	uintptr_t end = dest + size - n;
+	for (; d + 4 * n <= end; d += 4 * n, s += 4 * n) {
+		SIMD::prefetch(s + MEMORY_STREAM_PREFETCH);
+		Vec16 a = loadu<Vec16>(s), b = loadu<Vec16>(s + n), c = loadu<Vec16>(s + 2 * n), e = loadu<Vec16>(s + 3 * n);
+		stream(d, a);
+		stream(d + n, b);
+		stream(d + 2 * n, c);
+		stream(d + 3 * n, e);
+	}
+	for (; d < end; d += n, s += n)
+		stream(d, loadu<Vec16>(s));
+	SIMD::fence();
+	storeu<Vec16>(dest, head);
+	storeu<Vec16>(end, tail);
+}
+
+/*! \brief Minimum size for non-temporal stores
+ * \return size in bytes
+ */
+static inline size_t streaming() {
+	size_t limit = __atomic_load_n(&stream_limit, __ATOMIC_RELAXED);
+	return limit != 0 ? limit : stream_threshold();
+}
+
+uintptr_t copy(uintptr_t dest, uintptr_t src, size_t size) {
+	if (size <= 32)
+		copy_small(dest, src, size);
+	else if (size <= 64)
+		copy_forward<Vec16>(dest, src, size);
+	else if (size >= streaming())
+		copy_stream(dest, src, size);
+	else
+		copy_large(dest, src, size);
+	return dest;
+}
+
+uintptr_t stream_copy(uintptr_t dest, uintptr_t src, size_t size) {
+	if (size <= 32)
+		copy_small(dest, src, size);
+	else if (size <= 64)
+		copy_forward<Vec16>(dest, src, size);
+	else
+		copy_stream(dest, src, size);
+	return dest;
+}
+
+uintptr_t move(uintptr_t dest, uintptr_t src, size_t size) {
+	if (size <= 32) {
+		copy_small(dest, src, size);
+	} else if (dest == src) {
+		return dest;
+	} else if (dest + size <= src || src + size <= dest) {
+		return copy(dest, src, size);
+	} else if (size > 64) {
+		move_large(dest, src, size);
+	} else if (dest < src) {
+		copy_forward<Vec16>(dest, src, size);
+	} else {
+		copy_backward<Vec16>(dest, src, size);
+	}
+	return dest;
+}
+
+/*! \brief Fill area (more than 32 bytes) with aligned stores
+ * \tparam V vector type
+ */
+template<typename V>
+static inline __attribute__((always_inline)) void set_aligned(uintptr_t dest, const V & v, size_t size) {
+	const size_t n = sizeof(V);
+	storeu<V>(dest, v);
+	storeu<V>(dest + size - n, v);
+	uintptr_t d = Math::align_up(dest + 1, n);
+	uintptr_t end = dest + size - n;
+	for (; d + 4 * n <= end; d += 4 * n) {
+		store<V>(d, v);
+		store<V>(d + n, v);
+		store<V>(d + 2 * n, v);
+		store<V>(d + 3 * n, v);
+	}
+	for (; d < end; d += n)
+		store<V>(d, v);
+}
+
+template<bool ERMS>
+static void set_sse2(uintptr_t dest, char pattern, size_t size) {
+	if (ERMS && size >= MEMORY_ERMS_THRESHOLD)
+		asm volatile("rep stosb" : "+D"(dest), "+c"(size) : "a"(pattern) : "memory");
+	else
+		set_aligned<Vec16>(dest, Vec16{} + pattern, size);
+}
+
+template<bool ERMS>
+static __attribute__((target("avx2"))) void set_avx2(uintptr_t dest, char pattern, size_t size) {
+	if (ERMS && size >= MEMORY_ERMS_THRESHOLD) {
+		asm volatile("rep stosb" : "+D"(dest), "+c"(size) : "a"(pattern) : "memory");
+	} else {
+		set_aligned<Vec32>(dest, Vec32{} + pattern, size);
+		asm volatile("vzeroupper" ::: "memory");
+	}
+}
+
+/*! \brief Select kernel for filling more than 64 bytes */
+static Cpu::Dispatch<void(uintptr_t, char, size_t)>::Function resolve_set() {
+	if (Cpu::has(Cpu::AVX2))
+		return Cpu::has(Cpu::ERMS) ? set_avx2<true> : set_avx2<false>;
+	else
+		return Cpu::has(Cpu::ERMS) ? set_sse2<true> : set_sse2<false>;
+}
+static Cpu::Dispatch<void(uintptr_t, char, size_t)> set_large(resolve_set);
+
+/*! \brief Fill area (more than 64 bytes) with non-temporal stores
+ * Only the unaligned first and last block use regular stores.
+ */
+static void set_stream(uintptr_t dest, char pattern, size_t size) {
+	const size_t n = sizeof(Vec16);
+	Vec16 v = Vec16{} + pattern;
+	uintptr_t d = Math::align_up(dest + 1, n);
+	uintptr_t end = dest + size - n;
+	for (; d + 4 * n <= end; d += 4 * n) {
+		stream(d, v);
+		stream(d + n, v);
+		stream(d + 2 * n, v);
+		stream(d + 3 * n, v);
+	}
+	for (; d < end; d += n)
+		stream(d, v);
+	SIMD::fence();
+	storeu<Vec16>(dest, v);
+	storeu<Vec16>(end, v);
+}
+
+uintptr_t set(uintptr_t dest, int pattern, size_t size) {
+	const char c = static_cast<char>(pattern);
+	if (size > 64) {
+		if (size >= streaming())
+			set_stream(dest, c, size);
+		else
+			set_large(dest, c, size);
+	} else if (size >= 32) {
+		set_aligned<Vec16>(dest, Vec16{} + c, size);
+	} else if (size >= 16) {
+		Vec16 v = Vec16{} + c;
+		storeu<Vec16>(dest, v);
+		storeu<Vec16>(dest + size - 16, v);
+	} else if (size >= 4) {
+		uint64_t v = static_cast<uint64_t>(static_cast<unsigned char>(c)) * 0x0101010101010101UL;
+		if (size >= 8) {
+			storeu<uint64_t>(dest, v);
+			storeu<uint64_t>(dest + size - 8, v);
+		} else {
+			storeu<uint32_t>(dest, static_cast<uint32_t>(v));
+			storeu<uint32_t>(dest + size - 4, static_cast<uint32_t>(v));
+		}
+	} else if (size > 0) {
+		unsigned char * d = reinterpret_cast<unsigned char *>(dest);
+		d[0] = d[size / 2] = d[size - 1] = static_cast<unsigned char>(c);
+	}
+	return dest;
+}
+
+uintptr_t stream_set(uintptr_t dest, int pattern, size_t size) {
+	if (size <= 64)
+		return set(dest, pattern, size);
+	set_stream(dest, static_cast<char>(pattern), size);
+	return dest;
+}
+
+size_t stream_threshold() {
+	size_t limit = __atomic_load_n(&stream_limit, __ATOMIC_RELAXED);
+	if (limit == 0) {
+		// Areas exceeding the last level cache would evict the whole working set
+		size_t cache = Cpu::cache_size(3);
+		if (cache == 0)
+			cache = Cpu::cache_size(2);
+		limit = cache == 0 ? 4 * 1024 * 1024 : cache / 4 * 3;
+		// Cache sizes are not known before startup
+		if (Cpu::initialized())
+			__atomic_store_n(&stream_limit, limit, __ATOMIC_RELAXED);
+	}
+	return limit;
+}
+
+void stream_threshold(size_t size) {
+	__atomic_store_n(&stream_limit, size, __ATOMIC_RELAXED);
+}
+
+/*! \brief Difference of the first differing byte in two words
+ * \param a word of first element
+ * \param b word of second element (has to differ from `a`)
+ * \return difference of the bytes (in memory order)
+ */
+template<typename T>
+static inline int difference(T a, T b) {
+	unsigned shift = __builtin_ctzll(a ^ b) & ~7U;
+	return static_cast<int>((a >> shift) & 0xff) - static_cast<int>((b >> shift) & 0xff);
+}
+
+/*! \brief Difference of the first differing byte in a block
+ * \param s1 first element
+ * \param s2 second element
+ * \param m mask of equal bytes in the block
+ * \return difference of the bytes
+ */
+static inline int difference(uintptr_t s1, uintptr_t s2, unsigned m) {
+	size_t p = __builtin_ctz(~m);
+	return static_cast<int>(reinterpret_cast<const unsigned char *>(s1)[p]) - static_cast<int>(reinterpret_cast<const unsigned char *>(s2)[p]);
+}
+
+/*! \brief Compare in blocks of 16 bytes (at least 16 bytes)
+ * The last block overlaps with the previous one.
+ */
+static int compare_sse2(uintptr_t s1, uintptr_t s2, size_t size) {
+	for (size_t i = 0;; i += 16) {
+		if (i + 16 > size)
+			i = size - 16;
+		unsigned m = SIMD::mask(loadu<Vec16>(s1 + i) == loadu<Vec16>(s2 + i));
+		if (m != 0xffff)
+			return difference(s1 + i, s2 + i, m);
+		if (i + 16 == size)
+			return 0;
+	}
+}
+
+/*! \brief Compare in blocks of 32 bytes (at least 32 bytes)
+ * The last block overlaps with the previous one.
+ */
+static __attribute__((target("avx2"))) int compare_avx2(uintptr_t s1, uintptr_t s2, size_t size) {
+	int r = 0;
+	for (size_t i = 0;; i += 32) {
+		if (i + 32 > size)
+			i = size - 32;
+		unsigned m = SIMD::mask(loadu<Vec32>(s1 + i) == loadu<Vec32>(s2 + i));
+		if (m != ~0U) {
+			r = difference(s1 + i, s2 + i, m);
+			break;
+		}
+		if (i + 32 == size)
+			break;
+	}
+	asm volatile("vzeroupper");
+	return r;
+}
+
+/*! \brief Select kernel for comparing more than 64 bytes */
+static Cpu::Dispatch<int(uintptr_t, uintptr_t, size_t)>::Function resolve_compare() {
+	return Cpu::has(Cpu::AVX2) ? compare_avx2 : compare_sse2;
+}
+static Cpu::Dispatch<int(uintptr_t, uintptr_t, size_t)> compare_large(resolve_compare);
+
+int compare(uintptr_t s1, uintptr_t s2, size_t n) {
+	if (n > 64) {
+		return compare_large(s1, s2, n);
+	} else if (n >= 16) {
+		return compare_sse2(s1, s2, n);
+	} else if (n >= 8) {
+		uint64_t a = loadu<uint64_t>(s1), b = loadu<uint64_t>(s2);
+		if (a == b) {
+			a = loadu<uint64_t>(s1 + n - 8);
+			b = loadu<uint64_t>(s2 + n - 8);
+			if (a == b)
+				return 0;
+		}
+		return difference(a, b);
+	} else if (n >= 4) {
+		uint32_t a = loadu<uint32_t>(s1), b = loadu<uint32_t>(s2);
+		if (a == b) {
+			a = loadu<uint32_t>(s1 + n - 4);
+			b = loadu<uint32_t>(s2 + n - 4);
+			if (a == b)
+				return 0;
+		}
+		return difference(a, b);
+	} else {
+		const unsigned char * c1 = reinterpret_cast<const unsigned char*>(s1);
+		const unsigned char * c2 = reinterpret_cast<const unsigned char*>(s2);
+		for (size_t i = 0; i != n; ++i)
+			if (c1[i] != c2[i])
+				return static_cast<int>(c1[i]) - static_cast<int>(c2[i]);
+		return 0;
+	}
+}
+
+}  // namespace Memory
@@ -7,8 +7,6 @@
 #include <dlh/syscall.hpp>
 #include <dlh/stream/output.hpp>
 
-Mutex::Mutex() : var(FUTEX_UNLOCKED) {}
-
 bool Mutex::lock(const struct timespec * __restrict__ at) {
 	auto state = FUTEX_UNLOCKED;
 	if (!__atomic_compare_exchange_n(&var, &state, FUTEX_LOCKED, false, __ATOMIC_RELEASE, __ATOMIC_RELAXED)) {
@@ -5,18 +5,39 @@
 #include <dlh/parser/config.hpp>
 #include <dlh/environ.hpp>
 #include <dlh/string.hpp>
+#include <dlh/mem.hpp>
 #include <dlh/file.hpp>
 
 namespace Parser {
 
 Config::Config(const char * path, Source source, bool consume_env) : source(source), consume_env(consume_env) {
-	char * value;
-	for (const auto & line : File::lines(path))
-		if (line != nullptr && line[0] != '\0' && line[0] != '#' && (value = const_cast<char*>(String::find(line, '='))) != nullptr && reinterpret_cast<uintptr_t>(value) > reinterpret_cast<uintptr_t>(line)) {
-			*value = '\0';
+	// Lines are tokenized in the (private) mapping of the file without allocating a line vector
+	size_t size;
+	char * data = File::contents::get(path, size);
+	if (data == nullptr)
+		return;
+	String::Tokenizer::Token line;
+	for (String::Tokenizer lines(data, size, '\n'); lines.next(line); ) {
+		char * key = const_cast<char *>(line.str);
+		if (key[0] == '#')
+			continue;
+		size_t value = 0;
+		while (value < line.len && key[value] != '=')
 			value++;
-			contents.insert(line, value);
-		}
+		if (value == 0 || value == line.len)
+			continue;
+		if (key + line.len < data + size)
+			key[line.len] = '\0';
+		else if ((key = last_line = String::duplicate(key, line.len)) == nullptr)
+			// Last line without line break, might end at the page boundary
+			continue;
+		key[value] = '\0';
+		contents.insert(key, key + value + 1);
+	}
+}
+
+Config::~Config() {
+	Memory::free(last_line);
 }
 
 const char * Config::value(const char * name) {
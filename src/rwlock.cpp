@@ -0,0 +1,21 @@
+// Dirty Little Helper (DLH) - system support library for C/C++
+// Copyright 2021-2023 by Bernhard Heinloth <heinloth@cs.fau.de>
+// SPDX-License-Identifier: AGPL-3.0-or-later
+
+#include <dlh/rwlock.hpp>
+#include <dlh/assert.hpp>
+#include <dlh/syscall.hpp>
+
+void ReaderCount::lock() {
+	int s = __atomic_fetch_or(&state, WRITER, __ATOMIC_ACQUIRE) | WRITER;
+	// Sleep until the last reader has left (futex fails if the state has changed in the meantime)
+	while (s != WRITER) {
+		Syscall::futex(&state, FUTEX_WAIT, s, nullptr, nullptr, 0);
+		s = __atomic_load_n(&state, __ATOMIC_ACQUIRE);
+	}
+}
+
+void ReaderCount::wake() {
+	if (Syscall::futex(&state, FUTEX_WAKE, 1, nullptr, nullptr, 0).failed())
+		assert(false);
+}
@@ -0,0 +1,174 @@
+// Dirty Little Helper (DLH) - system support library for C/C++
+// Copyright 2021-2023 by Bernhard Heinloth <heinloth@cs.fau.de>
+// SPDX-License-Identifier: AGPL-3.0-or-later
+
+/*! \file
+ *  \brief Vector types and helpers for SIMD kernels (x86_64)
+ *
+ * Since compiler headers are not available (`-nostdinc`), the kernels use
+ * GCC vector extensions and target builtins (with generic alternatives for
+ * builtins not provided by Clang).
+ * SSE2 is part of the x86_64 baseline, AVX2 functions require the `target`
+ * attribute and must only be called if supported by the CPU.
+ */
+
+#pragma once
+
+#include <dlh/types.hpp>
+
+#if defined(__GNUC__) && !defined(__clang__)
+// Vectors are only passed to always inlined helpers
+#pragma GCC diagnostic ignored "-Wpsabi"
+#endif
+
+namespace SIMD {
+
+/*! \brief 16 byte vector (SSE2) */
+typedef char Vec16 __attribute__((vector_size(16), may_alias));
+
+/*! \brief 32 byte vector (AVX2) */
+typedef char Vec32 __attribute__((vector_size(32), may_alias));
+
+/*! \brief 16 byte vector of 64 bit integers (for builtins) */
+typedef long long Vec2x64 __attribute__((vector_size(16), may_alias));
+
+/*! \brief 16 byte vector of unsigned 64 bit integers (SSE2) */
+typedef unsigned long long Vec2xU64 __attribute__((vector_size(16), may_alias));
+
+/*! \brief 32 byte vector of unsigned 64 bit integers (AVX2) */
+typedef unsigned long long Vec4xU64 __attribute__((vector_size(32), may_alias));
+
+/*! \brief Wrapper for unaligned access */
+template<typename T>
+struct __attribute__((packed, may_alias)) Unaligned {
+	T value;
+};
+
+/*! \brief Load from aligned address
+ * \tparam T type to load
+ * \param addr source address (aligned to the size of the type)
+ * \return value
+ */
+template<typename T>
+static inline __attribute__((always_inline)) T load(uintptr_t addr) {
+	return *reinterpret_cast<const T *>(addr);
+}
+
+/*! \brief Load from unaligned address
+ * \tparam T type to load
+ * \param addr source address
+ * \return value
+ */
+template<typename T>
+static inline __attribute__((always_inline)) T loadu(uintptr_t addr) {
+	return reinterpret_cast<const Unaligned<T> *>(addr)->value;
+}
+
+/*! \brief Store at aligned address
+ * \tparam T type to store
+ * \param addr target address (aligned to the size of the type)
+ * \param value value
+ */
+template<typename T>
+static inline __attribute__((always_inline)) void store(uintptr_t addr, const T & value) {
+	*reinterpret_cast<T *>(addr) = value;
+}
+
+/*! \brief Store at unaligned address
+ * \tparam T type to store
+ * \param addr target address
+ * \param value value
+ */
+template<typename T>
+static inline __attribute__((always_inline)) void storeu(uintptr_t addr, const T & value) {
+	reinterpret_cast<Unaligned<T> *>(addr)->value = value;
+}
+
+/*! \brief Store at aligned address bypassing the caches (non-temporal)
+ * \param addr target address (aligned to 16 bytes)
+ * \param value value
+ * \note Requires a \ref fence before the data is used by other threads
+ */
+static inline __attribute__((always_inline)) void stream(uintptr_t addr, const Vec16 & value) {
+#ifdef __clang__
+	__builtin_nontemporal_store(value, reinterpret_cast<Vec16 *>(addr));
+#else
+	__builtin_ia32_movntdq(reinterpret_cast<Vec2x64 *>(addr), reinterpret_cast<const Vec2x64 &>(value));
+#endif
+}
+
+/*! \brief Order preceding non-temporal stores before all following stores
+ */
+static inline __attribute__((always_inline)) void fence() {
+	__builtin_ia32_sfence();
+}
+
+/*! \brief Prefetch data for reading once (without polluting the caches)
+ * \param addr address (may be invalid)
+ */
+static inline __attribute__((always_inline)) void prefetch(uintptr_t addr) {
+	__builtin_prefetch(reinterpret_cast<const void *>(addr), 0, 0);
+}
+
+/*! \brief Bit mask of the most significant bit of each byte
+ * \param v vector
+ * \return mask with bit `n` set if byte `n` has its most significant bit set
+ */
+static inline __attribute__((always_inline)) unsigned mask(Vec16 v) {
+	return static_cast<unsigned>(__builtin_ia32_pmovmskb128(v));
+}
+
+/*! \brief Bit mask of the most significant bit of each byte (AVX2)
+ * \param v vector
+ * \return mask with bit `n` set if byte `n` has its most significant bit set
+ */
+static inline __attribute__((always_inline, target("avx2"))) unsigned mask(Vec32 v) {
+	return static_cast<unsigned>(__builtin_ia32_pmovmskb256(v));
+}
+
+/*! \brief Multiply the lower 32 bits of each 64 bit lane (to 64 bit products)
+ * \param a first factors
+ * \param b second factors
+ * \return products
+ */
+static inline __attribute__((always_inline)) Vec2xU64 multiply32(Vec2xU64 a, Vec2xU64 b) {
+#ifdef __clang__
+	// Recognized as pmuludq (whereas GCC emits a full 64 bit multiplication)
+	return (a & 0xffffffffULL) * (b & 0xffffffffULL);
+#else
+	typedef int Vec4x32 __attribute__((vector_size(16)));
+	return reinterpret_cast<Vec2xU64>(__builtin_ia32_pmuludq128(reinterpret_cast<Vec4x32>(a), reinterpret_cast<Vec4x32>(b)));
+#endif
+}
+
+/*! \brief Multiply the lower 32 bits of each 64 bit lane (to 64 bit products, AVX2)
+ * \param a first factors
+ * \param b second factors
+ * \return products
+ */
+static inline __attribute__((always_inline, target("avx2"))) Vec4xU64 multiply32(Vec4xU64 a, Vec4xU64 b) {
+#ifdef __clang__
+	return (a & 0xffffffffULL) * (b & 0xffffffffULL);
+#else
+	typedef int Vec8x32 __attribute__((vector_size(32)));
+	return reinterpret_cast<Vec4xU64>(__builtin_ia32_pmuludq256(reinterpret_cast<Vec8x32>(a), reinterpret_cast<Vec8x32>(b)));
+#endif
+}
+
+/*! \brief Swap adjacent 64 bit lanes
+ * \param v vector
+ * \return vector with lanes `1, 0`
+ */
+static inline __attribute__((always_inline)) Vec2xU64 swap64(Vec2xU64 v) {
+	return __builtin_shufflevector(v, v, 1, 0);
+}
+
+/*! \brief Swap adjacent 64 bit lanes (AVX2)
+ * \param v vector
+ * \return vector with lanes `1, 0, 3, 2`
+ */
+static inline __attribute__((always_inline, target("avx2"))) Vec4xU64 swap64(Vec4xU64 v) {
+	return __builtin_shufflevector(v, v, 1, 0, 3, 2);
+}
+
+}  // namespace SIMD
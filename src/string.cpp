@@ -4,149 +4,48 @@
 
 #include <dlh/string.hpp>
 #include <dlh/mem.hpp>
+#include <dlh/arena.hpp>
 
 namespace String {
 
-static constexpr size_t concat(char *dest, const char *src, size_t n = SIZE_MAX) {
-	size_t i = 0;
-	if (dest != nullptr && src != nullptr)
-		while (i < n && (*dest++ = *src++) != '\0') { i++; }
-
-	return i;
+static inline char * alloc(size_t size, Memory::Arena * arena) {
+	return arena == nullptr ? Memory::alloc<char>(size) : arena->alloc<char>(size, 1);
 }
 
-static constexpr void prefix(const char* needle, size_t needle_len, size_t * n) {
-	assert(needle_len > 0 && n != nullptr);
-
-	for (size_t i = 0; i <= needle_len; i++)
-		n[i] = 0;
-
-	for (size_t j = 0, i = 1; i < needle_len; i++)  {
-		for (j = n[i + 1]; j > 0 && needle[j] != needle[i]; j = n[j]) {}
-		if (j > 0 || needle[j] == needle[i])
-			n[i + 1] = j + 1;
-	}
+static inline Vector<const char *> result(Memory::Arena * arena) {
+	return arena == nullptr ? Vector<const char *>() : Vector<const char *>(*arena);
 }
 
-static constexpr const char * find(const char *haystack, const char* needle, size_t haystack_len, size_t needle_len, const size_t * n, size_t & pos) {
-	assert(haystack_len > 0 && needle_len > 0 && n != nullptr);
-
-	if (haystack_len - pos >= needle_len) {
-		for (size_t i = pos, j = 0; i < haystack_len; i++) {
-			if (haystack[i] == needle[j]) {
-				if (++j == needle_len) {
-					pos = i - j + 1;
-					return haystack + pos;
-				}
-			} else if (j > 0) {
-				j = n[j];
-				i--;
-			}
-		}
-	}
-	return nullptr;
-}
+static char * duplicate(const char *s, size_t n, Memory::Arena * arena);
 
-const char * find_or_end(const char *s, int c) {
-	if (s != nullptr)
-		while(*s != '\0') {
-			if (*s == c)
-				break;
-			s++;
-		}
+static constexpr size_t concat(char *dest, const char *src, size_t n = SIZE_MAX) {
+	size_t i = 0;
+	if (dest != nullptr && src != nullptr)
+		while (i < n && (*dest++ = *src++) != '\0') { i++; }
 
-	return s;
+	return i;
 }
 
 const char* find_or_end(const char *haystack, const char* needle) {
-	size_t needle_len = len(needle);
-	if (needle_len == 0)
-		return haystack;
-
-	size_t haystack_len = len(haystack);
-	if (haystack_len == needle_len && compare(haystack, needle) == 0) {
+	if (haystack == nullptr || needle == nullptr)
 		return haystack;
-	} else if (haystack_len > needle_len) {
-		size_t n[needle_len + 1];
-		prefix(needle, needle_len, n);
-		size_t pos = 0;
-		const char * t = find(haystack, needle, haystack_len, needle_len, n, pos);
-		if (t != nullptr)
-			return t;
-	}
 
-	return haystack + haystack_len;
-}
-
-const char * find(const char *s, int c) {
-	if (s != nullptr)
-		while(*s != '\0') {
-			if (*s == c)
-				return s;
-			s++;
-		}
-
-	return nullptr;
+	const char * r = Searcher(needle).find(haystack);
+	return r != nullptr ? r : haystack + len(haystack);
 }
 
 const char* find(const char *haystack, const char* needle) {
 	if (haystack == nullptr || needle == nullptr)
 		return haystack;
 
-	size_t needle_len = len(needle);
-	if (needle_len == 0)
-		return haystack;
-
-	size_t haystack_len = len(haystack);
-	if (haystack_len == needle_len && compare(haystack, needle) == 0) {
-		return haystack;
-	} else if (haystack_len > needle_len) {
-		size_t n[needle_len + 1];
-		prefix(needle, needle_len, n);
-		size_t pos = 0;
-		return find(haystack, needle, haystack_len, needle_len, n, pos);
-	} else {
-		return nullptr;
-	}
-}
-
-const char * find_last(const char *s, int c) {
-	const char * last = nullptr;
-	if (s != nullptr)
-		while(*s != '\0') {
-			if (*s == c)
-				last = s;
-			s++;
-		}
-
-	return last;
+	return Searcher(needle).find(haystack);
 }
 
 const char* find_last(const char *haystack, const char* needle) {
 	if (haystack == nullptr || needle == nullptr)
 		return haystack;
 
-	size_t needle_len = len(needle);
-	if (needle_len == 0)
-		return const_cast<char*>(haystack);
-
-	size_t haystack_len = len(haystack);
-	if (haystack_len == needle_len && compare(haystack, needle) == 0) {
-		return const_cast<char*>(haystack);
-	} else if (haystack_len > needle_len) {
-		size_t n[needle_len + 1];
-		prefix(needle, needle_len, n);
-		size_t pos = 0;
-		const char *last = nullptr;
-		const char *tmp;
-		while ((tmp = find(haystack, needle, haystack_len, needle_len, n, pos)) != nullptr) {
-			last = tmp;
-			pos++;
-		}
-		return last;
-	} else {
-		return nullptr;
-	}
+	return Searcher(needle).find_last(haystack);
 }
 
 char * replace_inplace(char *target, int from, int to, size_t max) {
@@ -158,8 +57,16 @@ char * replace_inplace(char *target, int from, int to, size_t max) {
 	return target;
 }
 
+static char * replace(const char *source, int from, int to, size_t max, Memory::Arena * arena) {
+	return source == nullptr ? nullptr : replace_inplace(duplicate(source, len(source), arena), from, to, max);
+}
+
 char * replace(const char *source, int from, int to, size_t max) {
-	return source == nullptr ? nullptr : replace_inplace(duplicate(source), from, to, max);
+	return replace(source, from, to, max, nullptr);
+}
+
+char * replace(Memory::Arena & arena, const char *source, int from, int to, size_t max) {
+	return replace(source, from, to, max, &arena);
 }
 
 bool starts_with(const char *str, const char * start) {
@@ -188,15 +95,14 @@ static inline size_t split(const char *source, const char * delimiter, size_t so
 	if (delimiter_len > source_len)
 		return 0;
 
-	size_t n[delimiter_len + 1];
-	prefix(delimiter, delimiter_len, n);
+	const Searcher searcher(delimiter, delimiter_len);
 
 	size_t found = 0;
-	size_t pos = 0;
-	while (max > 0 && find(source, delimiter, source_len, delimiter_len, n, pos) != nullptr) {
+	const char * r;
+	for (size_t pos = 0; max > 0 && (r = searcher.find(source + pos, source_len - pos)) != nullptr; max--) {
+		pos = r - source;
 		part[found++] = pos;
 		pos += delimiter_len;
-		max--;
 	}
 
 	return found;
@@ -238,7 +144,7 @@ char * replace_inplace(char *target, size_t target_len, const char * from, const
 	return target;
 }
 
-char * replace(const char *source, const char * from, const char * to, size_t max) {
+static char * replace(const char *source, const char * from, const char * to, size_t max, Memory::Arena * arena) {
 	if (source == nullptr)
 		return nullptr;
 
@@ -249,11 +155,19 @@ char * replace(const char *source, const char * from, const char * to, size_t ma
 	size_t part[source_len / from_len];
 	size_t parts = split(source, from, source_len, from_len, part, max);
 
-	char * target = reinterpret_cast<char*>(Memory::alloc(1 + source_len + parts * (0 + to_len - from_len)));
+	char * target = alloc(1 + source_len + parts * (0 + to_len - from_len), arena);
 	combine(target, source, to, part, source_len, from_len, to_len, parts);
 	return target;
 }
 
+char * replace(const char *source, const char * from, const char * to, size_t max) {
+	return replace(source, from, to, max, nullptr);
+}
+
+char * replace(Memory::Arena & arena, const char *source, const char * from, const char * to, size_t max) {
+	return replace(source, from, to, max, &arena);
+}
+
 static constexpr char to_lower(char c) {
 	return c >= 'A' && c <= 'Z' ? static_cast<char>(c + 32) : c;
 }
@@ -297,14 +211,10 @@ char * copy(char *dest, const char *src, size_t n, bool zero_remainder) {
 	return dest;
 }
 
-char * duplicate(const char *s) {
-	return s == nullptr ? nullptr : duplicate(s, len(s));
-}
-
-char * duplicate(const char *s, size_t n) {
+static char * duplicate(const char *s, size_t n, Memory::Arena * arena) {
 	if (s == nullptr || n == 0)
 		return nullptr;
-	char * d = reinterpret_cast<char*>(Memory::alloc(n + 1));
+	char * d = alloc(n + 1, arena);
 	if (d != nullptr) {
 		copy(d, s, n);
 		d[n] = '\0';
@@ -312,116 +222,81 @@ char * duplicate(const char *s, size_t n) {
 	return d;
 }
 
-Vector<const char *> split_inplace(char * source, int delimiter, size_t max) {
+char * duplicate(const char *s) {
+	return s == nullptr ? nullptr : duplicate(s, len(s), nullptr);
+}
+
+char * duplicate(const char *s, size_t n) {
+	return duplicate(s, n, nullptr);
+}
+
+char * duplicate(Memory::Arena & arena, const char *s) {
+	return s == nullptr ? nullptr : duplicate(s, len(s), &arena);
+}
+
+char * duplicate(Memory::Arena & arena, const char *s, size_t n) {
+	return duplicate(s, n, &arena);
+}
+
+/*! \brief Collect all tokens (null-terminated in place)
+ * \param tokenizer tokenizer on a modifiable string
+ * \return Vector with pointers to the start of each token
+ */
+static Vector<const char *> split_inplace(Tokenizer tokenizer) {
 	Vector<const char *> r;
-	if (source != nullptr) {
-		bool push_next = true;
-		for (; *source != '\0'; ++source)
-			if (*source == delimiter && max > 0) {
-				*source = '\0';
-				if (!push_next)
-					max--;
-				push_next = true;
-			} else if (push_next) {
-				r.push_back(source);
-				push_next = false;
-			}
+	Tokenizer::Token token;
+	while (tokenizer.next(token)) {
+		// Replace delimiter (or overwrite the null byte at the end)
+		char * t = const_cast<char *>(token.str);
+		t[token.len] = '\0';
+		r.push_back(t);
 	}
 	return r;
 }
 
-Vector<const char *> split(const char * source, int delimiter, size_t max) {
-	Vector<const char *> r;
-	if (source != nullptr) {
-		size_t s = 0;
-		size_t i;
-		for (i = 0; source[i] != '\0'; ++i)
-			if (source[i] == delimiter && max > 0) {
-				if (s < i) {
-					char * t = duplicate(source + s, i - s);
-					if (t != nullptr) {
-						t[i - s] = '\0';
-						r.push_back(t);
-						max--;
-					}
-				}
-				s = i + 1;
-			}
-		if (s < i) {
-			char * t = duplicate(source + s, i - s);
-			if (t != nullptr)
-				r.push_back(t);
-		}
+/*! \brief Collect copies of all tokens
+ * \param tokenizer tokenizer
+ * \param arena arena to allocate from (or `nullptr` for heap)
+ * \return Vector with pointers to the duplicated tokens
+ */
+static Vector<const char *> split(Tokenizer tokenizer, Memory::Arena * arena) {
+	Vector<const char *> r = result(arena);
+	Tokenizer::Token token;
+	while (tokenizer.next(token)) {
+		char * t = duplicate(token.str, token.len, arena);
+		if (t != nullptr)
+			r.push_back(t);
 	}
 	return r;
 }
 
+Vector<const char *> split_inplace(char * source, int delimiter, size_t max) {
+	return split_inplace(Tokenizer(source, static_cast<char>(delimiter), max));
+}
+
+Vector<const char *> split(const char * source, int delimiter, size_t max) {
+	return split(Tokenizer(source, static_cast<char>(delimiter), max), nullptr);
+}
+
+Vector<const char *> split(Memory::Arena & arena, const char * source, int delimiter, size_t max) {
+	return split(Tokenizer(source, static_cast<char>(delimiter), max), &arena);
+}
+
 Vector<const char *> split_any(const char * source, const char * delimiter, size_t max) {
-	Vector<const char *> r;
-	if (source != nullptr) {
-		if (delimiter == nullptr) {
-			char * t = duplicate(source);
-			if (t != nullptr)
-				r.push_back(t);
-		} else {
-			size_t s = 0;
-			size_t i;
-			for (i = 0; source[i] != '\0'; ++i) {
-				bool found = false;
-				for (const char * d = delimiter; *d != '\0'; d++)
-					if (source[i] == *d) {
-						found = true;
-						break;
-					}
-				if (found && max > 0) {
-					if (s < i) {
-						char * t = duplicate(source + s, i - s);
-						if (t != nullptr) {
-							t[i - s] = '\0';
-							r.push_back(t);
-							max--;
-						}
-					}
-					s = i + 1;
-				}
-			}
-			if (s < i) {
-				char * t = duplicate(source + s, i - s);
-				if (t != nullptr)
-					r.push_back(t);
-			}
-		}
-	}
-	return r;
+	return split(Tokenizer(source, delimiter, max), nullptr);
+}
+
+Vector<const char *> split_any(Memory::Arena & arena, const char * source, const char * delimiter, size_t max) {
+	return split(Tokenizer(source, delimiter, max), &arena);
 }
 
 Vector<const char *> split_any_inplace(char * source, const char * delimiter, size_t max) {
-	Vector<const char *> r;
-	if (source != nullptr) {
-		if (delimiter == nullptr) {
-			r.push_back(source);
-		} else {
-			bool push_next = true;
-			for (; *source != '\0'; ++source) {
-				bool found = false;
-				for (const char * d = delimiter; *d != '\0'; d++)
-					if (*source == *d) {
-						found = true;
-						break;
-					}
-				if (found && max > 0) {
-					*source = '\0';
-					if (!push_next)
-						max--;
-					push_next = true;
-				} else if (push_next) {
-					r.push_back(source);
-					push_next = false;
-				}
-			}
-		}
+	if (source != nullptr && delimiter == nullptr) {
+		Vector<const char *> r;
+		r.push_back(source);
+		return r;
 	}
-	return r;
+	return split_inplace(Tokenizer(source, delimiter, max));
 }
 
 Vector<const char *> split_inplace(char * source, const char * delimiter, size_t max) {
@@ -454,8 +329,8 @@ Vector<const char *> split_inplace(char * source, const char * delimiter, size_t
 }
 
 
-Vector<const char *> split(const char * source, const char * delimiter, size_t max) {
-	Vector<const char *> r;
+static Vector<const char *> split(const char * source, const char * delimiter, size_t max, Memory::Arena * arena) {
+	Vector<const char *> r = result(arena);
 
 	if (source != nullptr) {
 		size_t delimiter_len = len(delimiter);
@@ -468,7 +343,7 @@ Vector<const char *> split(const char * source, const char * delimiter, size_t m
 		for (size_t f = 0; f < found; f++) {
 			size_t len = part[f] - pos;
 			if (len > 0 && max > 0) {
-				char * t = duplicate(source + pos, len);
+				char * t = duplicate(source + pos, len, arena);
 				if (t != nullptr) {
 					r.push_back(t);
 					max--;
@@ -479,7 +354,7 @@ Vector<const char *> split(const char * source, const char * delimiter, size_t m
 				break;
 		}
 		if (pos < source_len) {
-			char * t = duplicate(source + pos, source_len - pos);
+			char * t = duplicate(source + pos, source_len - pos, arena);
 			if (t != nullptr)
 				r.push_back(t);
 		}
@@ -488,4 +363,12 @@ Vector<const char *> split(const char * source, const char * delimiter, size_t m
 	return r;
 }
 
+Vector<const char *> split(const char * source, const char * delimiter, size_t max) {
+	return split(source, delimiter, max, nullptr);
+}
+
+Vector<const char *> split(Memory::Arena & arena, const char * source, const char * delimiter, size_t max) {
+	return split(source, delimiter, max, &arena);
+}
+
 }  // namespace String
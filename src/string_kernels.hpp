@@ -0,0 +1,231 @@
+// Dirty Little Helper (DLH) - system support library for C/C++
+// Copyright 2021-2023 by Bernhard Heinloth <heinloth@cs.fau.de>
+// SPDX-License-Identifier: AGPL-3.0-or-later
+
+/*! \file
+ *  \brief SIMD kernels for null-terminated strings
+ *
+ * This file is included once per instruction set (without include guard),
+ * the following macros have to be defined:
+ *  - `STRING_KERNEL_NAMESPACE` namespace for the kernels
+ *  - `STRING_KERNEL_TARGET` function attributes (e.g. target instruction set)
+ *  - `STRING_KERNEL_VECTOR` vector type
+ *
+ * All loads from a string are either aligned to the vector size or checked
+ * not to cross a page boundary, hence they never touch an unmapped page
+ * (even if reading beyond the terminating null byte).
+ */
+
+#include <dlh/mem.hpp>
+#include <dlh/types.hpp>
+
+#include "simd.hpp"
+
+namespace STRING_KERNEL_NAMESPACE {
+
+using SIMD::load;
+using SIMD::loadu;
+using SIMD::mask;
+
+typedef STRING_KERNEL_VECTOR Vec;
+
+/*! \brief Bytes per vector */
+static const size_t N = sizeof(Vec);
+
+/*! \brief Minimum page size (unaligned loads must not cross it) */
+static const uintptr_t PAGE_SIZE = 4096;
+
+/*! \brief Get first aligned block of a string
+ * \param s string
+ * \param[out] block address of aligned block containing the first byte
+ * \return number of bytes in the block before the string
+ */
+static inline __attribute__((always_inline)) unsigned first(const char * s, uintptr_t & block) {
+	uintptr_t p = reinterpret_cast<uintptr_t>(s);
+	block = p & ~static_cast<uintptr_t>(N - 1);
+	return static_cast<unsigned>(p - block);
+}
+
+/*! \brief Length of a string
+ * \param s string (not `nullptr`)
+ * \param n maximum length
+ * \return number of bytes before the null byte (but at most `n`)
+ */
+static STRING_KERNEL_TARGET size_t len(const char * s, size_t n) {
+	uintptr_t block;
+	const unsigned skip = first(s, block);
+	const uintptr_t start = reinterpret_cast<uintptr_t>(s);
+	unsigned m = mask(load<Vec>(block) == Vec{}) >> skip;
+	if (m != 0) {
+		size_t r = __builtin_ctz(m);
+		return r < n ? r : n;
+	}
+	for (block += N; block - start < n; block += N) {
+		m = mask(load<Vec>(block) == Vec{});
+		if (m != 0) {
+			size_t r = block - start + __builtin_ctz(m);
+			return r < n ? r : n;
+		}
+	}
+	return n;
+}
+
+/*! \brief Find the first occurrence of a character or the end of a string
+ * \param s string (not `nullptr`)
+ * \param c character
+ * \return pointer to first occurrence of the character or the null byte
+ */
+static STRING_KERNEL_TARGET const char * find_or_end(const char * s, char c) {
+	uintptr_t block;
+	const unsigned skip = first(s, block);
+	const Vec cv = Vec{} + c;
+	Vec v = load<Vec>(block);
+	unsigned m = mask((v == Vec{}) | (v == cv)) >> skip;
+	if (m != 0)
+		return s + __builtin_ctz(m);
+	while (true) {
+		block += N;
+		v = load<Vec>(block);
+		m = mask((v == Vec{}) | (v == cv));
+		if (m != 0)
+			return reinterpret_cast<const char *>(block) + __builtin_ctz(m);
+	}
+}
+
+/*! \brief Find the last occurrence of a character in a string
+ * \param s string (not `nullptr`)
+ * \param c character (not null byte)
+ * \return pointer to last occurrence of the character or `nullptr` if not found
+ */
+static STRING_KERNEL_TARGET const char * find_last(const char * s, char c) {
+	uintptr_t block;
+	unsigned skip = first(s, block);
+	const Vec cv = Vec{} + c;
+	const char * last = nullptr;
+	while (true) {
+		Vec v = load<Vec>(block);
+		unsigned z = mask(v == Vec{}) >> skip << skip;
+		unsigned m = mask(v == cv) >> skip << skip;
+		if (z != 0)
+			// Only bytes before the null byte
+			m &= z ^ (z - 1);
+		if (m != 0)
+			last = reinterpret_cast<const char *>(block) + 31 - __builtin_clz(m);
+		if (z != 0)
+			return last;
+		block += N;
+		skip = 0;
+	}
+}
+
+/*! \brief Compare two strings
+ * \param s1 first string (not `nullptr`)
+ * \param s2 second string (not `nullptr`)
+ * \param n maximum number of bytes to compare
+ * \return difference of the first differing characters (or `0` if equal)
+ */
+static STRING_KERNEL_TARGET int compare(const char * s1, const char * s2, size_t n) {
+	const uintptr_t p1 = reinterpret_cast<uintptr_t>(s1);
+	const uintptr_t p2 = reinterpret_cast<uintptr_t>(s2);
+	size_t i = 0;
+	while (i < n) {
+		if (((p1 + i) & (PAGE_SIZE - 1)) > PAGE_SIZE - N || ((p2 + i) & (PAGE_SIZE - 1)) > PAGE_SIZE - N) {
+			// Block would cross a page boundary, hence compare bytewise
+			for (size_t end = i + N; i < end && i < n; i++) {
+				if (s1[i] != s2[i])
+					return static_cast<int>(s1[i]) - static_cast<int>(s2[i]);
+				else if (s1[i] == '\0')
+					return 0;
+			}
+		} else {
+			Vec a = loadu<Vec>(p1 + i), b = loadu<Vec>(p2 + i);
+			unsigned m = mask((a != b) | (a == Vec{}));
+			if (n - i < N)
+				m &= (1U << (n - i)) - 1;
+			if (m != 0) {
+				i += __builtin_ctz(m);
+				return static_cast<int>(s1[i]) - static_cast<int>(s2[i]);
+			}
+			i += N;
+		}
+	}
+	return 0;
+}
+
+/*! \brief Find a (short) needle in a buffer
+ * Candidates are positions where both the first and the last character of
+ * the needle match, only those are compared completely.
+ * \param haystack buffer to search in
+ * \param haystack_len length of the buffer
+ * \param needle string to find
+ * \param needle_len length of the needle (not zero)
+ * \return pointer to first occurrence of the needle or `nullptr` if not found
+ */
+static STRING_KERNEL_TARGET const char * search(const char * haystack, size_t haystack_len, const char * needle, size_t needle_len) {
+	const uintptr_t h = reinterpret_cast<uintptr_t>(haystack);
+	const Vec head = Vec{} + needle[0];
+	const Vec tail = Vec{} + needle[needle_len - 1];
+	const size_t inner = needle_len < 2 ? 0 : needle_len - 2;
+	size_t i = 0;
+	// Both loads stay within the buffer
+	for (; i + needle_len - 1 + N <= haystack_len; i += N) {
+		unsigned m = mask((loadu<Vec>(h + i) == head) & (loadu<Vec>(h + i + needle_len - 1) == tail));
+		while (m != 0) {
+			size_t pos = i + __builtin_ctz(m);
+			if (Memory::compare(h + pos + 1, reinterpret_cast<uintptr_t>(needle + 1), inner) == 0)
+				return haystack + pos;
+			m &= m - 1;
+		}
+	}
+	for (; i + needle_len <= haystack_len; i++)
+		if (haystack[i] == needle[0] && haystack[i + needle_len - 1] == needle[needle_len - 1]
+		 && Memory::compare(h + i + 1, reinterpret_cast<uintptr_t>(needle + 1), inner) == 0)
+			return haystack + i;
+	return nullptr;
+}
+
+/*! \brief Bit mask of bytes contained in a set of characters
+ * \param v vector to check
+ * \param set characters to match
+ * \param set_len number of characters in the set (not zero)
+ * \return mask with bit `n` set if byte `n` is contained in the set
+ */
+static inline __attribute__((always_inline)) STRING_KERNEL_TARGET unsigned match_any(Vec v, const char * set, size_t set_len) {
+	Vec m = v == (Vec{} + set[0]);
+	for (size_t j = 1; j < set_len; j++)
+		m |= v == (Vec{} + set[j]);
+	return mask(m);
+}
+
+/*! \brief Find the first character of a buffer contained in a set
+ * \param s buffer (may contain null bytes)
+ * \param n length of the buffer
+ * \param set characters to find
+ * \param set_len number of characters in the set (not zero)
+ * \return pointer to first character contained in the set or `s + n` if not found
+ */
+static STRING_KERNEL_TARGET const char * find_any(const char * s, size_t n, const char * set, size_t set_len) {
+	const uintptr_t p = reinterpret_cast<uintptr_t>(s);
+	size_t i = 0;
+	for (; i + N <= n; i += N) {
+		unsigned m = match_any(loadu<Vec>(p + i), set, set_len);
+		if (m != 0)
+			return s + i + __builtin_ctz(m);
+	}
+	if (i < n) {
+		if (n >= N) {
+			// Last vector overlapping with the previous one
+			unsigned m = match_any(loadu<Vec>(p + n - N), set, set_len) >> (i + N - n);
+			if (m != 0)
+				return s + i + __builtin_ctz(m);
+		} else {
+			for (; i < n; i++)
+				for (size_t j = 0; j < set_len; j++)
+					if (s[i] == set[j])
+						return s + i;
+		}
+	}
+	return s + n;
+}
+
+}  // namespace STRING_KERNEL_NAMESPACE
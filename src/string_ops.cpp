@@ -0,0 +1,289 @@
+// Dirty Little Helper (DLH) - system support library for C/C++
+// Copyright 2021-2023 by Bernhard Heinloth <heinloth@cs.fau.de>
+// SPDX-License-Identifier: AGPL-3.0-or-later
+
+#include <dlh/string.hpp>
+#include <dlh/math.hpp>
+#include <dlh/cpu.hpp>
+#include <dlh/mem.hpp>
+
+// SSE2 kernels (x86_64 baseline)
+#define STRING_KERNEL_NAMESPACE SSE2
+#define STRING_KERNEL_TARGET
+#define STRING_KERNEL_VECTOR SIMD::Vec16
+#include "string_kernels.hpp"
+#undef STRING_KERNEL_NAMESPACE
+#undef STRING_KERNEL_TARGET
+#undef STRING_KERNEL_VECTOR
+
+// AVX2 kernels
+#define STRING_KERNEL_NAMESPACE AVX2
+#define STRING_KERNEL_TARGET __attribute__((target("avx2")))
+#define STRING_KERNEL_VECTOR SIMD::Vec32
+#include "string_kernels.hpp"
+#undef STRING_KERNEL_NAMESPACE
+#undef STRING_KERNEL_TARGET
+#undef STRING_KERNEL_VECTOR
+
+namespace String {
+
+static Cpu::Dispatch<size_t(const char *, size_t)>::Function resolve_len() {
+	return Cpu::has(Cpu::AVX2) ? AVX2::len : SSE2::len;
+}
+static Cpu::Dispatch<size_t(const char *, size_t)> len_kernel(resolve_len);
+
+static Cpu::Dispatch<const char *(const char *, char)>::Function resolve_find_or_end() {
+	return Cpu::has(Cpu::AVX2) ? AVX2::find_or_end : SSE2::find_or_end;
+}
+static Cpu::Dispatch<const char *(const char *, char)> find_or_end_kernel(resolve_find_or_end);
+
+static Cpu::Dispatch<const char *(const char *, char)>::Function resolve_find_last() {
+	return Cpu::has(Cpu::AVX2) ? AVX2::find_last : SSE2::find_last;
+}
+static Cpu::Dispatch<const char *(const char *, char)> find_last_kernel(resolve_find_last);
+
+static Cpu::Dispatch<int(const char *, const char *, size_t)>::Function resolve_compare() {
+	return Cpu::has(Cpu::AVX2) ? AVX2::compare : SSE2::compare;
+}
+static Cpu::Dispatch<int(const char *, const char *, size_t)> compare_kernel(resolve_compare);
+
+static Cpu::Dispatch<const char *(const char *, size_t, const char *, size_t)>::Function resolve_search() {
+	return Cpu::has(Cpu::AVX2) ? AVX2::search : SSE2::search;
+}
+static Cpu::Dispatch<const char *(const char *, size_t, const char *, size_t)> search_kernel(resolve_search);
+
+static Cpu::Dispatch<const char *(const char *, size_t, const char *, size_t)>::Function resolve_find_any() {
+	return Cpu::has(Cpu::AVX2) ? AVX2::find_any : SSE2::find_any;
+}
+static Cpu::Dispatch<const char *(const char *, size_t, const char *, size_t)> find_any_kernel(resolve_find_any);
+
+namespace Vectorized {
+
+size_t len(const char *s, size_t n) {
+	return len_kernel(s, n);
+}
+
+int compare(const char *s1, const char *s2, size_t n) {
+	return compare_kernel(s1, s2, n);
+}
+
+}  // namespace Vectorized
+
+const char * find_or_end(const char *s, int c) {
+	return s == nullptr ? nullptr : find_or_end_kernel(s, static_cast<char>(c));
+}
+
+const char * find(const char *s, int c) {
+	if (s == nullptr || static_cast<char>(c) == '\0')
+		return nullptr;
+	const char * r = find_or_end_kernel(s, static_cast<char>(c));
+	return *r == '\0' ? nullptr : r;
+}
+
+const char * find_last(const char *s, int c) {
+	if (s == nullptr || static_cast<char>(c) == '\0')
+		return nullptr;
+	return find_last_kernel(s, static_cast<char>(c));
+}
+
+/*! \brief Maximal suffix of a string (for the critical factorization)
+ * \param needle string
+ * \param needle_len length of string
+ * \param[out] period period of the suffix
+ * \param reverse use reverse alphabet order
+ * \return position before the maximal suffix (`-1` for the whole string)
+ */
+static ssize_t maximal_suffix(const unsigned char * needle, size_t needle_len, size_t & period, bool reverse) {
+	ssize_t suffix = -1;
+	size_t j = 0, k = 1;
+	period = 1;
+	while (j + k < needle_len) {
+		unsigned char a = needle[j + k];
+		unsigned char b = needle[suffix + k];
+		if (reverse ? a > b : a < b) {
+			j += k;
+			k = 1;
+			period = j - suffix;
+		} else if (a == b) {
+			if (k != period) {
+				k++;
+			} else {
+				j += period;
+				k = 1;
+			}
+		} else {
+			suffix = j;
+			j = suffix + 1;
+			k = period = 1;
+		}
+	}
+	return suffix;
+}
+
+Searcher::Searcher(const char * needle) : Searcher(needle, len(needle)) {}
+
+Searcher::Searcher(const char * needle, size_t needle_len) : _needle(needle), _len(needle == nullptr ? 0 : needle_len) {
+	if (_len > SHORT) {
+		// Critical factorization
+		const unsigned char * n = reinterpret_cast<const unsigned char *>(needle);
+		size_t p, q;
+		ssize_t i = maximal_suffix(n, _len, p, false);
+		ssize_t j = maximal_suffix(n, _len, q, true);
+		if (i > j) {
+			_critical = i;
+			_period = p;
+		} else {
+			_critical = j;
+			_period = q;
+		}
+		// Periodic needle (the left part occurs again after one period)?
+		_periodic = Memory::compare(needle, needle + _period, static_cast<size_t>(_critical + 1)) == 0;
+		if (!_periodic)
+			_period = Math::max(static_cast<size_t>(_critical + 1), _len - static_cast<size_t>(_critical + 1)) + 1;
+
+		// Distance of last occurrence of each character to the end of the needle
+		const uint16_t limit = static_cast<uint16_t>(Math::min(_len, static_cast<size_t>(UINT16_MAX)));
+		for (auto & shift : _shift)
+			shift = limit;
+		for (size_t i = _len - limit; i < _len; i++)
+			_shift[n[i]] = static_cast<uint16_t>(_len - 1 - i);
+	}
+}
+
+const char * Searcher::two_way(const char * haystack, size_t haystack_len) const {
+	const char * x = _needle;
+	const unsigned char * h = reinterpret_cast<const unsigned char *>(haystack);
+	const ssize_t m = static_cast<ssize_t>(_len);
+	const ssize_t ell = _critical;
+	if (_periodic) {
+		// Prefix matched in the previous attempt
+		ssize_t memory = -1;
+		for (size_t j = 0; j + _len <= haystack_len;) {
+			// Skip windows with mismatching last character
+			size_t shift = _shift[h[j + _len - 1]];
+			if (shift > 0) {
+				if (memory >= 0 && shift < _len - _period)
+					shift = _len - _period;
+				memory = -1;
+				j += shift;
+				continue;
+			}
+			const char * y = haystack + j;
+			ssize_t i = Math::max(ell, memory) + 1;
+			while (i < m - 1 && x[i] == y[i])
+				i++;
+			if (i >= m - 1) {
+				i = ell;
+				while (i > memory && x[i] == y[i])
+					i--;
+				if (i <= memory)
+					return y;
+				j += _period;
+				memory = m - static_cast<ssize_t>(_period) - 1;
+			} else {
+				j += i - ell;
+				memory = -1;
+			}
+		}
+	} else {
+		for (size_t j = 0; j + _len <= haystack_len;) {
+			size_t shift = _shift[h[j + _len - 1]];
+			if (shift > 0) {
+				j += shift;
+				continue;
+			}
+			const char * y = haystack + j;
+			ssize_t i = ell + 1;
+			while (i < m - 1 && x[i] == y[i])
+				i++;
+			if (i >= m - 1) {
+				i = ell;
+				while (i >= 0 && x[i] == y[i])
+					i--;
+				if (i < 0)
+					return y;
+				j += _period;
+			} else {
+				j += i - ell;
+			}
+		}
+	}
+	return nullptr;
+}
+
+const char * Searcher::find(const char * haystack, size_t haystack_len) const {
+	if (haystack == nullptr || _len == 0)
+		return haystack;
+	else if (haystack_len < _len)
+		return nullptr;
+	else if (_len <= SHORT)
+		return search_kernel(haystack, haystack_len, _needle, _len);
+	else
+		return two_way(haystack, haystack_len);
+}
+
+const char * Searcher::find(const char * haystack) const {
+	if (haystack == nullptr || _len == 0)
+		return haystack;
+
+	// Determine the length of the haystack step by step (in case of an early match)
+	const size_t chunk = Math::max(static_cast<size_t>(4096), 4 * _len);
+	size_t start = 0;
+	size_t end = 0;
+	while (true) {
+		size_t l = len(haystack + end, chunk);
+		end += l;
+		if (end - start >= _len) {
+			const char * r = find(haystack + start, end - start);
+			if (r != nullptr)
+				return r;
+			start = end - _len + 1;
+		}
+		if (l < chunk)
+			return nullptr;
+	}
+}
+
+const char * Searcher::find_last(const char * haystack) const {
+	if (haystack == nullptr || _len == 0)
+		return haystack;
+
+	size_t haystack_len = len(haystack);
+	const char * last = nullptr;
+	for (const char * r = haystack; (r = find(r, haystack_len - static_cast<size_t>(r - haystack))) != nullptr; r++)
+		last = r;
+	return last;
+}
+
+Tokenizer::Tokenizer(const char * source, size_t source_len, const char * delimiters, size_t max) : _pos(source), _end(source == nullptr ? nullptr : source + source_len), _delimiters(delimiters == nullptr ? "" : delimiters), _delimiters_len(len(_delimiters)), _delimiter('\0'), _max(max) {}
+
+Tokenizer::Tokenizer(const char * source, const char * delimiters, size_t max) : Tokenizer(source, source == nullptr ? 0 : len(source), delimiters, max) {}
+
+Tokenizer::Tokenizer(const char * source, size_t source_len, char delimiter, size_t max) : _pos(source), _end(source == nullptr ? nullptr : source + source_len), _delimiters(nullptr), _delimiters_len(1), _delimiter(delimiter), _max(max) {}
+
+Tokenizer::Tokenizer(const char * source, char delimiter, size_t max) : Tokenizer(source, source == nullptr ? 0 : len(source), delimiter, max) {}
+
+bool Tokenizer::next(Token & token) {
+	// The single delimiter is not referenced by pointer since the tokenizer might be copied
+	const char * set = _delimiters == nullptr ? &_delimiter : _delimiters;
+	while (_pos < _end) {
+		const char * d = _max == 0 || _delimiters_len == 0 ? _end : find_any_kernel(_pos, static_cast<size_t>(_end - _pos), set, _delimiters_len);
+		if (d == _pos) {
+			// Omit empty token
+			_pos++;
+		} else {
+			token.str = _pos;
+			token.len = static_cast<size_t>(d - _pos);
+			if (d < _end) {
+				_pos = d + 1;
+				_max--;
+			} else {
+				_pos = _end;
+			}
+			return true;
+		}
+	}
+	return false;
+}
+
+}  // namespace String
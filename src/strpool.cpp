@@ -0,0 +1,68 @@
+// Dirty Little Helper (DLH) - system support library for C/C++
+// Copyright 2021-2023 by Bernhard Heinloth <heinloth@cs.fau.de>
+// SPDX-License-Identifier: AGPL-3.0-or-later
+
+#include <dlh/strpool.hpp>
+#include <dlh/mem.hpp>
+
+StringPool & StringPool::global() {
+	// Constructed on first use, hence available in static constructors of other translation units
+	static StringPool pool;
+	return pool;
+}
+
+// Construct during static initialization at the latest (since the construction on first use is not thread safe)
+static StringPool & global_pool = StringPool::global();
+
+Atom StringPool::find(const StrPtr & s) {
+	if (s.str == nullptr)
+		return Atom();
+
+	GuardedReader<Mutex> guard(_lock);
+	// Const lookup (the non-const one migrates elements in incremental mode)
+	const auto & strings = _strings;
+	auto i = strings.find(s);
+	return i == strings.end() ? Atom() : Atom(i->str);
+}
+
+Atom StringPool::intern(const StrPtr & s) {
+	if (s.str == nullptr || s.len > UINT32_MAX)
+		return Atom();
+
+	// Already interned?
+	Atom a = find(s);
+	if (a)
+		return a;
+
+	GuardedWriter<Mutex> guard(_lock);
+	// Check again (might have been interned in the meantime)
+	auto i = _strings.find(s);
+	if (i != _strings.end())
+		return Atom(i->str);
+
+	const size_t size = sizeof(Atom::Header) + s.len + 1;
+	Atom::Header * header = _arena.alloc<Atom::Header>(size, alignof(Atom::Header));
+	if (header == nullptr)
+		return Atom();
+	header->hash = s.hash;
+	header->len = static_cast<uint32_t>(s.len);
+	char * str = reinterpret_cast<char *>(header + 1);
+	Memory::copy(str, s.str, s.len);
+	str[s.len] = '\0';
+
+	StrPtr interned(s);
+	interned.str = str;
+	_strings.insert(interned);
+	_bytes += size;
+	return Atom(str);
+}
+
+size_t StringPool::size() {
+	GuardedReader<Mutex> guard(_lock);
+	return _strings.size();
+}
+
+size_t StringPool::bytes() {
+	GuardedReader<Mutex> guard(_lock);
+	return _bytes;
+}
@@ -116,6 +116,10 @@ ReturnValue<int> getrlimit(rlimit_t resource, struct rlimit *rlim) {
 	}
 }
 
+ReturnValue<int> sched_getaffinity(pid_t pid, size_t size, void * mask) {
+	return retval<int>(__syscall(SYS_sched_getaffinity, pid, size, mask));
+}
+
 ReturnValue<int> arch_prctl(arch_code_t code, unsigned long addr) {
 	return retval<int>(__syscall(SYS_arch_prctl, code, addr));
 }
@@ -217,6 +221,10 @@ ReturnValue<int> msync(uintptr_t start, size_t len, int flags) {
 	return retval<int>(__syscall(SYS_msync, start, len, flags));
 }
 
+ReturnValue<int> madvise(uintptr_t start, size_t len, int advice) {
+	return retval<int>(__syscall(SYS_madvise, start, len, advice));
+}
+
 
 ReturnValue<int> access(const char *filename, int amode) {
 	int r = __syscall(SYS_access, filename, amode);
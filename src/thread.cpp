@@ -3,6 +3,7 @@
 // SPDX-License-Identifier: AGPL-3.0-or-later
 
 #include <dlh/thread.hpp>
+#include <dlh/mem.hpp>
 #include <dlh/math.hpp>
 #include <dlh/assert.hpp>
 #include <dlh/string.hpp>
@@ -62,7 +63,8 @@ Thread * Thread::create(void* (*func)(void*), void * arg, bool detach, bool sepa
 			              "1:;"
 			              : "=a"(pid) : "a"(SYS_clone), "D"(flags), "S"(top_of_stack), "d"(&(that->tid)), "r"(child_tid), "r"(that_param): "rcx", "r11", "memory");
 			if (pid > 0) {
-				assert(pid == that->tid);
+				// Thread ID is cleared by the kernel if the child has already exited
+				assert(pid == __atomic_load_n(&(that->tid), __ATOMIC_RELAXED) || __atomic_load_n(&(that->tid), __ATOMIC_RELAXED) == 0);
 				return that;
 			}
 		}
@@ -76,6 +78,9 @@ void Thread::exit(void * result) {
 	assert(self() == this);
 	this->result = result;
 
+	// Return cached memory blocks
+	Memory::thread_cache_release();
+
 /*
 	in ASM:
 	if (detached() && map_base != nullptr)
@@ -90,7 +95,7 @@ void Thread::exit(void * result) {
 	              "mov %4,%%rax\n\t"
 	              "syscall\n\t"
 	              "hlt\n\t"
-	              :: "a"(SYS_munmap), "D"(map_base), "S"(map_size), "d"(detached() && map_base != 0), "i"(SYS_exit): "rcx", "r11", "memory");
+	              :: "a"(SYS_munmap), "D"(map_base), "S"(map_size), "d"(static_cast<unsigned>(detached() && map_base != 0)), "i"(SYS_exit): "rcx", "r11", "memory");
 }
 
 int Thread::kill(signal_t sig) {
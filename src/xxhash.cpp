@@ -0,0 +1,225 @@
+// Dirty Little Helper (DLH) - system support library for C/C++
+// Copyright 2021-2023 by Bernhard Heinloth <heinloth@cs.fau.de>
+// SPDX-License-Identifier: AGPL-3.0-or-later
+
+#include <dlh/xxhash.hpp>
+#include <dlh/cpu.hpp>
+#include <dlh/mem.hpp>
+
+#include "simd.hpp"
+
+// SSE2 kernels (x86_64 baseline)
+#define XXHASH_KERNEL_NAMESPACE SSE2
+#define XXHASH_KERNEL_TARGET
+#define XXHASH_KERNEL_VECTOR SIMD::Vec2xU64
+#include "xxhash_kernels.hpp"
+#undef XXHASH_KERNEL_NAMESPACE
+#undef XXHASH_KERNEL_TARGET
+#undef XXHASH_KERNEL_VECTOR
+
+// AVX2 kernels
+#define XXHASH_KERNEL_NAMESPACE AVX2
+#define XXHASH_KERNEL_TARGET __attribute__((target("avx2")))
+#define XXHASH_KERNEL_VECTOR SIMD::Vec4xU64
+#include "xxhash_kernels.hpp"
+#undef XXHASH_KERNEL_NAMESPACE
+#undef XXHASH_KERNEL_TARGET
+#undef XXHASH_KERNEL_VECTOR
+
+using SIMD::loadu;
+
+// Secret offset for the last stripe
+static const size_t SECRET_LIMIT = XXHash3::SecretSize - XXHash3::StripeLen;
+
+// Initial accumulator values
+static const uint64_t INIT_ACC[8] = {
+	0xC2B2AE3DULL, 0x9E3779B185EBCA87ULL, 0xC2B2AE3D27D4EB4FULL, 0x165667B19E3779F9ULL,
+	0x85EBCA77C2B2AE63ULL, 0x85EBCA77ULL, 0x27D4EB2F165667C5ULL, 0x9E3779B1ULL
+};
+
+static inline __attribute__((always_inline)) uint64_t read64(const unsigned char * p) {
+	return loadu<uint64_t>(reinterpret_cast<uintptr_t>(p));
+}
+
+/*! \brief Accumulate a single stripe (64 bytes) without SIMD
+ * Used for the last (overlapping) stripe only.
+ * \param acc accumulators
+ * \param input stripe
+ * \param secret secret for this stripe
+ */
+static inline __attribute__((always_inline)) void accumulate_scalar(uint64_t * acc, const unsigned char * input, const unsigned char * secret) {
+	for (size_t i = 0; i < 8; i++) {
+		const uint64_t data = read64(input + 8 * i);
+		const uint64_t key = data ^ read64(secret + 8 * i);
+		acc[i ^ 1] += data;
+		acc[i] += (key & 0xffffffff) * (key >> 32);
+	}
+}
+
+/*! \brief Select kernel for processing stripes */
+static Cpu::Dispatch<size_t(uint64_t *, size_t, const unsigned char *, size_t, const unsigned char *)>::Function resolve_consume() {
+	return Cpu::has(Cpu::AVX2) ? AVX2::consume : SSE2::consume;
+}
+static Cpu::Dispatch<size_t(uint64_t *, size_t, const unsigned char *, size_t, const unsigned char *)> consume_kernel(resolve_consume);
+
+/*! \brief Derive secret from seed
+ * \param secret target buffer
+ * \param base default secret
+ * \param seed seed value
+ */
+static void derive(unsigned char * secret, const unsigned char * base, uint64_t seed) {
+	for (size_t i = 0; i < XXHash3::SecretSize; i += 16) {
+		SIMD::storeu<uint64_t>(reinterpret_cast<uintptr_t>(secret + i), read64(base + i) + seed);
+		SIMD::storeu<uint64_t>(reinterpret_cast<uintptr_t>(secret + i + 8), read64(base + i + 8) - seed);
+	}
+}
+
+/*! \brief Merge accumulators into the final hash */
+static uint64_t merge(const uint64_t * acc, const unsigned char * secret, uint64_t start) {
+	uint64_t result = start;
+	for (size_t i = 0; i < 4; i++) {
+		__uint128_t r = static_cast<__uint128_t>(acc[2 * i] ^ read64(secret + 16 * i)) * (acc[2 * i + 1] ^ read64(secret + 16 * i + 8));
+		result += static_cast<uint64_t>(r) ^ static_cast<uint64_t>(r >> 64);
+	}
+	result ^= result >> 37;
+	result *= 0x165667919E3779F9ULL;
+	return result ^ (result >> 32);
+}
+
+/*! \brief Accumulate input with more than 240 bytes
+ * \param acc accumulators
+ * \param input input data
+ * \param length number of bytes
+ * \param secret secret
+ */
+static void accumulate(uint64_t * acc, const unsigned char * input, size_t length, const unsigned char * secret) {
+	Memory::copy(acc, INIT_ACC, sizeof(INIT_ACC));
+	consume_kernel(acc, 0, input, (length - 1) / XXHash3::StripeLen, secret);
+	// Last (overlapping) stripe
+	accumulate_scalar(acc, input + length - XXHash3::StripeLen, secret + SECRET_LIMIT - 7);
+}
+
+uint64_t XXHash3::hashLong(const void * input, size_t length, uint64_t seed) {
+	unsigned char custom[SecretSize];
+	const unsigned char * sec = Secret;
+	if (seed != 0) {
+		derive(custom, Secret, seed);
+		sec = custom;
+	}
+	uint64_t acc[8];
+	accumulate(acc, reinterpret_cast<const unsigned char *>(input), length, sec);
+	return merge(acc, sec + 11, length * Prime64_1);
+}
+
+XXHash3::Hash128 XXHash3::hashLong128(const void * input, size_t length, uint64_t seed) {
+	unsigned char custom[SecretSize];
+	const unsigned char * sec = Secret;
+	if (seed != 0) {
+		derive(custom, Secret, seed);
+		sec = custom;
+	}
+	uint64_t acc[8];
+	accumulate(acc, reinterpret_cast<const unsigned char *>(input), length, sec);
+	return { merge(acc, sec + 11, length * Prime64_1), merge(acc, sec + SecretSize - StripeLen - 11, ~(length * Prime64_2)) };
+}
+
+void XXHash3::reset(uint64_t seed) {
+	Memory::copy(acc, INIT_ACC, sizeof(INIT_ACC));
+	derive(secret, Secret, seed);
+	bufferSize = 0;
+	stripes = 0;
+	totalLength = 0;
+	this->seed = seed;
+}
+
+bool XXHash3::add(const void* input, uint64_t length) {
+	if (length == 0)
+		return false;
+
+	if (input == nullptr)
+		return addZeros(length);
+
+	totalLength += length;
+	const unsigned char * data = reinterpret_cast<const unsigned char *>(input);
+
+	// Small input: just store it in the buffer
+	if (bufferSize + length <= MaxBufferSize) {
+		Memory::copy(buffer + bufferSize, data, length);
+		bufferSize += static_cast<unsigned int>(length);
+		return true;
+	}
+
+	// Fill and process the buffer
+	if (bufferSize > 0) {
+		const size_t fill = MaxBufferSize - bufferSize;
+		Memory::copy(buffer + bufferSize, data, fill);
+		data += fill;
+		length -= fill;
+		stripes = consume_kernel(acc, stripes, buffer, MaxBufferSize / StripeLen, secret);
+		bufferSize = 0;
+	}
+
+	// Process large input directly (but keep at least one byte and the previous stripe)
+	if (length > MaxBufferSize) {
+		const size_t n = (length - 1) / StripeLen;
+		stripes = consume_kernel(acc, stripes, data, n, secret);
+		data += n * StripeLen;
+		length -= n * StripeLen;
+		Memory::copy(buffer + MaxBufferSize - StripeLen, data - StripeLen, StripeLen);
+	}
+
+	// Store remaining bytes
+	Memory::copy(buffer, data, length);
+	bufferSize = static_cast<unsigned int>(length);
+	return true;
+}
+
+bool XXHash3::addZeros(uint64_t length) {
+	if (length == 0)
+		return false;
+
+	unsigned char zeros[MaxBufferSize] = {};
+	while (length > 0) {
+		const uint64_t n = length < sizeof(zeros) ? length : sizeof(zeros);
+		add(zeros, n);
+		length -= n;
+	}
+	return true;
+}
+
+void XXHash3::digestLong(uint64_t * result, const unsigned char * sec) const {
+	Memory::copy(result, acc, sizeof(acc));
+	const unsigned char * last;
+	unsigned char stripe[StripeLen];
+	if (bufferSize >= StripeLen) {
+		consume_kernel(result, stripes, buffer, (bufferSize - 1) / StripeLen, sec);
+		last = buffer + bufferSize - StripeLen;
+	} else {
+		// Last stripe overlaps the previously processed data
+		const size_t catchup = StripeLen - bufferSize;
+		Memory::copy(stripe, buffer + MaxBufferSize - catchup, catchup);
+		Memory::copy(stripe + catchup, buffer, bufferSize);
+		last = stripe;
+	}
+	accumulate_scalar(result, last, sec + SECRET_LIMIT - 7);
+}
+
+uint64_t XXHash3::hash() const {
+	if (totalLength > MidSizeMax) {
+		uint64_t result[8];
+		digestLong(result, secret);
+		return merge(result, secret + 11, totalLength * Prime64_1);
+	} else {
+		return hash(reinterpret_cast<const char *>(buffer), static_cast<size_t>(totalLength), seed);
+	}
+}
+
+XXHash3::Hash128 XXHash3::hash128() const {
+	if (totalLength > MidSizeMax) {
+		uint64_t result[8];
+		digestLong(result, secret);
+		return { merge(result, secret + 11, totalLength * Prime64_1), merge(result, secret + SecretSize - StripeLen - 11, ~(totalLength * Prime64_2)) };
+	} else {
+		return hash128(reinterpret_cast<const char *>(buffer), static_cast<size_t>(totalLength), seed);
+	}
+}
@@ -0,0 +1,93 @@
+// Dirty Little Helper (DLH) - system support library for C/C++
+// Copyright 2021-2023 by Bernhard Heinloth <heinloth@cs.fau.de>
+// SPDX-License-Identifier: AGPL-3.0-or-later
+
+/*! \file
+ *  \brief SIMD kernels for XXH3 (inputs with more than 240 bytes)
+ *
+ * This file is included once per instruction set (without include guard),
+ * the following macros have to be defined:
+ *  - `XXHASH_KERNEL_NAMESPACE` namespace for the kernels
+ *  - `XXHASH_KERNEL_TARGET` function attributes (e.g. target instruction set)
+ *  - `XXHASH_KERNEL_VECTOR` vector type of unsigned 64 bit integers
+ */
+
+#include <dlh/xxhash.hpp>
+#include <dlh/types.hpp>
+#include <dlh/mem.hpp>
+
+#include "simd.hpp"
+
+namespace XXHASH_KERNEL_NAMESPACE {
+
+using SIMD::loadu;
+using SIMD::multiply32;
+using SIMD::swap64;
+
+typedef XXHASH_KERNEL_VECTOR Vec;
+
+// Vectors per stripe
+static const size_t N = XXHash3::StripeLen / sizeof(Vec);
+
+// Number of stripes before scrambling the accumulators
+static const size_t STRIPES_PER_BLOCK = (XXHash3::SecretSize - XXHash3::StripeLen) / 8;
+
+/*! \brief Accumulate a single stripe (64 bytes)
+ * \param acc accumulators
+ * \param input stripe
+ * \param secret secret for this stripe
+ */
+static inline __attribute__((always_inline)) XXHASH_KERNEL_TARGET void accumulate(Vec * acc, uintptr_t input, uintptr_t secret) {
+	for (size_t i = 0; i < N; i++) {
+		const Vec data = loadu<Vec>(input + i * sizeof(Vec));
+		const Vec key = data ^ loadu<Vec>(secret + i * sizeof(Vec));
+		acc[i] += swap64(data) + multiply32(key, key >> 32);
+	}
+}
+
+/*! \brief Scramble accumulators (after each block)
+ * \param acc accumulators
+ * \param secret secret (last stripe)
+ */
+static inline __attribute__((always_inline)) XXHASH_KERNEL_TARGET void scramble(Vec * acc, uintptr_t secret) {
+	const Vec prime = Vec{} + 0x9E3779B1U;
+	for (size_t i = 0; i < N; i++) {
+		Vec a = acc[i];
+		a ^= a >> 47;
+		a ^= loadu<Vec>(secret + i * sizeof(Vec));
+		// 64 x 32 bit multiplication
+		acc[i] = multiply32(a, prime) + (multiply32(a >> 32, prime) << 32);
+	}
+}
+
+/*! \brief Process stripes, scramble the accumulators after each block
+ * \param accumulators accumulators
+ * \param done stripes already processed in the current block
+ * \param input first stripe
+ * \param stripes number of stripes to process
+ * \param secret secret
+ * \return stripes processed in the (new) current block
+ */
+static XXHASH_KERNEL_TARGET size_t consume(uint64_t * accumulators, size_t done, const unsigned char * input, size_t stripes, const unsigned char * secret) {
+	Vec acc[N];
+	Memory::copy(acc, accumulators, sizeof(acc));
+	uintptr_t in = reinterpret_cast<uintptr_t>(input);
+	const uintptr_t sec = reinterpret_cast<uintptr_t>(secret);
+	while (stripes > 0) {
+		size_t n = STRIPES_PER_BLOCK - done;
+		if (n > stripes)
+			n = stripes;
+		for (size_t s = 0; s < n; s++, in += XXHash3::StripeLen)
+			accumulate(acc, in, sec + 8 * (done + s));
+		stripes -= n;
+		done += n;
+		if (done == STRIPES_PER_BLOCK) {
+			scramble(acc, sec + XXHash3::SecretSize - XXHash3::StripeLen);
+			done = 0;
+		}
+	}
+	Memory::copy(accumulators, acc, sizeof(acc));
+	return done;
+}
+
+}  // namespace XXHASH_KERNEL_NAMESPACE
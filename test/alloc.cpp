@@ -0,0 +1,187 @@
+// Dirty Little Helper (DLH) - system support library for C/C++
+// Copyright 2021-2023 by Bernhard Heinloth <heinloth@cs.fau.de>
+// SPDX-License-Identifier: AGPL-3.0-or-later
+
+#include <dlh/stream/output.hpp>
+#include <dlh/syscall.hpp>
+#include <dlh/thread.hpp>
+#include <dlh/random.hpp>
+#include <dlh/mem.hpp>
+
+const size_t THREADS = 4;
+const size_t SLOTS = 64;
+const size_t ROUNDS = 20000;
+
+struct Slot {
+	unsigned char * ptr;
+	size_t size;
+	unsigned char pattern;
+};
+
+void* worker(void * arg) {
+	uintptr_t id = reinterpret_cast<uintptr_t>(arg);
+	Random random(static_cast<uint32_t>(id));
+	Slot slots[SLOTS] = {};
+	size_t errors = 0;
+
+	for (size_t r = 0; r < ROUNDS; r++) {
+		Slot & slot = slots[random.number() % SLOTS];
+		if (slot.ptr != nullptr) {
+			for (size_t i = 0; i < slot.size; i++)
+				if (slot.ptr[i] != slot.pattern)
+					errors++;
+			Memory::free(slot.ptr);
+			slot.ptr = nullptr;
+		} else {
+			slot.size = 1 + random.number() % (random.number() % 4 == 0 ? 40000 : 2000);
+			slot.pattern = static_cast<unsigned char>(id * 16 + r);
+			slot.ptr = Memory::alloc<unsigned char>(slot.size);
+			if (slot.ptr == nullptr || reinterpret_cast<uintptr_t>(slot.ptr) % 16 != 0)
+				errors++;
+			else
+				Memory::set(slot.ptr, slot.pattern, slot.size);
+		}
+	}
+
+	for (auto & slot : slots)
+		Memory::free(slot.ptr);
+
+	return reinterpret_cast<void*>(errors);
+}
+
+int main(int argc, const char *argv[]) {
+	(void) argc;
+	(void) argv;
+
+#ifndef DLH_LEGACY
+	// Thread control block for main thread
+	static Thread main_tcb;
+	Syscall::arch_prctl(ARCH_SET_FS, reinterpret_cast<uintptr_t>(&main_tcb));
+	Memory::thread_cache(true);
+#endif
+
+	// Small objects
+	const size_t small_num = 100;
+	char * small[small_num];
+	uintptr_t small_min = UINTPTR_MAX, small_max = 0;
+	for (size_t i = 0; i < small_num; i++) {
+		small[i] = Memory::alloc<char>(24);
+		Memory::set(small[i], 'a' + i % 26, 24);
+		small_min = Math::min(small_min, reinterpret_cast<uintptr_t>(small[i]));
+		small_max = Math::max(small_max, reinterpret_cast<uintptr_t>(small[i]));
+	}
+	cout << "small objects dense: " << (small_max - small_min < small_num * 64) << endl;
+	for (size_t i = 0; i < small_num; i++) {
+		small[i] = Memory::realloc(small[i], 24 + i * 16);
+		if (small[i][23] != 'a' + static_cast<char>(i % 26))
+			cout << "realloc " << i << " failed" << endl;
+		Memory::free(small[i]);
+	}
+
+	// Shrink a buddy allocation to slab size
+	char * shrunk = Memory::alloc<char>(600);
+	Memory::set(shrunk, 's', 600);
+	shrunk = Memory::realloc(shrunk, 510);
+	Memory::free(shrunk);
+	char * slab = Memory::alloc<char>(512);
+	Memory::set(slab, 'b', 512);
+	slab = Memory::realloc(slab, 100000);
+	size_t shrunk_errors = 0;
+	for (size_t i = 0; i < 512; i++)
+		if (slab[i] != 'b')
+			shrunk_errors++;
+	Memory::free(slab);
+	cout << "shrunk errors: " << shrunk_errors << endl;
+
+	// Aligned allocations
+	size_t aligned_errors = 0;
+	const size_t aligned_sizes[] = { 24, 100, 3000, 200000 };
+	for (size_t alignment = 32; alignment <= 16384; alignment *= 2)
+		for (auto size : aligned_sizes) {
+			char * ptr = Memory::alloc_aligned<char>(size, alignment);
+			if (ptr == nullptr || reinterpret_cast<uintptr_t>(ptr) % alignment != 0 || Memory::size(ptr) < size)
+				aligned_errors++;
+			else
+				Memory::set(ptr, 'x', size);
+			Memory::free(ptr);
+		}
+	cout << "aligned errors: " << aligned_errors << endl;
+
+	Thread * threads[THREADS];
+	for (size_t t = 0; t < THREADS; t++)
+		threads[t] = Thread::create(worker, reinterpret_cast<void*>(t + 1));
+
+	cout << "main errors: " << reinterpret_cast<uintptr_t>(worker(nullptr)) << endl;
+
+	for (size_t t = 0; t < THREADS; t++) {
+		void * errors = nullptr;
+		if (threads[t] == nullptr || !threads[t]->join(&errors))
+			cout << "thread " << (t + 1) << " failed" << endl;
+		else
+			cout << "thread " << (t + 1) << " errors: " << reinterpret_cast<uintptr_t>(errors) << endl;
+	}
+
+	Memory::thread_cache_release();
+
+	auto stats = Memory::stats();
+	size_t allocations = 0, frees = 0;
+	for (size_t i = 0; i < Memory::Statistics::CLASSES; i++) {
+		allocations += stats.allocations[i];
+		frees += stats.frees[i];
+	}
+	// Each worker allocates in about every second round
+	cout << "allocations counted: " << (allocations >= (THREADS + 1) * ROUNDS / 4) << endl;
+	cout << "balanced: " << (allocations == frees) << endl;
+	cout << "in use: " << stats.used << endl;
+
+	// Release free heap memory
+	Memory::trim_threshold(0);
+	const size_t blocks_num = 64;
+	void * blocks[blocks_num];
+	for (size_t i = 0; i < blocks_num; i++)
+		Memory::set(blocks[i] = Memory::alloc<void>(64 * 1024), 0xff, 64 * 1024);
+	for (size_t i = 0; i < blocks_num; i++)
+		Memory::free(blocks[i]);
+	cout << "trimmed: " << (Memory::trim() >= blocks_num * 64 * 1024 / 2) << endl;
+	cout << "trim counted: " << (Memory::stats().trimmed > stats.trimmed) << endl;
+
+	// Reuse mappings of freed large allocations
+	auto before = Memory::stats();
+	size_t map_errors = 0;
+	for (size_t i = 0; i < 100; i++) {
+		size_t size = 400 * 1024 - i * 512;
+		unsigned char * buffer = Memory::alloc<unsigned char>(size);
+		if (buffer == nullptr)
+			map_errors++;
+		else
+			Memory::set(buffer, 0x80 + i, size);
+		Memory::free(buffer);
+	}
+	cout << "map errors: " << map_errors << endl;
+	cout << "map reused: " << (Memory::stats().mmap - before.mmap <= 1) << endl;
+	const size_t zeroed_size = 300 * 1024;
+	unsigned char * zeroed = Memory::alloc_array<unsigned char>(zeroed_size);
+	size_t zeroed_errors = 0;
+	for (size_t i = 0; i < zeroed_size; i++)
+		if (zeroed[i] != 0)
+			zeroed_errors++;
+	Memory::free(zeroed);
+	cout << "map zeroed errors: " << zeroed_errors << endl;
+	Memory::trim();
+	cout << "map cache flushed: " << (Memory::stats().map_cached == 0) << endl;
+
+	// Huge pages (with fallback if not available)
+	Memory::huge_pages(Memory::HUGE_PAGES_EXPLICIT);
+	size_t huge_errors = 0;
+	const size_t huge_size = 3 * 1024 * 1024;
+	unsigned char * huge = Memory::alloc<unsigned char>(huge_size);
+	Memory::set(huge, 0x42, huge_size);
+	huge = Memory::realloc(huge, 2 * huge_size);
+	for (size_t i = 0; i < huge_size; i++)
+		if (huge[i] != 0x42)
+			huge_errors++;
+	Memory::free(huge);
+	Memory::huge_pages(Memory::HUGE_PAGES_DISABLED);
+	cout << "huge pages errors: " << huge_errors << endl;
+	return 0;
+}
@@ -0,0 +1,147 @@
+// Dirty Little Helper (DLH) - system support library for C/C++
+// Copyright 2021-2023 by Bernhard Heinloth <heinloth@cs.fau.de>
+// SPDX-License-Identifier: AGPL-3.0-or-later
+
+#include <dlh/stream/output.hpp>
+#include <dlh/container/vector.hpp>
+#include <dlh/container/hash.hpp>
+#include <dlh/container/tree.hpp>
+#include <dlh/string.hpp>
+#include <dlh/arena.hpp>
+#include <dlh/mem.hpp>
+
+/*! \brief Allocate with different alignments near the end of a chunk
+ * \param chunk_size size of the arena chunks
+ * \param used bytes already used in the first chunk
+ * \param alignment alignment of the allocations
+ * \return number of misaligned allocations or allocations exceeding the chunk
+ */
+static size_t near_end(size_t chunk_size, size_t used, size_t alignment) {
+	Memory::Arena arena(chunk_size);
+	uintptr_t first = arena.alloc(used, 1);
+	// End of the first chunk (behind the 16 byte chunk header)
+	uintptr_t end = first - 16 + chunk_size;
+	size_t errors = 0;
+	for (size_t a : { alignment, 1UL, alignment }) {
+		uintptr_t ptr = arena.alloc(32, a);
+		if (ptr == 0 || ptr % a != 0)
+			errors++;
+		else if (ptr < first || ptr + 32 > end)
+			// Not in the first chunk, hence a new chunk is required
+			return errors + (arena.reserved() == chunk_size ? 1 : 0);
+	}
+	return errors;
+}
+
+/*! \brief Reuse the next chunk (after reset) with a larger alignment
+ * \param chunk_size size of the arena chunks
+ * \param alignment alignment of the allocation in the reused chunk
+ * \return `1` if the allocation is misaligned or exceeds the chunk
+ */
+static size_t reuse(size_t chunk_size, size_t alignment) {
+	Memory::Arena arena(chunk_size);
+	// Fill two chunks completely
+	arena.alloc(chunk_size - 16, 1);
+	uintptr_t second = arena.alloc(chunk_size - 16, 1);
+	arena.reset();
+	arena.alloc(chunk_size - 16, 1);
+	uintptr_t ptr = arena.alloc(32, alignment);
+	if (ptr == 0 || ptr % alignment != 0)
+		return 1;
+	else if (ptr < second || ptr + 32 > second - 16 + chunk_size)
+		return arena.reserved() == 2 * chunk_size ? 1 : 0;
+	else
+		return 0;
+}
+
+int main(int argc, const char *argv[]) {
+	(void) argc;
+	(void) argv;
+
+	Memory::Arena arena(4096);
+
+	// Plain allocations
+	auto a = arena.alloc(10);
+	auto b = arena.alloc(100, 64);
+	cout << "aligned: " << (a % 16 == 0 && b % 64 == 0 && b > a) << endl;
+	cout << "resize last in place: " << (arena.realloc(b, 100, 200) == b) << endl;
+	auto c = arena.realloc(a, 10, 20);
+	cout << "resize other moves: " << (c != a && c > b) << endl;
+	arena.free(c);
+	cout << "free last: " << (arena.alloc(20) == c) << endl;
+	auto large = arena.alloc(10000);
+	cout << "large: " << (large != 0) << endl;
+
+	// Mixed alignments at the end of chunks
+	size_t near_end_errors = 0;
+	for (size_t chunk_size : { 1000UL, Memory::Arena::CHUNK_SIZE })
+		for (size_t used = chunk_size - 200; used <= chunk_size - 16; used += 4)
+			for (size_t alignment : { 1UL, 16UL, 64UL, 128UL, 4096UL })
+				near_end_errors += near_end(chunk_size, used, alignment);
+	for (size_t alignment = 16; alignment <= 4096; alignment *= 2)
+		near_end_errors += reuse(1000, alignment);
+	cout << "near chunk end errors: " << near_end_errors << endl;
+
+	// Marker
+	auto marker = arena.mark();
+	auto d = arena.alloc(3000);
+	arena.alloc(3000);
+	arena.rollback(marker);
+	cout << "rollback: " << (arena.alloc(3000) == d) << endl;
+
+	// Scope with containers and strings
+	size_t reserved;
+	 {
+		Memory::Arena::Scope scope(arena);
+
+		Vector<int> vector(arena);
+		for (int i = 0; i < 1000; i++)
+			vector.push_back(i);
+		int sum = 0;
+		for (auto i : vector)
+			sum += i;
+		cout << "vector sum: " << sum << endl;
+
+		HashMap<int, const char *> map(arena);
+		map.insert(1, String::duplicate(arena, "one"));
+		map.insert(2, String::replace(arena, "tvo", 'v', 'w'));
+		map.insert(3, String::replace(arena, "three", "ee", "ie"));
+		for (const auto & i : map)
+			cout << "map " << i.key << ": " << i.value << endl;
+
+		TreeSet<const char *> tree(arena);
+		for (auto s : String::split(arena, "pear,apple,,plum,fig", ','))
+			tree.insert(s);
+		for (auto s : String::split_any(arena, "kiwi lime;date", " ;"))
+			tree.insert(s);
+		for (auto s : String::split(arena, "cherry::grape", "::"))
+			tree.insert(s);
+		for (const auto & i : tree)
+			cout << "tree: " << i << endl;
+
+		reserved = arena.reserved();
+	 }
+
+	// Reuse chunks after scope / reset
+	 {
+		Memory::Arena::Scope scope(arena);
+		Vector<int> vector(arena, 1000);
+		for (int i = 0; i < 1000; i++)
+			vector.push_back(i);
+		auto words = String::split(arena, "a b c", ' ');
+		cout << "words: " << words.size() << endl;
+	 }
+	cout << "chunks reused: " << (arena.reserved() == reserved) << endl;
+
+	arena.reset();
+	cout << "reset: " << (arena.alloc(10) == a) << endl;
+
+	// Arena vector moved to heap vector variable
+	Vector<int> heap;
+	heap.push_back(1);
+	heap = Vector<int>(arena, 10);
+	heap.push_back(2);
+	cout << "moved: " << heap.size() << " " << heap[0] << endl;
+
+	return 0;
+}
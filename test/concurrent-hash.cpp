@@ -0,0 +1,94 @@
+// Dirty Little Helper (DLH) - system support library for C/C++
+// Copyright 2021-2023 by Bernhard Heinloth <heinloth@cs.fau.de>
+// SPDX-License-Identifier: AGPL-3.0-or-later
+
+#include <dlh/stream/output.hpp>
+#include <dlh/container/concurrent_hash.hpp>
+#include <dlh/thread.hpp>
+#include <dlh/string.hpp>
+
+const size_t THREADS = 4;
+const size_t KEYS = 20000;
+const size_t SHARED = 1000;
+
+static ConcurrentHashMap<uint64_t, uint64_t> map;
+static size_t computed = 0;
+static size_t errors[THREADS] = {};
+
+static void * worker(void * arg) {
+	size_t t = reinterpret_cast<size_t>(arg);
+	// Own keys (inserted, assigned and half of them erased again)
+	for (uint64_t i = 0; i < KEYS; i++) {
+		uint64_t key = (i << 8) | t;
+		if (!map.insert_or_assign(key, i) || map.insert_or_assign(key, i + 1) || map.insert(key, 0))
+			errors[t]++;
+		// Shared keys (each computed only once)
+		uint64_t shared = (1UL << 32) + (i * 7 + t * 13) % SHARED;
+		uint64_t value = map.compute_if_absent(shared, [](const uint64_t & key) {
+			__atomic_fetch_add(&computed, 1, __ATOMIC_RELAXED);
+			return key * 3;
+		});
+		if (value != shared * 3)
+			errors[t]++;
+	}
+	for (uint64_t i = 0; i < KEYS; i += 2) {
+		uint64_t key = (i << 8) | t;
+		auto v = map.erase(key);
+		if (!v || v.value() != i + 1 || map.contains(key))
+			errors[t]++;
+	}
+	for (uint64_t i = 1; i < KEYS; i += 2) {
+		auto v = map.at((i << 8) | t);
+		if (!v || v.value() != i + 1)
+			errors[t]++;
+	}
+	return nullptr;
+}
+
+int main(int argc, const char *argv[]) {
+	(void) argc;
+	(void) argv;
+
+	cout << "shards: " << map.shards() << ", empty: " << map.empty() << endl;
+
+	Thread * threads[THREADS];
+	for (size_t t = 1; t < THREADS; t++)
+		threads[t] = Thread::create(worker, reinterpret_cast<void*>(t));
+	worker(reinterpret_cast<void*>(0));
+	for (size_t t = 1; t < THREADS; t++)
+		if (threads[t] == nullptr || !threads[t]->join())
+			cout << "thread " << t << " failed" << endl;
+
+	size_t e = 0;
+	for (auto x : errors)
+		e += x;
+	cout << "errors: " << e << endl;
+	cout << "computed: " << computed << endl;
+	cout << "size: " << map.size() << endl;
+
+	// Visit shards one at a time
+	size_t shared = 0;
+	uint64_t sum = 0;
+	map.for_each([&](const uint64_t & key, const uint64_t & value) {
+		if (key >= (1UL << 32))
+			shared++;
+		else
+			sum += value;
+	});
+	cout << "shared: " << shared << ", sum: " << sum << endl;
+
+	map.for_each_mutable([](const uint64_t & key, uint64_t & value) {
+		(void) key;
+		value = 0;
+	});
+	sum = 0;
+	map.for_each([&](const uint64_t & key, const uint64_t & value) {
+		(void) key;
+		sum += value;
+	});
+	cout << "reset sum: " << sum << endl;
+
+	map.clear();
+	cout << "cleared: " << map.size() << ", empty: " << map.empty() << endl;
+	return 0;
+}
@@ -0,0 +1,88 @@
+// Dirty Little Helper (DLH) - system support library for C/C++
+// Copyright 2021-2023 by Bernhard Heinloth <heinloth@cs.fau.de>
+// SPDX-License-Identifier: AGPL-3.0-or-later
+
+#include <dlh/stream/output.hpp>
+#include <dlh/auxiliary.hpp>
+#include <dlh/syscall.hpp>
+#include <dlh/string.hpp>
+#include <dlh/cpu.hpp>
+
+extern char **environ;
+
+static int resolved = 0;
+
+static int generic(int value) {
+	return value;
+}
+
+static int fast(int value) {
+	return value * 2;
+}
+
+static Cpu::Dispatch<int(int)>::Function resolve() {
+	resolved++;
+	return Cpu::has(Cpu::AVX2) ? fast : generic;
+}
+
+static Cpu::Dispatch<int(int)> kernel(resolve);
+
+int main(int argc, const char *argv[]) {
+	if (argc > 1) {
+		// Started with features disabled via environment
+		cout << "disabled avx2: " << !Cpu::has(Cpu::AVX2) << endl;
+		cout << "disabled erms: " << !Cpu::has(Cpu::ERMS) << endl;
+		cout << "kept sse2: " << Cpu::has(Cpu::SSE2) << endl;
+		return 0;
+	}
+
+	// Features
+	cout << "sse2: " << Cpu::has(Cpu::SSE2) << endl;
+	cout << "hwcap sse2: " << ((Cpu::hwcap() & (1UL << 26)) != 0) << endl;
+	cout << "avx2 requires avx: " << (!Cpu::has(Cpu::AVX2) || Cpu::has(Cpu::AVX)) << endl;
+	cout << "avx512bw requires avx512f: " << (!Cpu::has(Cpu::AVX512BW) || Cpu::has(Cpu::AVX512F)) << endl;
+	cout << "combined mask: " << (Cpu::has(Cpu::SSE2 | Cpu::AVX2) == Cpu::has(Cpu::AVX2)) << endl;
+	cout << "name: " << Cpu::name(Cpu::SSE4_2) << endl;
+	cout << "vendor length: " << String::len(Cpu::vendor()) << endl;
+
+	// Caches
+	size_t line = Cpu::cache_line();
+	cout << "cache line: " << (line >= 16 && (line & (line - 1)) == 0) << endl;
+	size_t l1 = Cpu::cache_size(1);
+	size_t l2 = Cpu::cache_size(2);
+	cout << "cache sizes: " << (l1 == 0 || l2 == 0 || l1 <= l2) << endl;
+	cout << "invalid cache level: " << Cpu::cache_size(4) << endl;
+
+	// Dispatch
+	int sum = 0;
+	for (int i = 0; i < 10; i++)
+		sum += kernel(i) - (Cpu::has(Cpu::AVX2) ? 2 * i : i);
+	cout << "dispatch: " << sum << ", resolved " << resolved << "x" << endl;
+	Cpu::disable(Cpu::AVX2 | Cpu::SSE2);
+	cout << "avx2 after disable: " << Cpu::has(Cpu::AVX2) << endl;
+	cout << "sse2 after disable: " << Cpu::has(Cpu::SSE2) << endl;
+	kernel.reset();
+	cout << "fallback: " << kernel(21) << ", resolved " << resolved << "x" << endl;
+
+	// Auxiliary vector is not available before startup (without environment)
+	char ** env = environ;
+	environ = nullptr;
+	bool aux_valid = Auxiliary::vector(Auxiliary::AT_HWCAP).valid();
+	environ = env;
+	cout << "auxiliary vector before startup: " << aux_valid << ", after: " << Auxiliary::vector(Auxiliary::AT_HWCAP).valid() << endl;
+
+	// Disable features using the environment
+	if (auto fork = Syscall::fork()) {
+		if (fork.value() == 0) {
+			const char * args[3] = { argv[0], "child", nullptr };
+			const char * env[2] = { "DLH_CPU_DISABLE=avx2,sse2,erms", nullptr };
+			Syscall::execve(argv[0], args, env);
+			Syscall::exit(1);
+		}
+		int status = 0;
+		Syscall::waitpid(fork.value(), &status);
+		cout << "child status: " << status << endl;
+	}
+
+	return 0;
+}
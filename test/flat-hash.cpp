@@ -0,0 +1,155 @@
+// Dirty Little Helper (DLH) - system support library for C/C++
+// Copyright 2021-2023 by Bernhard Heinloth <heinloth@cs.fau.de>
+// SPDX-License-Identifier: AGPL-3.0-or-later
+
+#include <dlh/stream/output.hpp>
+#include <dlh/container/flat_hash.hpp>
+#include <dlh/container/hash.hpp>
+#include <dlh/assert.hpp>
+#include <dlh/string.hpp>
+#include <dlh/strptr.hpp>
+#include <dlh/random.hpp>
+
+// Count living objects
+static long alive = 0;
+struct Counted {
+	uint64_t id;
+
+	explicit Counted(uint64_t id) : id(id) { alive++; }
+	Counted(const Counted & o) : id(o.id) { alive++; }
+	Counted(Counted && o) : id(o.id) { alive++; }
+	~Counted() { alive--; }
+};
+
+struct CountedComp: public Comparison {
+	static inline uint32_t hash(const Counted & c) { return Comparison::hash(c.id); }
+	static inline uint32_t hash(uint64_t id) { return Comparison::hash(id); }
+	static inline bool equal(const Counted & a, const Counted & b) { return a.id == b.id; }
+	static inline bool equal(const Counted & a, uint64_t b) { return a.id == b; }
+};
+
+int main(int argc, const char *argv[]) {
+	(void) argc;
+	(void) argv;
+
+	// Same operations as for HashSet
+	FlatHashSet<int> s = { 888, 999 };
+	s.insert(13);
+	s.insert(3);
+	s.insert(42);
+	s.insert(23);
+	s.insert(7);
+	s.insert(13);
+	s.insert(1549);
+	s.emplace(666);
+	s.insert(3085);
+	s.insert(204);
+	s.erase(666);
+	s.erase(3085);
+	s.insert(1572877);
+	auto it1 = s.find(204);
+	if (it1) {
+		s.erase(it1);
+		s.insert(205);
+	}
+	s.resize(128);
+	s.insert(32);
+	s.erase(s.find(7));
+	s.insert(52);
+	FlatHashSet<int> t(s);
+	int sum = 0;
+	for (auto v : t)
+		sum += v;
+	cout << "FlatHashSet: " << s.size() << " elements (sum " << sum << "), copy: " << t.size() << " elements, capacity " << s.capacity() << endl;
+	cout << "contains 205: " << s.contains(205) << ", 204: " << s.contains(204) << ", 7: " << s.contains(7) << endl;
+
+	// Compare with HashMap using random operations on a small key space (many erased slots)
+	Random random(42);
+	FlatHashMap<uint64_t, uint64_t> flat;
+	HashMap<uint64_t, uint64_t> chained;
+	size_t errors = 0;
+	for (size_t i = 0; i < 300000; i++) {
+		uint64_t key = random.number() % (i < 150000 ? 50000 : 2000);
+		switch (random.number() % 4) {
+			case 0:
+			case 1:
+				if (flat.insert(key, i).second != chained.insert(key, i).second)
+					errors++;
+				break;
+			case 2:
+			{
+				auto f = flat.erase(key);
+				auto c = chained.erase(key);
+				if (f.has_value() != c.has_value() || (f && f.value() != c.value()))
+					errors++;
+				break;
+			}
+			default:
+			{
+				auto f = flat.find(key);
+				auto c = chained.find(key);
+				if (static_cast<bool>(f) != static_cast<bool>(c) || (f && f->value != c->value))
+					errors++;
+			}
+		}
+		if (flat.size() != chained.size())
+			errors++;
+	}
+	for (const auto & e : chained)
+		if (!flat.contains(e.key))
+			errors++;
+	size_t count = 0;
+	for (const auto & e : flat) {
+		auto c = chained.find(e.key);
+		if (!c || c->value != e.value)
+			errors++;
+		count++;
+	}
+	cout << "random operations: " << errors << " errors, " << count << " elements" << endl;
+
+	// Rehash (without tombstones) keeps contents
+	flat.rehash();
+	errors = 0;
+	for (const auto & e : chained)
+		if (!flat.contains(e.key))
+			errors++;
+	cout << "rehash: " << errors << " errors" << endl;
+
+	// Sequential keys (identity hash)
+	FlatHashMap<uint32_t, uint32_t> seq;
+	for (uint32_t i = 0; i < 100000; i++)
+		seq[i] = i * 2;
+	errors = 0;
+	for (uint32_t i = 0; i < 200000; i++)
+		if (seq.contains(i) != (i < 100000) || (i < 100000 && seq.at(i).value() != i * 2))
+			errors++;
+	cout << "sequential: " << errors << " errors, capacity " << seq.capacity() << endl;
+
+	// Object lifetime
+	{
+		FlatHashSet<Counted, CountedComp> objects;
+		for (uint64_t i = 0; i < 1000; i++)
+			objects.emplace(i);
+		for (uint64_t i = 0; i < 1000; i += 3)
+			objects.erase(i);
+		objects.emplace(1);
+		FlatHashSet<Counted, CountedComp> copy(objects);
+		cout << "objects: " << objects.size() << " in set, " << alive << " alive" << endl;
+		copy.clear();
+		cout << "cleared copy: " << alive << " alive" << endl;
+	}
+	cout << "destroyed: " << alive << " alive" << endl;
+
+	// String keys in an arena with heterogeneous lookup
+	Memory::Arena arena;
+	FlatHashMap<const char *, int> m(arena);
+	m.insert("foo", 1);
+	m.insert("bar", 2);
+	m["baz"] = 3;
+	m["bar"] *= -1;
+	char key[] = "baz";
+	cout << "foo: " << m.at(StrPtr("foo")).value() << ", bar: " << m.at("bar").value() << ", baz: " << m.at(key).value() << endl;
+	cout << "erase foo: " << m.erase("foo").value() << ", contains foo: " << m.contains("foo") << ", size: " << m.size() << endl;
+
+	return 0;
+}
@@ -0,0 +1,79 @@
+// Dirty Little Helper (DLH) - system support library for C/C++
+// Copyright 2021-2023 by Bernhard Heinloth <heinloth@cs.fau.de>
+// SPDX-License-Identifier: AGPL-3.0-or-later
+
+#include <dlh/stream/output.hpp>
+#include <dlh/container/hash.hpp>
+#include <dlh/random.hpp>
+
+/*! \brief Check index range of a reduction policy
+ * \param random random generator for hash values
+ * \return number of indices out of range
+ */
+template<typename R>
+static size_t range(Random & random) {
+	size_t errors = 0;
+	for (uint32_t buckets : { 1U, 2U, 3U, 24U, 1000U, 1536U, 65536U, 100000000U, UINT32_MAX - 1 }) {
+		uint32_t size = R::size(buckets);
+		if (size < 2 && buckets >= 2)
+			errors++;
+		for (size_t i = 0; i < 10000; i++)
+			if (R::index(static_cast<uint32_t>(random.number()), size) >= size)
+				errors++;
+		if (R::index(0, size) >= size || R::index(UINT32_MAX, size) >= size)
+			errors++;
+	}
+	return errors;
+}
+
+/*! \brief Insert keys with a given stride
+ * \param name name of the policy
+ * \param stride distance between keys
+ */
+template<typename R>
+static void keys(const char * name, uint64_t stride) {
+	const uint64_t n = 10000;
+	HashMap<uint64_t, uint64_t, Comparison, 150, R> map;
+	for (uint64_t i = 0; i < n; i++)
+		map.insert(i * stride, i);
+
+	size_t found = 0;
+	for (uint64_t i = 0; i < n; i++) {
+		auto v = map.find(i * stride);
+		if (v && v->value == i)
+			found++;
+	}
+	for (uint64_t i = 0; i < n; i += 2)
+		map.erase(i * stride);
+	for (uint64_t i = 0; i < n; i++)
+		if (map.contains(i * stride) != (i % 2 == 1))
+			found--;
+
+	cout << name << " stride " << stride << ": " << found << " found, " << map.bucket_count() << " of " << map.bucket_size() << " buckets used" << endl;
+}
+
+template<typename R>
+static void test(const char * name, Random & random) {
+	cout << name << " range errors: " << range<R>(random) << endl;
+	keys<R>(name, 1);
+	keys<R>(name, 4096);
+}
+
+int main(int argc, const char *argv[]) {
+	(void) argc;
+	(void) argv;
+
+	Random random(42);
+	test<HashBucket::Modulo>("Modulo   ", random);
+	test<HashBucket::Mask>("Mask     ", random);
+	test<HashBucket::Fibonacci>("Fibonacci", random);
+	test<HashBucket::FastRange>("FastRange", random);
+
+	// Strings with incremental mode
+	HashSet<const char *, Comparison, 150, HashBucket::FastRange> set;
+	set.incremental(true);
+	for (auto s : { "foo", "bar", "baz", "qux", "quux", "corge", "grault", "garply", "waldo", "fred", "plugh", "xyzzy", "thud" })
+		set.insert(s);
+	cout << "strings: " << set.size() << ", contains waldo: " << set.contains("waldo") << ", contains bob: " << set.contains("bob") << endl;
+	return 0;
+}
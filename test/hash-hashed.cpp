@@ -0,0 +1,75 @@
+// Dirty Little Helper (DLH) - system support library for C/C++
+// Copyright 2021-2023 by Bernhard Heinloth <heinloth@cs.fau.de>
+// SPDX-License-Identifier: AGPL-3.0-or-later
+
+#include <dlh/stream/output.hpp>
+#include <dlh/container/hash.hpp>
+#include <dlh/string.hpp>
+#include <dlh/strptr.hpp>
+
+const char * words[] = { "foo", "bar", "baz", "qux", "quux", "corge", "grault", "garply", "waldo", "fred", "plugh", "xyzzy", "thud" };
+const size_t WORDS = sizeof(words) / sizeof(words[0]);
+
+int main(int argc, const char *argv[]) {
+	(void) argc;
+	(void) argv;
+
+	// Same key in several maps (hashed only once)
+	HashMap<const char *, size_t> index;
+	HashMap<const char *, size_t> length;
+	HashSet<StrPtr> set;
+	for (size_t i = 0; i < WORDS; i++) {
+		uint32_t h = Comparison::hash(words[i]);
+		index.insert_hashed(words[i], i, h);
+		length.insert_hashed(words[i], String::len(words[i]), h);
+		set.emplace_hashed(h, words[i]);
+	}
+	cout << "duplicate: " << index.insert_hashed(words[0], 42, Comparison::hash(words[0])).second
+	     << ", " << set.emplace_hashed(Comparison::hash(words[1]), words[1]).second
+	     << ", " << set.insert_hashed(StrPtr(words[2]), Comparison::hash(words[2])).second << endl;
+
+	const char * lookup[] = { "waldo", "bob", "thud", "foo", "alice" };
+	for (auto word : lookup) {
+		// StrPtr provides the hash value of the string
+		StrPtr p(word);
+		auto i = index.find_hashed(word, p.hash);
+		auto l = length.find_hashed(word, p.hash);
+		cout << word << ": ";
+		if (i && l)
+			cout << "index " << i->value << ", length " << l->value;
+		else
+			cout << "not found";
+		cout << ", in set: " << set.contains_hashed(p, p.hash) << endl;
+	}
+
+	// Batch lookup with prefetching
+	HashMap<uint64_t, uint64_t> numbers;
+	for (uint64_t i = 0; i < 100000; i++)
+		numbers.insert(i * 3, i);
+	const size_t AHEAD = 8;
+	uint32_t hash[1000];
+	for (uint64_t i = 0; i < 1000; i++)
+		hash[i] = Comparison::hash(i * 7);
+	uint64_t sum = 0;
+	size_t found = 0;
+	for (uint64_t i = 0; i < 1000; i++) {
+		if (i + AHEAD < 1000)
+			numbers.prefetch(hash[i + AHEAD]);
+		auto v = numbers.find_hashed(i * 7, hash[i]);
+		if (v) {
+			sum += v->value;
+			found++;
+		}
+	}
+	uint64_t expected = 0;
+	for (uint64_t i = 0; i < 1000; i++)
+		if (numbers.contains(i * 7))
+			expected += numbers.find(i * 7)->value;
+	cout << "batch: " << found << " found, sum " << sum << " (expected " << expected << ")" << endl;
+
+	// Prefetching an empty map is allowed
+	HashMap<uint64_t, uint64_t> empty;
+	empty.prefetch(23);
+	cout << "empty: " << empty.contains_hashed(23UL, Comparison::hash(23UL)) << endl;
+	return 0;
+}
@@ -0,0 +1,140 @@
+// Dirty Little Helper (DLH) - system support library for C/C++
+// Copyright 2021-2023 by Bernhard Heinloth <heinloth@cs.fau.de>
+// SPDX-License-Identifier: AGPL-3.0-or-later
+
+#include <dlh/stream/output.hpp>
+#include <dlh/container/hash.hpp>
+#include <dlh/assert.hpp>
+#include <dlh/string.hpp>
+#include <dlh/random.hpp>
+#include <dlh/arena.hpp>
+
+// Count living objects
+static long alive = 0;
+struct Counted {
+	uint64_t id;
+
+	explicit Counted(uint64_t id) : id(id) { alive++; }
+	Counted(const Counted & o) : id(o.id) { alive++; }
+	Counted(Counted && o) : id(o.id) { alive++; }
+	~Counted() { alive--; }
+};
+
+struct CountedComp: public Comparison {
+	static inline uint32_t hash(const Counted & c) { return Comparison::hash(c.id); }
+	static inline uint32_t hash(uint64_t id) { return Comparison::hash(id); }
+	static inline bool equal(const Counted & a, const Counted & b) { return a.id == b.id; }
+	static inline bool equal(const Counted & a, uint64_t b) { return a.id == b; }
+};
+
+/*! \brief Compare map with reference
+ * \param map map to check (using constant lookups only)
+ * \param reference map with expected contents
+ * \return number of differences
+ */
+template<typename M>
+static size_t compare(const M & map, const HashMap<uint64_t, uint64_t> & reference) {
+	size_t errors = map.size() == reference.size() ? 0 : 1;
+	for (const auto & e : reference) {
+		auto i = map.find(e.key);
+		if (!i || i->value != e.value)
+			errors++;
+	}
+	size_t n = 0;
+	for (const auto & e : map) {
+		if (!reference.contains(e.key))
+			errors++;
+		n++;
+	}
+	return errors + (n == map.size() ? 0 : 1);
+}
+
+int main(int argc, const char *argv[]) {
+	(void) argc;
+	(void) argv;
+
+	// Random operations compared with default mode
+	Random random(42);
+	HashMap<uint64_t, uint64_t> map;
+	HashMap<uint64_t, uint64_t> reference;
+	map.incremental(true);
+	size_t errors = 0;
+	size_t migrations = 0;
+	bool migrating = false;
+	for (size_t i = 0; i < 300000; i++) {
+		uint64_t key = random.number() % (i < 200000 ? 100000 : 5000);
+		switch (random.number() % 4) {
+			case 0:
+			case 1:
+				if (map.insert(key, i).second != reference.insert(key, i).second)
+					errors++;
+				break;
+			case 2:
+			{
+				auto a = map.erase(key);
+				auto b = reference.erase(key);
+				if (a.has_value() != b.has_value() || (a && a.value() != b.value()))
+					errors++;
+				break;
+			}
+			default:
+				if (map.find(key) != reference.find(key))
+					errors++;
+		}
+		if (map.migrating() && !migrating) {
+			migrations++;
+			// Check while both bucket arrays are in use
+			errors += compare(map, reference);
+		}
+		migrating = map.migrating();
+	}
+	errors += compare(map, reference);
+	cout << "random: " << errors << " errors, " << migrations << " migrations, " << map.size() << " elements" << endl;
+
+	// Erased slots are reused (no growth with a constant number of elements)
+	size_t buckets = map.bucket_size();
+	for (uint64_t i = 0; i < 1000000; i++) {
+		map.erase(i % 5000);
+		map.insert(i % 5000, i);
+	}
+	cout << "reuse: " << (map.bucket_size() == buckets ? "same capacity" : "grown") << endl;
+
+	// Copy, move and disable during migration
+	HashSet<uint64_t> set;
+	set.incremental(true);
+	uint64_t n = 0;
+	while (!set.migrating() || set.size() < 10000)
+		set.insert(n++);
+	HashSet<uint64_t> copy(set);
+	HashSet<uint64_t> moved(move(set));
+	size_t found = 0;
+	for (uint64_t i = 0; i < n; i++)
+		if (copy.contains(i) && moved.contains(i))
+			found++;
+	cout << "copy: " << copy.incremental() << " " << copy.migrating() << ", moved: " << moved.incremental() << " " << moved.migrating() << ", found " << found << " of " << n << endl;
+	moved.incremental(false);
+	found = 0;
+	for (uint64_t i = 0; i < n; i++)
+		if (moved.contains(i))
+			found++;
+	cout << "disabled: " << moved.incremental() << " " << moved.migrating() << ", found " << found << ", buckets used " << moved.bucket_count() << endl;
+	moved.clear();
+	set.insert(1);
+	cout << "cleared: " << moved.size() << ", source: " << set.size() << endl;
+
+	// Object lifetime in an arena
+	{
+		Memory::Arena arena;
+		HashSet<Counted, CountedComp> objects(arena);
+		objects.incremental(true);
+		for (uint64_t i = 0; i < 50000; i++)
+			objects.emplace(i);
+		for (uint64_t i = 0; i < 50000; i += 3)
+			objects.erase(i);
+		for (uint64_t i = 0; i < 20000; i++)
+			objects.emplace(i);
+		cout << "objects: " << objects.size() << " (" << alive << " alive), contains 3: " << objects.contains(3) << ", 20001: " << objects.contains(20001) << endl;
+	}
+	cout << "alive: " << alive << endl;
+	return 0;
+}
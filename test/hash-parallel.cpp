@@ -0,0 +1,71 @@
+// Dirty Little Helper (DLH) - system support library for C/C++
+// Copyright 2021-2023 by Bernhard Heinloth <heinloth@cs.fau.de>
+// SPDX-License-Identifier: AGPL-3.0-or-later
+
+#include <dlh/stream/output.hpp>
+#include <dlh/syscall.hpp>
+#include <dlh/random.hpp>
+#include <dlh/hash.hpp>
+#include <dlh/file.hpp>
+#include <dlh/mem.hpp>
+
+/*! \brief Tree hash according to the documented format (single threaded)
+ * \param buffer input data
+ * \param length number of bytes
+ * \return 128 bit tree hash
+ */
+static XXHash3::Hash128 reference(const char * buffer, size_t length) {
+	XXHash3 tree(length);
+	for (size_t i = 0, offset = 0; offset < length; i++, offset += Hash::ChunkSize) {
+		const size_t size = length - offset < Hash::ChunkSize ? length - offset : Hash::ChunkSize;
+		XXHash3::Hash128 digest = XXHash3::hash128(buffer + offset, size, i);
+		tree.add(digest.low);
+		tree.add(digest.high);
+	}
+	return tree.hash128();
+}
+
+const size_t SIZE = 5 * Hash::ChunkSize + 123;
+
+int main(int argc, const char *argv[]) {
+	(void) argc;
+	(void) argv;
+
+	char * data = Memory::alloc<char>(SIZE);
+	Random random(42);
+	for (size_t i = 0; i < SIZE; i++)
+		data[i] = static_cast<char>(random.number());
+
+	cout << "processors: " << (Hash::processors() > 0) << endl;
+
+	for (size_t length : { 0UL, 1UL, 240UL, 241UL, Hash::ChunkSize - 1, Hash::ChunkSize, Hash::ChunkSize + 1, SIZE }) {
+		XXHash3::Hash128 expected = reference(data, length);
+		bool equal = true;
+		for (unsigned threads : { 0U, 1U, 2U, 3U, 8U })
+			if (Hash::parallel(data, length, threads) != expected)
+				equal = false;
+		cout << "buffer " << length << ": " << equal << endl;
+	}
+
+	// Different chunk order results in a different hash
+	Memory::copy(data + Hash::ChunkSize, data, Hash::ChunkSize);
+	XXHash3::Hash128 a = Hash::parallel(data, 2 * Hash::ChunkSize);
+	data[0]++;
+	XXHash3::Hash128 b = Hash::parallel(data, 2 * Hash::ChunkSize);
+	data[Hash::ChunkSize]++;
+	XXHash3::Hash128 c = Hash::parallel(data, 2 * Hash::ChunkSize);
+	cout << "modified: " << (a != b && b != c && a != c) << endl;
+
+	// Files
+	const char * path = "/tmp/dlh-test-hash-parallel";
+	for (size_t length : { 0UL, 1000UL, SIZE }) {
+		File::contents::set(path, data, length);
+		auto h = File::hash(path);
+		cout << "file " << length << ": " << (h && h.value() == reference(data, length)) << endl;
+	}
+	Syscall::unlink(path);
+	cout << "missing file: " << File::hash(path).has_value() << endl;
+
+	Memory::free(data);
+	return 0;
+}
@@ -0,0 +1,169 @@
+// Dirty Little Helper (DLH) - system support library for C/C++
+// Copyright 2021-2023 by Bernhard Heinloth <heinloth@cs.fau.de>
+// SPDX-License-Identifier: AGPL-3.0-or-later
+
+#include <dlh/stream/output.hpp>
+#include <dlh/container/initializer_list.hpp>
+#include <dlh/syscall.hpp>
+#include <dlh/random.hpp>
+#include <dlh/mem.hpp>
+
+const size_t BUFFER = 65536 + 512;
+
+static unsigned char source[BUFFER];
+static unsigned char buffer[BUFFER];
+static unsigned char expected[BUFFER];
+
+static void reference_move(unsigned char * dest, const unsigned char * src, size_t size) {
+	if (src > dest) {
+		for (size_t i = 0; i != size; ++i)
+			dest[i] = src[i];
+	} else {
+		for (size_t i = size; i != 0; --i)
+			dest[i - 1] = src[i - 1];
+	}
+}
+
+static int reference_compare(const unsigned char * s1, const unsigned char * s2, size_t size) {
+	for (size_t i = 0; i != size; ++i)
+		if (s1[i] != s2[i])
+			return static_cast<int>(s1[i]) - static_cast<int>(s2[i]);
+	return 0;
+}
+
+static int sign(int value) {
+	return value < 0 ? -1 : (value > 0 ? 1 : 0);
+}
+
+static void reset(size_t size) {
+	reference_move(buffer, source, size + 256);
+	reference_move(expected, source, size + 256);
+}
+
+static bool check(const char * name, size_t size, size_t offset) {
+	for (size_t i = 0; i < size + 256; i++)
+		if (buffer[i] != expected[i]) {
+			cout << name << " of " << size << " bytes (offset " << offset << ") differs at " << i << endl;
+			return false;
+		}
+	return true;
+}
+
+int main(int argc, const char *argv[]) {
+	if (argc > 1)
+		cout << "kernels: " << argv[1] << endl;
+
+	Random random(42);
+	for (auto & c : source)
+		c = static_cast<unsigned char>(random.number());
+
+	// Sizes around vector widths and thresholds
+	size_t sizes[300];
+	size_t num = 0;
+	for (size_t s = 0; s <= 260; s++)
+		sizes[num++] = s;
+	for (size_t s : { 511UL, 512UL, 513UL, 2047UL, 2048UL, 2049UL, 4095UL, 10000UL, 65535UL, 65536UL, 65537UL })
+		sizes[num++] = s;
+
+	size_t errors[5] = { 0, 0, 0, 0, 0 };
+	for (size_t n = 0; n < num; n++) {
+		size_t size = sizes[n];
+		for (size_t offset = 0; offset < 40; offset += (size > 1000 ? 13 : 1)) {
+			size_t dest_offset = offset * 7 % 64;
+			size_t src_offset = 64 + offset;
+
+			// copy
+			reset(size);
+			reference_move(expected + dest_offset, source + src_offset, size);
+			if (Memory::copy(buffer + dest_offset, source + src_offset, size) != buffer + dest_offset || !check("copy", size, offset))
+				errors[0]++;
+
+			// move (overlapping in both directions)
+			for (size_t distance : { 1UL, 7UL, 16UL, 33UL, 100UL }) {
+				reset(size);
+				reference_move(expected + offset, expected + offset + distance, size);
+				Memory::move(buffer + offset, buffer + offset + distance, size);
+				if (!check("move down", size, offset))
+					errors[1]++;
+
+				reset(size);
+				reference_move(expected + offset + distance, expected + offset, size);
+				Memory::move(buffer + offset + distance, buffer + offset, size);
+				if (!check("move up", size, offset))
+					errors[1]++;
+			}
+
+			// set
+			reset(size);
+			for (size_t i = 0; i < size; i++)
+				expected[dest_offset + i] = static_cast<unsigned char>(0x100 + offset - size);
+			if (Memory::set(buffer + dest_offset, 0x100 + offset - size, size) != buffer + dest_offset || !check("set", size, offset))
+				errors[2]++;
+
+			// non-temporal copy and set
+			reset(size);
+			reference_move(expected + dest_offset, source + src_offset, size);
+			if (Memory::stream_copy(buffer + dest_offset, source + src_offset, size) != buffer + dest_offset || !check("stream_copy", size, offset))
+				errors[4]++;
+			for (size_t i = 0; i < size; i++)
+				expected[offset + i] = static_cast<unsigned char>(size);
+			if (Memory::stream_set(buffer + offset, static_cast<int>(size), size) != buffer + offset || !check("stream_set", size, offset))
+				errors[4]++;
+
+			// compare (equal and with a difference at several positions)
+			reference_move(buffer, source + src_offset, size);
+			if (Memory::compare(buffer, source + src_offset, size) != 0)
+				errors[3]++;
+			for (size_t pos : { 0UL, size / 3, size / 2, size - 1 })
+				if (pos < size) {
+					buffer[pos] ^= static_cast<unsigned char>(1 << (offset % 8));
+					if (sign(Memory::compare(buffer, source + src_offset, size)) != sign(reference_compare(buffer, source + src_offset, size))
+					 || sign(Memory::compare(source + src_offset, buffer, size)) != sign(reference_compare(source + src_offset, buffer, size))) {
+						cout << "compare of " << size << " bytes (offset " << offset << ") wrong for difference at " << pos << endl;
+						errors[3]++;
+					}
+					buffer[pos] = source[src_offset + pos];
+				}
+		}
+	}
+
+	cout << "copy errors: " << errors[0] << endl;
+	cout << "move errors: " << errors[1] << endl;
+	cout << "set errors: " << errors[2] << endl;
+	cout << "compare errors: " << errors[3] << endl;
+	cout << "stream errors: " << errors[4] << endl;
+
+	// copy and set switch to non-temporal stores above threshold
+	size_t threshold = Memory::stream_threshold();
+	cout << "stream threshold: " << (threshold >= 64 * 1024) << endl;
+	Memory::stream_threshold(1000);
+	size_t stream_errors = 0;
+	for (size_t size : { 999UL, 1000UL, 1001UL, 65537UL }) {
+		reset(size);
+		reference_move(expected + 3, source + 5, size);
+		Memory::copy(buffer + 3, source + 5, size);
+		if (!check("copy", size, 3))
+			stream_errors++;
+		for (size_t i = 0; i < size; i++)
+			expected[i + 1] = 0;
+		Memory::set(buffer + 1, 0, size);
+		if (!check("set", size, 1))
+			stream_errors++;
+	}
+	Memory::stream_threshold(0);
+	cout << "stream above threshold errors: " << stream_errors << ", default restored: " << (Memory::stream_threshold() == threshold) << endl;
+
+	// Repeat with generic (SSE2) kernels
+	if (argc == 1) {
+		if (auto fork = Syscall::fork()) {
+			if (fork.value() == 0) {
+				const char * args[3] = { argv[0], "generic", nullptr };
+				const char * env[2] = { "DLH_CPU_DISABLE=avx2,erms", nullptr };
+				Syscall::execve(argv[0], args, env);
+				Syscall::exit(1);
+			}
+			Syscall::waitpid(fork.value());
+		}
+	}
+	return 0;
+}
@@ -0,0 +1,46 @@
+// Dirty Little Helper (DLH) - system support library for C/C++
+// Copyright 2021-2023 by Bernhard Heinloth <heinloth@cs.fau.de>
+// SPDX-License-Identifier: AGPL-3.0-or-later
+
+#include <dlh/stream/output.hpp>
+#include <dlh/parser/config.hpp>
+#include <dlh/syscall.hpp>
+#include <dlh/string.hpp>
+#include <dlh/file.hpp>
+#include <dlh/mem.hpp>
+
+const char * path = "/tmp/dlh-test-parser-config";
+
+static void print(Parser::Config & config, const char * name) {
+	const char * value = config.value(name);
+	cout << name << ": " << (value == nullptr ? "(none)" : value) << endl;
+}
+
+int main(int argc, const char *argv[]) {
+	(void) argc;
+	(void) argv;
+
+	size_t used = Memory::stats().used;
+	File::contents::set(path, "# comment=ignored\nfoo=bar\n=a=b\nno value\nempty=\nurl=a=b\n\nlast=end");
+	{
+		Parser::Config config(path);
+		for (const char * name : { "# comment", "foo", "", "=a", "no value", "empty", "url", "last" })
+			print(config, name);
+	}
+
+	// Last line without line break ending at the page boundary
+	char page[4096];
+	Memory::set(page, 'x', sizeof(page));
+	page[0] = '\n';
+	Memory::copy(page + sizeof(page) - 11, "page=border", 11);
+	page[sizeof(page) - 12] = '\n';
+	File::contents::set(path, page, sizeof(page));
+	{
+		Parser::Config config(path);
+		print(config, "page");
+	}
+	cout << "leaked: " << (Memory::stats().used != used) << endl;
+
+	Syscall::unlink(path);
+	return 0;
+}
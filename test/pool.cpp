@@ -0,0 +1,115 @@
+// Dirty Little Helper (DLH) - system support library for C/C++
+// Copyright 2021-2023 by Bernhard Heinloth <heinloth@cs.fau.de>
+// SPDX-License-Identifier: AGPL-3.0-or-later
+
+#include <dlh/stream/output.hpp>
+#include <dlh/container/list.hpp>
+#include <dlh/thread.hpp>
+#include <dlh/random.hpp>
+#include <dlh/pool.hpp>
+
+struct Timer {
+	static int alive;
+	uint64_t id;
+	uint64_t check;
+
+	explicit Timer(uint64_t id) : id(id), check(~id) {
+		__atomic_add_fetch(&alive, 1, __ATOMIC_RELAXED);
+	}
+
+	~Timer() {
+		__atomic_sub_fetch(&alive, 1, __ATOMIC_RELAXED);
+	}
+
+	bool valid() const {
+		return check == ~id;
+	}
+};
+int Timer::alive = 0;
+
+const size_t THREADS = 4;
+const size_t SLOTS = 256;
+const size_t ROUNDS = 50000;
+
+static Pool<Timer> pool;
+
+void* worker(void * arg) {
+	uintptr_t id = reinterpret_cast<uintptr_t>(arg);
+	Random random(static_cast<uint32_t>(id));
+	Pool<Timer>::Magazine magazine(pool);
+	Timer * slots[SLOTS] = {};
+	size_t errors = 0;
+
+	for (size_t r = 0; r < ROUNDS; r++) {
+		Timer * & slot = slots[random.number() % SLOTS];
+		if (slot != nullptr) {
+			if (!slot->valid())
+				errors++;
+			magazine.destroy(slot);
+			slot = nullptr;
+		} else {
+			slot = magazine.create(id << 32 | r);
+			if (slot == nullptr)
+				errors++;
+		}
+	}
+
+	for (auto & slot : slots)
+		magazine.destroy(slot);
+
+	return reinterpret_cast<void*>(errors);
+}
+
+int main(int argc, const char *argv[]) {
+	(void) argc;
+	(void) argv;
+
+	// Single objects
+	Timer * a = pool.create(1);
+	Timer * b = pool.create(2);
+	cout << "alive: " << Timer::alive << ", used: " << pool.used() << endl;
+	pool.destroy(a);
+	Timer * c = pool.create(3);
+	cout << "slot reused: " << (a == c) << endl;
+	pool.destroy(b);
+	pool.destroy(c);
+	cout << "alive: " << Timer::alive << ", used: " << pool.used() << endl;
+
+	// Concurrent magazines
+	Thread * threads[THREADS];
+	for (size_t t = 0; t < THREADS; t++)
+		threads[t] = Thread::create(worker, reinterpret_cast<void*>(t + 1));
+
+	for (size_t t = 0; t < THREADS; t++) {
+		void * errors = nullptr;
+		if (threads[t] == nullptr || !threads[t]->join(&errors))
+			cout << "thread " << (t + 1) << " failed" << endl;
+		else
+			cout << "thread " << (t + 1) << " errors: " << reinterpret_cast<uintptr_t>(errors) << endl;
+	}
+	cout << "alive: " << Timer::alive << ", used: " << pool.used() << endl;
+	cout << "bounded capacity: " << (pool.capacity() <= THREADS * SLOTS * 2) << endl;
+
+	// List nodes
+	 {
+		List<Timer> list;
+		for (uint64_t i = 0; i < 1000; i++)
+			list.emplace_back(i);
+		cout << "list nodes in pool: " << Pool<ListNode<Timer>>::global.used() << endl;
+		size_t capacity = Pool<ListNode<Timer>>::global.capacity();
+		for (int i = 0; i < 500; i++)
+			list.pop_front();
+		for (uint64_t i = 0; i < 500; i++)
+			list.emplace_front(i);
+		cout << "list nodes reused: " << (Pool<ListNode<Timer>>::global.capacity() == capacity) << endl;
+		uint64_t sum = 0;
+		for (const auto & timer : list)
+			if (timer.valid())
+				sum += timer.id;
+		cout << "list sum: " << sum << endl;
+	 }
+	cout << "list nodes in pool: " << Pool<ListNode<Timer>>::global.used() << endl;
+	cout << "alive: " << Timer::alive << endl;
+
+	return 0;
+}
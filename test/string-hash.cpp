@@ -0,0 +1,142 @@
+// Dirty Little Helper (DLH) - system support library for C/C++
+// Copyright 2021-2023 by Bernhard Heinloth <heinloth@cs.fau.de>
+// SPDX-License-Identifier: AGPL-3.0-or-later
+
+#include <dlh/stream/output.hpp>
+#include <dlh/container/hash.hpp>
+#include <dlh/container/vector.hpp>
+#include <dlh/string.hpp>
+#include <dlh/strptr.hpp>
+#include <dlh/random.hpp>
+#include <dlh/mem.hpp>
+
+// Previous hash (djb2) for comparison
+static uint32_t djb2(const char * s) {
+	uint_fast32_t h = 5381;
+	for (unsigned char c = *s; c != '\0'; c = *++s)
+		h = h * 33 + c;
+	return h & 0xffffffff;
+}
+
+const size_t BUCKETS = 4096;
+
+/*! \brief Print collisions and distribution of a key set
+ * \param name name of the key set
+ * \param keys key set
+ * \param hash hash function
+ */
+static void distribution(const char * name, const Vector<const char *> & keys, uint32_t (*hash)(const char *)) {
+	HashSet<uint32_t> values;
+	size_t collisions = 0;
+	uint32_t load[BUCKETS] = {};
+	for (const auto key : keys) {
+		uint32_t h = hash(key);
+		if (!values.insert(h).second)
+			collisions++;
+		load[h % BUCKETS]++;
+	}
+
+	// Chi-squared test (relative to the number of buckets, about 100% for uniform distribution)
+	size_t max = 0;
+	size_t squares = 0;
+	for (auto l : load) {
+		if (l > max)
+			max = l;
+		squares += l * l;
+	}
+	size_t chi = (100 * squares - 100 * keys.size() * keys.size() / BUCKETS) / keys.size();
+	cout << name << ": " << keys.size() << " keys, " << collisions << " collisions, max bucket " << max
+	     << ", chi-squared " << chi << "% (" << (chi > 90 && chi < 110 ? "uniform" : "clustered") << ")" << endl;
+}
+
+static uint32_t hash(const char * s) {
+	return String::hash(s);
+}
+
+int main(int argc, const char *argv[]) {
+	(void) argc;
+	(void) argv;
+
+	// Compile time and run time hash
+	constexpr uint32_t compile_time = String::hash("Dirty Little Helper");
+	char runtime[32];
+	String::copy(runtime, "Dirty Little Helper");
+	cout << "constexpr: " << (compile_time == String::hash(runtime)) << endl;
+	constexpr StrPtr str("a constant string with more than 48 bytes to use all lanes");
+	cout << "strptr: " << (str.hash == String::hash(str.c_str()) && str.find(' ').hash == String::hash(" constant string with more than 48 bytes to use all lanes")) << endl;
+
+	// Length overload
+	bool equal = true;
+	const char * text = "The quick brown fox jumps over the lazy dog, but only if it is not too lazy itself.";
+	for (size_t l = 0; l < sizeof(runtime); l++) {
+		Memory::copy(runtime, text, l);
+		runtime[l] = '\0';
+		if (String::hash(text, l) != String::hash(runtime))
+			equal = false;
+	}
+	cout << "length overload: " << equal << endl;
+	cout << "nullptr: " << String::hash(nullptr) << endl;
+
+	// Different lengths (with zero bytes) result in different hashes
+	const char zeros[64] = {};
+	HashSet<uint32_t> zero;
+	for (size_t l = 0; l < sizeof(zeros); l++)
+		zero.insert(String::hash(zeros, l));
+	cout << "zero strings: " << zero.size() << " different hashes" << endl;
+
+	// Avalanche: flipping a single input bit should flip half of the output bits
+	Random random(42);
+	size_t flipped = 0;
+	size_t tests = 0;
+	char key[65];
+	for (size_t i = 0; i < 200; i++) {
+		size_t l = 1 + random.number() % 64;
+		for (size_t j = 0; j < l; j++)
+			key[j] = static_cast<char>(random.number());
+		uint32_t h = String::hash(key, l);
+		for (size_t bit = 0; bit < 8 * l; bit++) {
+			key[bit / 8] ^= static_cast<char>(1 << (bit % 8));
+			flipped += __builtin_popcount(h ^ String::hash(key, l));
+			key[bit / 8] ^= static_cast<char>(1 << (bit % 8));
+			tests++;
+		}
+	}
+	size_t percent = (100 * flipped + 16 * tests) / (32 * tests);
+	cout << "avalanche: " << (percent >= 49 && percent <= 51 ? "good" : "bad") << endl;
+
+	// Realistic key sets
+	Vector<const char *> numbered;
+	Vector<const char *> paths;
+	Vector<const char *> prefixed;
+	Vector<const char *> words;
+	const char * dirs[] = { "/usr/lib/", "/usr/include/dlh/", "/home/user/.config/", "/var/log/" };
+	const char * ext[] = { ".so", ".hpp", ".conf", ".log", ".o" };
+	char buffer[256];
+	for (size_t i = 0; i < 100000; i++) {
+		(BufferStream(buffer, sizeof(buffer)) << "key" << i).str();
+		numbered.push_back(String::duplicate(buffer));
+		(BufferStream(buffer, sizeof(buffer)) << dirs[i % 4] << "file" << (i / 4) << ext[i % 5]).str();
+		paths.push_back(String::duplicate(buffer));
+		(BufferStream(buffer, sizeof(buffer)) << "a.very.long.common.prefix.for.configuration.entries.section.subsection.value_" << hex << i).str();
+		prefixed.push_back(String::duplicate(buffer));
+	}
+	for (char a = 'a'; a <= 'z'; a++)
+		for (char b = 'a'; b <= 'z'; b++)
+			for (char c = 'a'; c <= 'z'; c++) {
+				const char w[4] = { a, b, c, '\0' };
+				words.push_back(String::duplicate(w));
+			}
+
+	for (auto h : { djb2, hash }) {
+		cout << endl << (h == djb2 ? "djb2" : "String::hash") << endl;
+		distribution("numbered", numbered, h);
+		distribution("paths", paths, h);
+		distribution("prefixed", prefixed, h);
+		distribution("words", words, h);
+	}
+
+	for (auto keys : { &numbered, &paths, &prefixed, &words })
+		for (auto k : *keys)
+			Memory::free(const_cast<char *>(k));
+	return 0;
+}
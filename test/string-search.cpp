@@ -0,0 +1,162 @@
+// Dirty Little Helper (DLH) - system support library for C/C++
+// Copyright 2021-2023 by Bernhard Heinloth <heinloth@cs.fau.de>
+// SPDX-License-Identifier: AGPL-3.0-or-later
+
+#include <dlh/stream/output.hpp>
+#include <dlh/container/initializer_list.hpp>
+#include <dlh/syscall.hpp>
+#include <dlh/string.hpp>
+#include <dlh/random.hpp>
+#include <dlh/mem.hpp>
+
+const size_t PAGE = 4096;
+
+static const char * reference_find(const char * haystack, size_t haystack_len, const char * needle, size_t needle_len) {
+	for (size_t i = 0; i + needle_len <= haystack_len; i++) {
+		size_t j = 0;
+		while (j < needle_len && haystack[i + j] == needle[j])
+			j++;
+		if (j == needle_len)
+			return haystack + i;
+	}
+	return nullptr;
+}
+
+static const char * reference_find_last(const char * haystack, size_t haystack_len, const char * needle, size_t needle_len) {
+	const char * last = nullptr;
+	for (const char * r = haystack; (r = reference_find(r, haystack_len - (r - haystack), needle, needle_len)) != nullptr; r++)
+		last = r;
+	return last;
+}
+
+static size_t errors[3] = { 0, 0, 0 };
+
+/*! \brief Check search functions
+ * \param haystack null-terminated string
+ * \param needle null-terminated string
+ */
+static void check(const char * haystack, const char * needle) {
+	size_t haystack_len = String::len(haystack);
+	size_t needle_len = String::len(needle);
+	const char * first = reference_find(haystack, haystack_len, needle, needle_len);
+	const char * last = reference_find_last(haystack, haystack_len, needle, needle_len);
+
+	String::Searcher searcher(needle);
+	if (searcher.find(haystack) != first || searcher.find(haystack, haystack_len) != first)
+		errors[0]++;
+	if (String::find(haystack, needle) != first || String::find_or_end(haystack, needle) != (first == nullptr ? haystack + haystack_len : first))
+		errors[1]++;
+	if (searcher.find_last(haystack) != last || String::find_last(haystack, needle) != last)
+		errors[2]++;
+}
+
+int main(int argc, const char *argv[]) {
+	if (argc > 1)
+		cout << "kernels: " << argv[1] << endl;
+
+	// Page followed by an inaccessible page
+	uintptr_t area = Syscall::mmap(0, 2 * PAGE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS).value();
+	Syscall::mprotect(area + PAGE, PAGE, PROT_NONE);
+	char * page = reinterpret_cast<char *>(area);
+
+	// Small alphabet for many (partial) matches
+	Random random(42);
+	for (size_t i = 0; i < PAGE; i++)
+		page[i] = "abc\x80"[random.number() % 4];
+	page[PAGE - 1] = '\0';
+
+	char needle[200];
+	for (size_t needle_len : { 1UL, 2UL, 3UL, 5UL, 16UL, 31UL, 32UL, 33UL, 40UL, 64UL, 150UL }) {
+		// Needles taken from the end of the page (matching the very last bytes)
+		for (size_t haystack_len : { needle_len, needle_len + 1, 63UL, 100UL, 1000UL, PAGE - 1 })
+			if (haystack_len >= needle_len) {
+				const char * haystack = page + PAGE - 1 - haystack_len;
+				Memory::copy(needle, haystack + haystack_len - needle_len, needle_len + 1);
+				check(haystack, needle);
+				// Last character modified (most likely not found)
+				needle[needle_len - 1] = 'x';
+				check(haystack, needle);
+			}
+
+		// Random needles
+		for (size_t i = 0; i < 20; i++) {
+			for (size_t n = 0; n < needle_len; n++)
+				needle[n] = "abc\x80"[random.number() % (n < needle_len / 2 ? 2 : 4)];
+			needle[needle_len] = '\0';
+			check(page + random.number() % 64, needle);
+		}
+
+		// Periodic needles
+		for (const char * period : { "a", "ab", "aab", "abcab" }) {
+			size_t period_len = String::len(period);
+			for (size_t n = 0; n < needle_len; n++)
+				needle[n] = period[n % period_len];
+			needle[needle_len] = '\0';
+			char haystack[400];
+			for (size_t n = 0; n < 2 * needle_len + 50; n++)
+				haystack[n] = period[n % period_len];
+			haystack[2 * needle_len + 50] = '\0';
+			check(haystack, needle);
+			haystack[needle_len + 7] = 'c';
+			check(haystack, needle);
+			// Defect at the end
+			needle[needle_len - 1] = 'b';
+			check(haystack, needle);
+		}
+	}
+
+	// Periodic needle: after a partial match, the shift on a mismatching last
+	// character must not skip the match following the remembered prefix
+	check("baabbcbbabbacccabcabbcbbabcacccabbcabbcbbabcacccabcabbcbbabcacccab", "bcabbcbbabcacccabcabbcbbabcacccab");
+
+	// Long haystack (searched in several chunks) with matches across chunk boundaries
+	const size_t LONG = 5 * PAGE;
+	char * text = Memory::alloc<char>(LONG + 1);
+	Memory::set(text, 'a', LONG);
+	text[LONG] = '\0';
+	for (size_t needle_len : { 2UL, 40UL, 5000UL }) {
+		char * long_needle = Memory::alloc<char>(needle_len + 1);
+		Memory::set(long_needle, 'a', needle_len - 1);
+		long_needle[needle_len - 1] = 'b';
+		long_needle[needle_len] = '\0';
+		for (size_t pos : { PAGE - 1, PAGE, 2 * PAGE + 3, LONG - 1 }) {
+			text[pos] = 'b';
+			check(text, long_needle);
+			text[pos] = 'a';
+		}
+		check(text, long_needle);
+		Memory::free(long_needle);
+	}
+	Memory::free(text);
+
+	cout << "searcher errors: " << errors[0] << endl;
+	cout << "find errors: " << errors[1] << endl;
+	cout << "find_last errors: " << errors[2] << endl;
+
+	// Reusing a searcher on buffers (with null bytes)
+	String::Searcher searcher("needle in a haystack, but a much longer one");
+	char buffer[256];
+	Memory::set(buffer, '\0', sizeof(buffer));
+	String::copy(buffer + 200, "needle in a haystack, but a much longer one");
+	cout << "buffer: " << (searcher.find(buffer, sizeof(buffer)) == buffer + 200) << endl;
+	cout << "truncated buffer: " << (searcher.find(buffer, 242) == nullptr) << endl;
+	cout << "string: " << (searcher.find(buffer) == nullptr) << endl;
+	cout << "length: " << searcher.length() << endl;
+
+	// Empty needle
+	cout << "empty: " << (String::Searcher("").find(buffer + 200) == buffer + 200) << endl;
+
+	// Repeat with generic (SSE2) kernels
+	if (argc == 1) {
+		if (auto fork = Syscall::fork()) {
+			if (fork.value() == 0) {
+				const char * args[3] = { argv[0], "generic", nullptr };
+				const char * env[2] = { "DLH_CPU_DISABLE=avx2", nullptr };
+				Syscall::execve(argv[0], args, env);
+				Syscall::exit(1);
+			}
+			Syscall::waitpid(fork.value());
+		}
+	}
+	return 0;
+}
@@ -0,0 +1,154 @@
+// Dirty Little Helper (DLH) - system support library for C/C++
+// Copyright 2021-2023 by Bernhard Heinloth <heinloth@cs.fau.de>
+// SPDX-License-Identifier: AGPL-3.0-or-later
+
+#include <dlh/stream/output.hpp>
+#include <dlh/container/initializer_list.hpp>
+#include <dlh/syscall.hpp>
+#include <dlh/string.hpp>
+#include <dlh/random.hpp>
+#include <dlh/mem.hpp>
+
+const size_t PAGE = 4096;
+
+static size_t reference_len(const char * s, size_t n = SIZE_MAX) {
+	size_t l = 0;
+	while (l < n && s[l] != '\0')
+		l++;
+	return l;
+}
+
+static const char * reference_find_or_end(const char * s, char c) {
+	while (*s != '\0' && *s != c)
+		s++;
+	return s;
+}
+
+static const char * reference_find_last(const char * s, char c) {
+	const char * last = nullptr;
+	for (; *s != '\0'; s++)
+		if (*s == c)
+			last = s;
+	return last;
+}
+
+static int reference_compare(const char * s1, const char * s2, size_t n = SIZE_MAX) {
+	for (size_t i = 0; i < n; i++)
+		if (s1[i] != s2[i])
+			return static_cast<int>(s1[i]) - static_cast<int>(s2[i]);
+		else if (s1[i] == '\0')
+			break;
+	return 0;
+}
+
+static size_t errors[4] = { 0, 0, 0, 0 };
+
+/*! \brief Check all functions on a string
+ * \param s string
+ * \param other string with the same length (for comparison)
+ */
+static void check(const char * s, char * other) {
+	size_t l = reference_len(s);
+
+	// len
+	if (String::len(s) != l)
+		errors[0]++;
+	for (size_t n : { 0UL, 1UL, l / 2, l, l + 1 })
+		if (String::len(s, n) != reference_len(s, n))
+			errors[0]++;
+
+	// find
+	for (size_t i : { 0UL, l / 3, l / 2, l - 1 })
+		if (i < l) {
+			char c = s[i];
+			if (String::find_or_end(s, c) != reference_find_or_end(s, c)
+			 || String::find(s, c) != reference_find_or_end(s, c)
+			 || String::find_last(s, c) != reference_find_last(s, c))
+				errors[1]++;
+		}
+	if (String::find_or_end(s, '\n') != s + l || String::find(s, '\n') != nullptr || String::find_last(s, '\n') != nullptr)
+		errors[1]++;
+	if (String::find_or_end(s, '\0') != s + l || String::find(s, '\0') != nullptr || String::find_last(s, '\0') != nullptr)
+		errors[1]++;
+
+	// compare with equal string
+	if (String::compare(s, other) != 0 || String::compare(other, s) != 0 || String::compare(s, other, l + 5) != 0)
+		errors[2]++;
+
+	// compare with differences
+	for (size_t i : { 0UL, l / 3, l - 1 })
+		if (i < l) {
+			char o = other[i];
+			for (char d : { '\x01', '\x7f', '\x80', static_cast<char>(-o) }) {
+				other[i] = d;
+				if (String::compare(s, other) != reference_compare(s, other)
+				 || String::compare(other, s) != reference_compare(other, s)
+				 || String::compare(s, other, i) != 0
+				 || String::compare(s, other, i + 1) != reference_compare(s, other, i + 1))
+					errors[3]++;
+			}
+			other[i] = o;
+		}
+}
+
+int main(int argc, const char *argv[]) {
+	if (argc > 1)
+		cout << "kernels: " << argv[1] << endl;
+
+	// Two pages each followed by an inaccessible page
+	uintptr_t area = Syscall::mmap(0, 4 * PAGE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS).value();
+	Syscall::mprotect(area + PAGE, PAGE, PROT_NONE);
+	Syscall::mprotect(area + 3 * PAGE, PAGE, PROT_NONE);
+	char * first = reinterpret_cast<char *>(area);
+	char * second = reinterpret_cast<char *>(area + 2 * PAGE);
+
+	Random random(23);
+	for (size_t i = 0; i < PAGE; i++) {
+		// Printable characters and a few bytes with the most significant bit set
+		char c = static_cast<char>(random.number() % 100 + ' ');
+		first[i] = second[i] = c < 'z' ? c : static_cast<char>(c + 64);
+	}
+
+	// Strings ending right before the inaccessible page
+	first[PAGE - 1] = '\0';
+	for (size_t l = 0; l < 300; l++) {
+		char * s = first + PAGE - 1 - l;
+		for (size_t shift : { 0UL, 1UL, 13UL, 31UL }) {
+			char * o = second + PAGE - 1 - l - shift;
+			Memory::copy(o, s, l + 1);
+			check(s, o);
+			check(o, s);
+		}
+	}
+
+	// Strings at all alignments within a page
+	for (size_t offset = 0; offset < 64; offset++)
+		for (size_t l : { 0UL, 1UL, 15UL, 16UL, 17UL, 31UL, 32UL, 33UL, 63UL, 64UL, 65UL, 100UL, 1000UL }) {
+			char * s = first + offset;
+			char * o = second + 64 - offset;
+			char c = s[l];
+			s[l] = '\0';
+			Memory::copy(o, s, l + 1);
+			check(s, o);
+			s[l] = c;
+		}
+
+	cout << "len errors: " << errors[0] << endl;
+	cout << "find errors: " << errors[1] << endl;
+	cout << "compare equal errors: " << errors[2] << endl;
+	cout << "compare different errors: " << errors[3] << endl;
+
+	// Repeat with generic (SSE2) kernels
+	if (argc == 1) {
+		if (auto fork = Syscall::fork()) {
+			if (fork.value() == 0) {
+				const char * args[3] = { argv[0], "generic", nullptr };
+				const char * env[2] = { "DLH_CPU_DISABLE=avx2", nullptr };
+				Syscall::execve(argv[0], args, env);
+				Syscall::exit(1);
+			}
+			Syscall::waitpid(fork.value());
+		}
+	}
+	return 0;
+}
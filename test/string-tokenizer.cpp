@@ -0,0 +1,137 @@
+// Dirty Little Helper (DLH) - system support library for C/C++
+// Copyright 2021-2023 by Bernhard Heinloth <heinloth@cs.fau.de>
+// SPDX-License-Identifier: AGPL-3.0-or-later
+
+#include <dlh/stream/output.hpp>
+#include <dlh/container/initializer_list.hpp>
+#include <dlh/syscall.hpp>
+#include <dlh/string.hpp>
+#include <dlh/random.hpp>
+#include <dlh/mem.hpp>
+
+const size_t PAGE = 4096;
+
+static bool is_delimiter(char c, const char * delimiters) {
+	for (; *delimiters != '\0'; delimiters++)
+		if (c == *delimiters)
+			return true;
+	return false;
+}
+
+static size_t errors[3] = { 0, 0, 0 };
+
+/*! \brief Compare tokenizer with a scalar reference
+ * \param source buffer (the last byte might be the last accessible one)
+ * \param source_len length of buffer
+ * \param delimiters set of delimiters
+ * \param max maximum number of splits
+ */
+static void check(const char * source, size_t source_len, const char * delimiters, size_t max) {
+	String::Tokenizer tokenizer(source, source_len, delimiters, max);
+	String::Tokenizer::Token token;
+	size_t s = 0;
+	for (size_t i = 0; i <= source_len; i++)
+		if (i == source_len || (max > 0 && is_delimiter(source[i], delimiters))) {
+			if (s < i) {
+				if (i < source_len)
+					max--;
+				if (!tokenizer.next(token) || token.str != source + s || token.len != i - s)
+					errors[0]++;
+			}
+			s = i + 1;
+		}
+	if (tokenizer.next(token))
+		errors[0]++;
+
+	// Single delimiter
+	if (delimiters[0] != '\0' && delimiters[1] == '\0') {
+		size_t n = 0;
+		for (const auto & t : String::Tokenizer(source, source_len, delimiters[0], max)) {
+			(void) t;
+			n++;
+		}
+		size_t m = 0;
+		for (const auto & t : String::Tokenizer(source, source_len, delimiters, max)) {
+			(void) t;
+			m++;
+		}
+		if (n != m)
+			errors[1]++;
+	}
+}
+
+int main(int argc, const char *argv[]) {
+	if (argc > 1)
+		cout << "kernels: " << argv[1] << endl;
+
+	// Page followed by an inaccessible page
+	uintptr_t area = Syscall::mmap(0, 2 * PAGE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS).value();
+	Syscall::mprotect(area + PAGE, PAGE, PROT_NONE);
+	char * page = reinterpret_cast<char *>(area);
+
+	Random random(42);
+	for (size_t i = 0; i < PAGE; i++)
+		page[i] = "abc,; \n\0"[random.number() % (i % 512 < 256 ? 3 : 8)];
+
+	for (const char * delimiters : { "", ",", "\n", ",;", ", \n", ",; \n\t", "abc" })
+		for (size_t len : { 0UL, 1UL, 2UL, 15UL, 16UL, 17UL, 31UL, 32UL, 33UL, 100UL, 1000UL, PAGE })
+			for (size_t max : { 0UL, 1UL, 5UL, SIZE_MAX }) {
+				check(page + PAGE - len, len, delimiters, max);
+				check(page, len, delimiters, max);
+				check(page + random.number() % (PAGE - len + 1), len, delimiters, max);
+			}
+	cout << "tokenizer errors: " << errors[0] << endl;
+	cout << "single delimiter errors: " << errors[1] << endl;
+
+	// Compare with split
+	char text[200];
+	for (size_t i = 0; i < 1000; i++) {
+		size_t len = random.number() % (sizeof(text) - 1);
+		for (size_t j = 0; j < len; j++)
+			text[j] = "ab,; "[random.number() % 5];
+		text[len] = '\0';
+		size_t max = random.number() % 2 == 0 ? SIZE_MAX : random.number() % 8;
+		auto parts = String::split_any(text, ",; ", max);
+		size_t n = 0;
+		for (const auto & t : String::Tokenizer(text, ",; ", max))
+			if (n >= parts.size() || String::len(parts[n]) != t.len || String::compare(parts[n++], t.str, t.len) != 0)
+				errors[2]++;
+		if (n != parts.size())
+			errors[2]++;
+		for (auto p : parts)
+			Memory::free(const_cast<char *>(p));
+	}
+	cout << "split errors: " << errors[2] << endl;
+
+	// Example
+	const char * csv = ";;first, second;third,,  fourth;;";
+	String::Tokenizer tokenizer(csv, ",; ");
+	for (const auto & t : tokenizer) {
+		cout.write(t.str, t.len);
+		cout << '|';
+	}
+	cout << endl;
+	String::Tokenizer::Token token;
+	tokenizer.next(token);
+	cout << "remaining after first: " << tokenizer.remaining() << endl;
+	for (const auto & t : String::Tokenizer(csv, ';', 2)) {
+		cout.write(t.str, t.len);
+		cout << '|';
+	}
+	cout << endl;
+	cout << "empty: " << (String::Tokenizer("", ",").begin() == String::Tokenizer(nullptr, ",").end()) << endl;
+
+	// Repeat with generic (SSE2) kernels
+	if (argc == 1) {
+		if (auto fork = Syscall::fork()) {
+			if (fork.value() == 0) {
+				const char * args[3] = { argv[0], "generic", nullptr };
+				const char * env[2] = { "DLH_CPU_DISABLE=avx2", nullptr };
+				Syscall::execve(argv[0], args, env);
+				Syscall::exit(1);
+			}
+			Syscall::waitpid(fork.value());
+		}
+	}
+	return 0;
+}
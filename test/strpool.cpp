@@ -0,0 +1,90 @@
+// Dirty Little Helper (DLH) - system support library for C/C++
+// Copyright 2021-2023 by Bernhard Heinloth <heinloth@cs.fau.de>
+// SPDX-License-Identifier: AGPL-3.0-or-later
+
+#include <dlh/stream/output.hpp>
+#include <dlh/container/hash.hpp>
+#include <dlh/container/tree.hpp>
+#include <dlh/strpool.hpp>
+#include <dlh/thread.hpp>
+#include <dlh/string.hpp>
+
+const size_t THREADS = 4;
+const size_t WORDS = 2000;
+
+static StringPool pool;
+static Atom atoms[THREADS][WORDS];
+
+// Interned by a static constructor (global pool has to be usable already)
+static Atom early = StringPool::global().intern("early");
+
+static void * worker(void * arg) {
+	size_t t = reinterpret_cast<size_t>(arg);
+	char buffer[32];
+	// Each thread interns the same words (in a different order)
+	for (size_t i = 0; i < WORDS; i++) {
+		size_t w = (i * 7 + t * 13) % WORDS;
+		(BufferStream(buffer, sizeof(buffer)) << "word" << w).str();
+		atoms[t][w] = pool.intern(buffer);
+	}
+	return nullptr;
+}
+
+int main(int argc, const char *argv[]) {
+	(void) argc;
+	(void) argv;
+
+	// Interning
+	StringPool & global = StringPool::global();
+	char key[] = "config.key";
+	Atom a = global.intern("config.key");
+	Atom b = global.intern(key);
+	Atom c = global.intern("config.key.suffix", 10);
+	Atom d = global.intern("config.value");
+	cout << "a: " << a << " (" << a.len() << " chars)" << endl;
+	cout << "same pointer: " << (a.c_str() == b.c_str() && a.c_str() == c.c_str()) << endl;
+	cout << "a == b: " << (a == b) << ", a == d: " << (a == d) << endl;
+	cout << "hash: " << (a.hash() == String::hash("config.key")) << endl;
+	cout << "strptr: " << (a.strptr() == StrPtr("config.key")) << endl;
+	cout << "copied: " << (a.c_str() != key) << endl;
+	cout << "find: " << (global.find("config.value") == d) << ", missing: " << static_cast<bool>(global.find("config")) << endl;
+	cout << "empty: " << global.intern("").empty() << ", null: " << static_cast<bool>(global.intern(nullptr)) << endl;
+	cout << "static constructor: " << (global.find("early") == early && early.len() == 5) << endl;
+	cout << "pool size: " << global.size() << endl;
+
+	// Containers
+	HashMap<Atom, int> map;
+	map.insert(a, 1);
+	map.insert(d, 2);
+	map.insert(b, 3);
+	cout << "map size: " << map.size() << ", a: " << map[global.intern("config.key")] << endl;
+
+	TreeSet<Atom> tree;
+	for (const char * s : { "zeta", "alpha", "mu", "alpha" })
+		tree.insert(global.intern(s));
+	cout << "tree:";
+	for (const auto & t : tree)
+		cout << ' ' << t;
+	cout << endl;
+
+	// Concurrent interning
+	Thread * threads[THREADS];
+	for (size_t t = 1; t < THREADS; t++)
+		threads[t] = Thread::create(worker, reinterpret_cast<void*>(t));
+	worker(reinterpret_cast<void*>(0));
+	for (size_t t = 1; t < THREADS; t++)
+		if (threads[t] == nullptr || !threads[t]->join())
+			cout << "thread " << t << " failed" << endl;
+
+	size_t errors = 0;
+	HashSet<Atom> unique;
+	for (size_t w = 0; w < WORDS; w++) {
+		for (size_t t = 1; t < THREADS; t++)
+			if (atoms[t][w] != atoms[0][w])
+				errors++;
+		unique.insert(atoms[0][w]);
+	}
+	cout << "concurrent errors: " << errors << endl;
+	cout << "unique: " << unique.size() << ", pool size: " << pool.size() << endl;
+	return 0;
+}
@@ -0,0 +1,190 @@
+// Dirty Little Helper (DLH) - system support library for C/C++
+// Copyright 2021-2023 by Bernhard Heinloth <heinloth@cs.fau.de>
+// SPDX-License-Identifier: AGPL-3.0-or-later
+
+#include <dlh/stream/output.hpp>
+#include <dlh/syscall.hpp>
+#include <dlh/xxhash.hpp>
+#include <dlh/random.hpp>
+#include <dlh/mem.hpp>
+
+// Test vectors generated with the reference implementation (xxHash 0.8)
+static const struct {
+	size_t length;
+	bool seeded;
+	uint64_t hash;
+	uint64_t low;
+	uint64_t high;
+} vectors[] = {
+	{    0, 0, 0x2d06800538d394c2ULL, 0x6001c324468d497fULL, 0x99aa06d3014798d8ULL },
+	{    1, 0, 0xc44bdff4074eecdbULL, 0xc44bdff4074eecdbULL, 0xa6cd5e9392000f6aULL },
+	{    2, 0, 0x7a9978044cb8a8bbULL, 0x7a9978044cb8a8bbULL, 0x76750c3c7bf95668ULL },
+	{    3, 0, 0x54247382a8d6b94dULL, 0x54247382a8d6b94dULL, 0x20efc49ff02422eaULL },
+	{    4, 0, 0xe5dc74bc51848a51ULL, 0x2e7d8d6876a39fe9ULL, 0x970d585ac632bf8eULL },
+	{    6, 0, 0x27b56a84cd2d7325ULL, 0x3e7039bdda43cfc6ULL, 0x082afe0b8162d12aULL },
+	{    8, 0, 0x24ccc9acaa9f65e4ULL, 0x64c69cab4bb21dc5ULL, 0x47a7f080d82bb456ULL },
+	{    9, 0, 0x14d5001c15dd3f2bULL, 0xed7ccbc501eb7501ULL, 0x564ef6078950d457ULL },
+	{   12, 0, 0xa713daf0dfbb77e7ULL, 0x061a192713f69ad9ULL, 0x6e3efd8fc7802b18ULL },
+	{   16, 0, 0x981b17d36c7498c9ULL, 0x562980258a998629ULL, 0xc68c368ecf8a9c05ULL },
+	{   17, 0, 0x796f5acd3a60f862ULL, 0xabbc12d11973d7dbULL, 0x955fa78643ed3669ULL },
+	{   31, 0, 0x5d516692ca764c50ULL, 0xec8365e74dc00653ULL, 0x301048a7ab476d21ULL },
+	{   32, 0, 0x9feaddbdbf57eed3ULL, 0x278410a17595e3f9ULL, 0x98fc6458710dc2e8ULL },
+	{   33, 0, 0xabfb2d081b400a10ULL, 0xe593bc4e5914c9d1ULL, 0x3103c192ceaa2dedULL },
+	{   64, 0, 0x9cb48487720ec49dULL, 0xefdb6a44690721a9ULL, 0x6d90e81a9b0fd622ULL },
+	{   65, 0, 0xfd81aac4bebc3883ULL, 0xfe2f650fa500ec6eULL, 0x6c074d65e54db85aULL },
+	{   96, 0, 0x935a769a7f94776fULL, 0xe9324473ea9afebeULL, 0xd9d0b885f56c93f1ULL },
+	{  100, 0, 0x93cd95432b7d483fULL, 0x5fcbc2e3295f2476ULL, 0x9b50b05817ab158eULL },
+	{  128, 0, 0xfcff24126754d861ULL, 0xebb15e34a7fb5ab1ULL, 0x39992220e045260aULL },
+	{  129, 0, 0x98f1b0a679a2ca29ULL, 0x86c9e3bc8f0a3b5cULL, 0x03815fc91f1b30b6ULL },
+	{  150, 0, 0xf37b3081c8df11f6ULL, 0x709c3e3190c65781ULL, 0xcd033e3570aa7910ULL },
+	{  160, 0, 0x9d03a319ed4cbd2bULL, 0x737126c8d7c09ceeULL, 0xba5d218964b622adULL },
+	{  200, 0, 0xbddca58935d7c038ULL, 0xeb060f1bb3126f5aULL, 0xe76ff4780fe18439ULL },
+	{  240, 0, 0x81c3c2b67f568ccfULL, 0x5c9aae94c8ebe5a0ULL, 0xaa4202daa2769dc8ULL },
+	{  241, 0, 0xc5a639ecd2030e5eULL, 0xc5a639ecd2030e5eULL, 0x99a80ecf0ecfc647ULL },
+	{  255, 0, 0xe98f979f4ed8a197ULL, 0xe98f979f4ed8a197ULL, 0x961375c87e09efbcULL },
+	{  256, 0, 0x55de574ad89d0ac5ULL, 0x55de574ad89d0ac5ULL, 0x8b1c66091423d288ULL },
+	{  257, 0, 0xb17fd5a8ae75bb0bULL, 0xb17fd5a8ae75bb0bULL, 0xf15fee7f9f457599ULL },
+	{  511, 0, 0x8089715b163e7fc0ULL, 0x8089715b163e7fc0ULL, 0x9f7619cb8d250f0dULL },
+	{ 1024, 0, 0xdd85c9b5c1109c5cULL, 0xdd85c9b5c1109c5cULL, 0x0d30d24071c64c57ULL },
+	{ 1025, 0, 0xd870c0fa13211c6aULL, 0xd870c0fa13211c6aULL, 0xfd3ee4fe7f2954c6ULL },
+	{ 2048, 0, 0xdd59e2c3a5f038e0ULL, 0xdd59e2c3a5f038e0ULL, 0xf736557fd47073a5ULL },
+	{ 2240, 0, 0x6e73a90539cf2948ULL, 0x6e73a90539cf2948ULL, 0xccb134fbfa7ce49dULL },
+	{ 2241, 0, 0xe800eca585fe92d9ULL, 0xe800eca585fe92d9ULL, 0x64a1592c03f3b910ULL },
+	{ 2367, 0, 0xcb37aeb9e5d361edULL, 0xcb37aeb9e5d361edULL, 0xe89c0f6ff369b427ULL },
+	{ 4096, 0, 0xe91206429d1f48f9ULL, 0xe91206429d1f48f9ULL, 0xb9cfaea2ca5626a4ULL },
+	{ 4999, 0, 0xf92a85a6ea06d646ULL, 0xf92a85a6ea06d646ULL, 0x7d24a1b8671f6717ULL },
+	{    0, 1, 0xa8a6b918b2f0364aULL, 0xa986dfc5d7605bfeULL, 0x00feaa732a3ce25eULL },
+	{    1, 1, 0x032be332dd766ef8ULL, 0x032be332dd766ef8ULL, 0x20e49abcc53b3842ULL },
+	{    2, 1, 0x764b35c90519ad88ULL, 0x764b35c90519ad88ULL, 0x7b96e6a600dae67dULL },
+	{    3, 1, 0x634b8990b4976373ULL, 0x634b8990b4976373ULL, 0x1c7ecf6a308cf00eULL },
+	{    4, 1, 0xaa2e7eccb0c8f747ULL, 0xbfaf51f1e67e0b0fULL, 0x3d53e5dfd837d927ULL },
+	{    6, 1, 0x84589c116ab59ab9ULL, 0xc5b54d56038e4e40ULL, 0x014bd95a51ca5ddbULL },
+	{    8, 1, 0x8f973410999b8f6bULL, 0x7b29471dc729b5ffULL, 0xf50cec145bcd5c5aULL },
+	{    9, 1, 0xb3ae7333d9013f60ULL, 0xaef5dfc0ac9f9044ULL, 0x6b380b43ffa61042ULL },
+	{   12, 1, 0xe7303e1b2336de0eULL, 0x5d92b5d7190b12d1ULL, 0xff0d60acd02ed401ULL },
+	{   16, 1, 0x663f29333b4db6b1ULL, 0x0346d13a7a5498c7ULL, 0x6ffcb80cd33085c8ULL },
+	{   17, 1, 0xf3ec5067f4306db3ULL, 0x980a14119985a7dfULL, 0xd77681219e464828ULL },
+	{   31, 1, 0x9b37274259c549c6ULL, 0xd74750f8952360c3ULL, 0x4639cf7b77ba9096ULL },
+	{   32, 1, 0x2199fab1534893d9ULL, 0x0054e82631cef166ULL, 0xcc587e4fcdb86bc5ULL },
+	{   33, 1, 0xad56348da574bb6dULL, 0xc361d36cea597c31ULL, 0x21273c8190c645cdULL },
+	{   64, 1, 0x4fe8895db9b8c077ULL, 0x9405ba2affa95cebULL, 0x37b738968d40bda5ULL },
+	{   65, 1, 0xad80aeec1fc9e0a7ULL, 0x9d60c345e5c297cdULL, 0x72503a6fa8d07adbULL },
+	{   96, 1, 0x70cf51937e500540ULL, 0xd61f3ab58705c405ULL, 0x6f9ed3c2008cb388ULL },
+	{  100, 1, 0xea932549a3d7fb01ULL, 0xd5e0c2a715f11657ULL, 0x984cec52a9a9a561ULL },
+	{  128, 1, 0x73fde75280646649ULL, 0x8394f5c51f1d8246ULL, 0xa0f7ccb68ee02addULL },
+	{  129, 1, 0x21fffdbca099c844ULL, 0xd4aae26fcec7dc03ULL, 0xad559266067c0bf3ULL },
+	{  150, 1, 0x608b69ef63f8c716ULL, 0x679fccd06dfd8638ULL, 0x84a028e0dce2f968ULL },
+	{  160, 1, 0x3825c75ffe70fde0ULL, 0x46a4a3f67ccd556eULL, 0xc6b7abc26def52acULL },
+	{  200, 1, 0x5b899e984b88db8dULL, 0x2236d1b483e8d9ebULL, 0xcf0349dd7cc2b545ULL },
+	{  240, 1, 0xcc0f58c27ef3d8eeULL, 0x604e98db085c1864ULL, 0x29d2133d6ea58c5bULL },
+	{  241, 1, 0xdda9b0a161d4829aULL, 0xdda9b0a161d4829aULL, 0xec64afae6a137582ULL },
+	{  255, 1, 0x2aca7901d9538c75ULL, 0x2aca7901d9538c75ULL, 0xe72ec0137d62df44ULL },
+	{  256, 1, 0x4d30234b7a3aa61cULL, 0x4d30234b7a3aa61cULL, 0xaaa57235b92d5e7cULL },
+	{  257, 1, 0x802a6fbf3cacd97cULL, 0x802a6fbf3cacd97cULL, 0x15c1f9c667c815baULL },
+	{  511, 1, 0x90ec0377ba8d6002ULL, 0x90ec0377ba8d6002ULL, 0xb52cae55536e9fb9ULL },
+	{ 1024, 1, 0xef368a8a2ebabaefULL, 0xef368a8a2ebabaefULL, 0x17600efe2b493a18ULL },
+	{ 1025, 1, 0x96792bcf9af88519ULL, 0x96792bcf9af88519ULL, 0x2c383949f57bf7e1ULL },
+	{ 2048, 1, 0x66f81670669ababcULL, 0x66f81670669ababcULL, 0x23cc3a2e75ebaaeaULL },
+	{ 2240, 1, 0x757ba8487d1b5247ULL, 0x757ba8487d1b5247ULL, 0xe40842f585875ba9ULL },
+	{ 2241, 1, 0x3b33bdec09c21950ULL, 0x3b33bdec09c21950ULL, 0xfb5273e20f608f41ULL },
+	{ 2367, 1, 0xd2db3415b942b42aULL, 0xd2db3415b942b42aULL, 0xccb7a94cca1a6496ULL },
+	{ 4096, 1, 0x2a3bbb20a5439dcdULL, 0x2a3bbb20a5439dcdULL, 0x8fbc8fd4d526d1bdULL },
+	{ 4999, 1, 0x596d51a843adda46ULL, 0x596d51a843adda46ULL, 0x78a8b02d03b68151ULL },
+};
+
+const size_t SIZE = 5000;
+const uint64_t SEED = 0x9E3779B185EBCA8DULL;
+
+int main(int argc, const char *argv[]) {
+	if (argc > 1)
+		cout << "kernels: " << argv[1] << endl;
+
+	// Same pseudorandom input as in the reference sanity check
+	unsigned char * input = Memory::alloc<unsigned char>(SIZE);
+	uint64_t gen = 2654435761U;
+	for (size_t i = 0; i < SIZE; i++) {
+		input[i] = static_cast<unsigned char>(gen >> 56);
+		gen *= 11400714785074694797ULL;
+	}
+
+	size_t errors[3] = { 0, 0, 0 };
+	Random random(42);
+	for (const auto & v : vectors) {
+		const uint64_t seed = v.seeded ? SEED : 0;
+		const XXHash3::Hash128 h128 = { v.low, v.high };
+		// One-shot
+		if (XXHash3::hash(input, v.length, seed) != v.hash || XXHash3::hash128(input, v.length, seed) != h128) {
+			cout << "one-shot " << v.length << " failed" << endl;
+			errors[0]++;
+		}
+		// Streaming (in random chunks)
+		XXHash3 stream(seed);
+		for (size_t pos = 0; pos < v.length;) {
+			size_t chunk = random.number() % (random.number() % 2 == 0 ? 16 : 600);
+			if (chunk > v.length - pos)
+				chunk = v.length - pos;
+			stream.add(input + pos, chunk);
+			pos += chunk;
+		}
+		if (stream.hash() != v.hash || stream.hash128() != h128) {
+			cout << "streaming " << v.length << " failed" << endl;
+			errors[1]++;
+		}
+		// Byte by byte
+		stream.reset(seed);
+		for (size_t pos = 0; pos < v.length; pos++)
+			stream.add(input[pos]);
+		if (stream.hash() != v.hash || stream.hash128() != h128) {
+			cout << "bytewise " << v.length << " failed" << endl;
+			errors[2]++;
+		}
+	}
+	cout << "one-shot errors: " << errors[0] << endl;
+	cout << "streaming errors: " << errors[1] << endl;
+	cout << "bytewise errors: " << errors[2] << endl;
+
+	// Compile time hashing
+	constexpr uint64_t compile_time = XXHash3::hash("Dirty Little Helper", 19);
+	constexpr XXHash3::Hash128 compile_time128 = XXHash3::hash128("Dirty Little Helper, with a string long enough for the mid size path", 68, SEED);
+	static_assert(compile_time == 0x7793a0a4c97a9190ULL, "XXH3 in constant expression");
+	char runtime[80];
+	Memory::copy(runtime, "Dirty Little Helper, with a string long enough for the mid size path", 68);
+	cout << "constexpr: " << (XXHash3::hash(static_cast<const void*>(runtime), 19) == compile_time
+	                          && XXHash3::hash128(static_cast<const void*>(runtime), 68, SEED) == compile_time128) << endl;
+
+	// Strings and zeros
+	XXHash3 a;
+	a.add("Dirty Little Helper");
+	cout << "string: " << (a.hash() == compile_time) << endl;
+	a.reset(SEED);
+	a.add(input, 1000);
+	a.addZeros(3000);
+	a.add(input, 77);
+	XXHash3 b(SEED);
+	b.add(input, 1000);
+	b.add(nullptr, 1000);
+	b.addZeros(1);
+	b.add(nullptr, 1999);
+	b.add(input, 77);
+	unsigned char * c = Memory::alloc<unsigned char>(4077);
+	Memory::copy(c, input, 1000);
+	Memory::copy(c + 4000, input, 77);
+	cout << "zeros: " << (a.hash() == b.hash() && a.hash() == XXHash3::hash(c, 4077, SEED) && a.hash128() == b.hash128()) << endl;
+	cout << "empty add: " << a.add(input, 0) << endl;
+	Memory::free(c);
+	Memory::free(input);
+
+	// Repeat with generic (SSE2) kernels
+	if (argc == 1) {
+		if (auto fork = Syscall::fork()) {
+			if (fork.value() == 0) {
+				const char * args[3] = { argv[0], "generic", nullptr };
+				const char * env[2] = { "DLH_CPU_DISABLE=avx2", nullptr };
+				Syscall::execve(argv[0], args, env);
+				Syscall::exit(1);
+			}
+			Syscall::waitpid(fork.value());
+		}
+	}
+	return 0;
+}